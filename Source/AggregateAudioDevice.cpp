@@ -0,0 +1,442 @@
+//
+// AggregateAudioDevice.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "AggregateAudioDevice.h"
+
+namespace
+{
+    // Loop gains of the drift controller, per output callback and per sample of fill error
+    const double proportionalGain = 1.0e-6;
+    const double integralGain = 2.0e-9;
+
+    // Real clocks are within a few hundred ppm of each other, so anything beyond this is a fault
+    const double maxCorrection = 2.0e-3;
+
+    // Seconds of input the FIFO can hold
+    const double fifoSeconds = 0.5;
+
+    const char* const typeSeparator = ": ";
+}
+
+//==============================================================================
+void AdaptiveResampler::prepare(int numChannels, int)
+{
+    history.setSize(juce::jmax(1, numChannels), 4);
+    reset();
+}
+
+void AdaptiveResampler::reset() noexcept
+{
+    history.clear();
+    phase = 0.0;
+}
+
+int AdaptiveResampler::getInputSamplesNeeded(double ratio, int numOutputSamples) const noexcept
+{
+    if (numOutputSamples <= 0)
+        return 0;
+
+    return (int) std::floor(phase + (numOutputSamples - 1) * ratio);
+}
+
+void AdaptiveResampler::process(double ratio, const juce::AudioBuffer<float>& input, int numInput,
+                                float* const* output, int numChannels, int numOutputSamples) noexcept
+{
+    double endPhase = phase;
+
+    for (int ch = 0; ch < juce::jmax(1, numChannels); ++ch)
+    {
+        float* h = history.getWritePointer(juce::jmin(ch, history.getNumChannels() - 1));
+        const float* in = ch < numChannels ? input.getReadPointer(ch) : nullptr;
+        float* out = ch < numChannels ? output[ch] : nullptr;
+
+        float h0 = h[0], h1 = h[1], h2 = h[2], h3 = h[3];
+        double p = phase;
+        int inputIndex = 0;
+
+        for (int i = 0; i < numOutputSamples; ++i)
+        {
+            while (p >= 1.0)
+            {
+                h0 = h1; h1 = h2; h2 = h3;
+
+                // Rounding can ask for one sample too many - holding the last one is inaudible
+                if (in != nullptr && inputIndex < numInput)
+                    h3 = in[inputIndex];
+
+                ++inputIndex;
+                p -= 1.0;
+            }
+
+            if (out != nullptr)
+            {
+                // 4-point, 3rd-order Hermite interpolation between h1 and h2
+                const float x = (float) p;
+                const float c1 = 0.5f * (h2 - h0);
+                const float c2 = h0 - 2.5f * h1 + 2.0f * h2 - 0.5f * h3;
+                const float c3 = 0.5f * (h3 - h0) + 1.5f * (h1 - h2);
+                out[i] = ((c3 * x + c2) * x + c1) * x + h1;
+            }
+
+            p += ratio;
+        }
+
+        h[0] = h0; h[1] = h1; h[2] = h2; h[3] = h3;
+        endPhase = p;
+    }
+
+    phase = endPhase;
+}
+
+//==============================================================================
+void DriftEstimator::reset(double targetFill) noexcept
+{
+    target = targetFill;
+    smoothedFill = targetFill;
+    integral = 0.0;
+    correction = 0.0;
+}
+
+double DriftEstimator::update(double measuredFill) noexcept
+{
+    // The fill level jitters by a whole block between callbacks, so low-pass it first
+    smoothedFill += 0.05 * (measuredFill - smoothedFill);
+    const double error = smoothedFill - target;
+
+    integral = juce::jlimit(-maxCorrection, maxCorrection, integral + integralGain * error);
+    correction = juce::jlimit(-maxCorrection, maxCorrection, proportionalGain * error + integral);
+    return correction;
+}
+
+//==============================================================================
+class AggregateAudioIODevice::InputSide : public juce::AudioIODeviceCallback
+{
+public:
+    explicit InputSide(AggregateAudioIODevice& o) : owner(o) {}
+
+    void audioDeviceIOCallbackWithContext(const float* const* inputs, int numInputs,
+                                          float* const* outputs, int numOutputs, int numSamples,
+                                          const juce::AudioIODeviceCallbackContext&) override
+    {
+        owner.inputCallback(inputs, numInputs, numSamples);
+
+        for (int ch = 0; ch < numOutputs; ++ch)
+            if (outputs[ch] != nullptr)
+                juce::FloatVectorOperations::clear(outputs[ch], numSamples);
+    }
+
+    void audioDeviceAboutToStart(juce::AudioIODevice* device) override  { owner.inputAboutToStart(device); }
+    void audioDeviceStopped() override {}
+
+private:
+    AggregateAudioIODevice& owner;
+};
+
+class AggregateAudioIODevice::OutputSide : public juce::AudioIODeviceCallback
+{
+public:
+    explicit OutputSide(AggregateAudioIODevice& o) : owner(o) {}
+
+    void audioDeviceIOCallbackWithContext(const float* const*, int, float* const* outputs, int numOutputs,
+                                          int numSamples, const juce::AudioIODeviceCallbackContext& context) override
+    {
+        owner.outputCallback(outputs, numOutputs, numSamples, context);
+    }
+
+    void audioDeviceAboutToStart(juce::AudioIODevice* device) override  { owner.outputAboutToStart(device); }
+    void audioDeviceStopped() override                                  { owner.outputStopped(); }
+
+private:
+    AggregateAudioIODevice& owner;
+};
+
+//==============================================================================
+AggregateAudioIODevice::AggregateAudioIODevice(const juce::String& inputName, const juce::String& outputName,
+                                               std::unique_ptr<juce::AudioIODevice> input,
+                                               std::unique_ptr<juce::AudioIODevice> output)
+    : juce::AudioIODevice(outputName, AggregateAudioIODeviceType::typeName),
+      inputMemberName(inputName),
+      inputDevice(std::move(input)),
+      outputDevice(std::move(output)),
+      inputSide(std::make_unique<InputSide>(*this)),
+      outputSide(std::make_unique<OutputSide>(*this))
+{
+}
+
+AggregateAudioIODevice::~AggregateAudioIODevice()
+{
+    close();
+}
+
+juce::String AggregateAudioIODevice::open(const juce::BigInteger& inputChannels, const juce::BigInteger& outputChannels,
+                                          double sampleRate, int bufferSizeSamples)
+{
+    close();
+
+    // The output device is the clock master, so it gets exactly what was asked for
+    lastError = outputDevice->open({}, outputChannels, sampleRate, bufferSizeSamples);
+    if (lastError.isNotEmpty())
+        return lastError;
+
+    const double masterRate = outputDevice->getCurrentSampleRate();
+    const int masterBlockSize = outputDevice->getCurrentBufferSizeSamples();
+
+    // Run the input at the same nominal rate if it can, otherwise at the closest one it offers
+    double inputRate = masterRate;
+    const juce::Array<double> inputRates = inputDevice->getAvailableSampleRates();
+    if (! inputRates.isEmpty() && ! inputRates.contains(masterRate))
+    {
+        inputRate = inputRates.getFirst();
+        for (double rate : inputRates)
+            if (std::abs(rate - masterRate) < std::abs(inputRate - masterRate))
+                inputRate = rate;
+    }
+
+    lastError = inputDevice->open(inputChannels, {}, inputRate, bufferSizeSamples);
+    if (lastError.isNotEmpty())
+    {
+        outputDevice->close();
+        return lastError;
+    }
+
+    inputSampleRate.store(inputDevice->getCurrentSampleRate());
+    outputSampleRate = masterRate;
+
+    const int numInputs = juce::jmax(1, inputDevice->getActiveInputChannels().countNumberOfSetBits());
+    const double nominalRatio = inputSampleRate.load() / masterRate;
+    const int inputBlockSize = inputDevice->getCurrentBufferSizeSamples();
+
+    // Keep roughly one block of each side queued - enough to absorb scheduling jitter
+    targetFill = inputBlockSize + (int) std::ceil(masterBlockSize * nominalRatio);
+
+    // Everything the callbacks touch is sized here; devices that vary their block size
+    // are allowed up to twice the nominal size
+    const int maxOutputBlock = masterBlockSize * 2;
+    const int maxInputNeeded = (int) std::ceil(maxOutputBlock * nominalRatio * (1.0 + maxCorrection)) + 4;
+    fifo.allocate(numInputs, juce::jmax((int) (inputSampleRate.load() * fifoSeconds), targetFill * 4));
+    staging.setSize(numInputs, maxInputNeeded);
+    resampledInput.setSize(numInputs, maxOutputBlock);
+    resampler.prepare(numInputs, maxInputNeeded);
+    driftEstimator.reset(targetFill);
+
+    return {};
+}
+
+void AggregateAudioIODevice::close()
+{
+    stop();
+    inputDevice->close();
+    outputDevice->close();
+}
+
+void AggregateAudioIODevice::start(juce::AudioIODeviceCallback* callback)
+{
+    if (callback == nullptr || ! isOpen())
+        return;
+
+    stop();
+    callback->audioDeviceAboutToStart(this);
+
+    {
+        const juce::ScopedLock sl(callbackLock);
+        currentCallback = callback;
+    }
+
+    primed = false;
+    hasPrimed = false;
+    needsResync.store(true);
+    resyncs.store(0);
+    fifo.reset();
+
+    outputDevice->start(outputSide.get());
+    inputDevice->start(inputSide.get());
+}
+
+void AggregateAudioIODevice::stop()
+{
+    inputDevice->stop();
+    outputDevice->stop();
+
+    juce::AudioIODeviceCallback* oldCallback = nullptr;
+    {
+        const juce::ScopedLock sl(callbackLock);
+        std::swap(oldCallback, currentCallback);
+    }
+
+    if (oldCallback != nullptr)
+        oldCallback->audioDeviceStopped();
+}
+
+int AggregateAudioIODevice::getInputLatencyInSamples()
+{
+    // Input device latency plus the audio parked in the FIFO, expressed at the master rate
+    const double inRate = inputSampleRate.load();
+    const double scale = inRate > 0.0 ? outputSampleRate / inRate : 1.0;
+    return (int) ((inputDevice->getInputLatencyInSamples() + targetFill) * scale);
+}
+
+int AggregateAudioIODevice::getXRunCount() const noexcept
+{
+    const int inputXRuns = inputDevice->getXRunCount();
+    const int outputXRuns = outputDevice->getXRunCount();
+
+    if (inputXRuns < 0 && outputXRuns < 0)
+        return -1;
+
+    return juce::jmax(0, inputXRuns) + juce::jmax(0, outputXRuns);
+}
+
+void AggregateAudioIODevice::inputAboutToStart(juce::AudioIODevice* device)
+{
+    inputSampleRate.store(device->getCurrentSampleRate());
+}
+
+void AggregateAudioIODevice::outputAboutToStart(juce::AudioIODevice* device)
+{
+    outputSampleRate = device->getCurrentSampleRate();
+}
+
+void AggregateAudioIODevice::outputStopped()
+{
+}
+
+void AggregateAudioIODevice::inputCallback(const float* const* inputs, int numInputs, int numSamples) noexcept
+{
+    // Overflow means the input clock ran away from us - the output side will re-centre
+    if (! fifo.push(inputs, numInputs, numSamples))
+        needsResync.store(true);
+}
+
+void AggregateAudioIODevice::outputCallback(float* const* outputs, int numOutputs, int numSamples,
+                                            const juce::AudioIODeviceCallbackContext& context) noexcept
+{
+    const juce::ScopedTryLock stl(callbackLock);
+
+    if (! stl.isLocked() || currentCallback == nullptr || numSamples > resampledInput.getNumSamples())
+    {
+        for (int ch = 0; ch < numOutputs; ++ch)
+            if (outputs[ch] != nullptr)
+                juce::FloatVectorOperations::clear(outputs[ch], numSamples);
+        return;
+    }
+
+    const int numInputs = inputDevice->getActiveInputChannels().countNumberOfSetBits();
+    const double nominalRatio = inputSampleRate.load() / outputSampleRate;
+
+    if (needsResync.exchange(false))
+    {
+        if (hasPrimed)
+            resyncs++;
+
+        primed = false;
+    }
+
+    if (! primed && fifo.getNumReady() >= targetFill)
+    {
+        // Start from exactly the target fill so the controller begins centred
+        fifo.skip(fifo.getNumReady() - targetFill);
+        resampler.reset();
+        driftEstimator.reset(targetFill);
+        primed = true;
+        hasPrimed = true;
+    }
+
+    bool haveInput = false;
+
+    if (primed)
+    {
+        const double correction = driftEstimator.update((double) fifo.getNumReady());
+        const double ratio = nominalRatio * (1.0 + correction);
+        const int needed = resampler.getInputSamplesNeeded(ratio, numSamples);
+
+        if (needed <= staging.getNumSamples() && fifo.getNumReady() >= needed)
+        {
+            fifo.pop(staging, needed);
+            resampler.process(ratio, staging, needed, resampledInput.getArrayOfWritePointers(), numInputs, numSamples);
+            driftPpm.store(correction * 1.0e6);
+            haveInput = true;
+        }
+        else
+        {
+            // Ran dry - play silence on the input side until the FIFO refills
+            needsResync.store(true);
+        }
+    }
+
+    if (! haveInput)
+        resampledInput.clear(0, numSamples);
+
+    currentCallback->audioDeviceIOCallbackWithContext(resampledInput.getArrayOfReadPointers(), numInputs,
+                                                      outputs, numOutputs, numSamples, context);
+}
+
+//==============================================================================
+AggregateAudioIODeviceType::AggregateAudioIODeviceType(juce::AudioDeviceManager& manager)
+    : juce::AudioIODeviceType(typeName),
+      deviceManager(manager)
+{
+}
+
+void AggregateAudioIODeviceType::scanForDevices()
+{
+    inputNames.clear();
+    outputNames.clear();
+
+    for (auto* type : deviceManager.getAvailableDeviceTypes())
+    {
+        if (type == this || type->getTypeName() == typeName)
+            continue;
+
+        for (const auto& name : type->getDeviceNames(true))
+            inputNames.add(type->getTypeName() + typeSeparator + name);
+
+        for (const auto& name : type->getDeviceNames(false))
+            outputNames.add(type->getTypeName() + typeSeparator + name);
+    }
+}
+
+juce::StringArray AggregateAudioIODeviceType::getDeviceNames(bool wantInputNames) const
+{
+    return wantInputNames ? inputNames : outputNames;
+}
+
+int AggregateAudioIODeviceType::getIndexOfDevice(juce::AudioIODevice* device, bool asInput) const
+{
+    if (auto* aggregate = dynamic_cast<AggregateAudioIODevice*>(device))
+        return asInput ? inputNames.indexOf(aggregate->getInputMemberName())
+                       : outputNames.indexOf(aggregate->getOutputMemberName());
+
+    return -1;
+}
+
+std::unique_ptr<juce::AudioIODevice> AggregateAudioIODeviceType::createMemberDevice(const juce::String& qualifiedName,
+                                                                                   bool asInput)
+{
+    const juce::String memberTypeName = qualifiedName.upToFirstOccurrenceOf(typeSeparator, false, false);
+    const juce::String memberDeviceName = qualifiedName.fromFirstOccurrenceOf(typeSeparator, false, false);
+
+    for (auto* type : deviceManager.getAvailableDeviceTypes())
+    {
+        if (type != this && type->getTypeName() == memberTypeName)
+            return std::unique_ptr<juce::AudioIODevice>(asInput ? type->createDevice({}, memberDeviceName)
+                                                                : type->createDevice(memberDeviceName, {}));
+    }
+
+    return nullptr;
+}
+
+juce::AudioIODevice* AggregateAudioIODeviceType::createDevice(const juce::String& outputDeviceName,
+                                                              const juce::String& inputDeviceName)
+{
+    auto input = createMemberDevice(inputDeviceName, true);
+    auto output = createMemberDevice(outputDeviceName, false);
+
+    if (input == nullptr || output == nullptr)
+        return nullptr;
+
+    return new AggregateAudioIODevice(inputDeviceName, outputDeviceName, std::move(input), std::move(output));
+}
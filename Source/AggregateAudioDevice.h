@@ -0,0 +1,169 @@
+//
+// AggregateAudioDevice.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AudioRingBuffer.h"
+#include <atomic>
+#include <memory>
+
+/**
+ * Variable-ratio cubic resampler for bridging two free-running clocks
+ * Pulls exactly as many input samples as the current ratio requires for each output block
+ */
+class AdaptiveResampler
+{
+public:
+    void prepare(int numChannels, int maxInputSamples);
+    void reset() noexcept;
+
+    /** Number of input samples the next call to process() will consume for numOutputSamples */
+    int getInputSamplesNeeded(double ratio, int numOutputSamples) const noexcept;
+
+    /**
+     * Resamples `numInput` samples from `input` into `numOutputSamples` samples of `output`
+     * ratio is input samples per output sample
+     */
+    void process(double ratio, const juce::AudioBuffer<float>& input, int numInput,
+                 float* const* output, int numChannels, int numOutputSamples) noexcept;
+
+private:
+    juce::AudioBuffer<float> history; // last four input samples per channel
+    double phase = 0.0;
+};
+
+/**
+ * Estimates the drift between the two clocks from the FIFO fill level and turns it into a
+ * resampling correction, using a proportional-integral loop on a smoothed fill measurement
+ */
+class DriftEstimator
+{
+public:
+    void reset(double targetFill) noexcept;
+
+    /** Feeds one fill measurement and returns the ratio correction (e.g. 1.0e-4 = +100 ppm) */
+    double update(double measuredFill) noexcept;
+
+    double getCorrection() const noexcept     { return correction; }
+
+private:
+    double target = 0.0, smoothedFill = 0.0, integral = 0.0, correction = 0.0;
+};
+
+/**
+ * Combines an input device and an output device that run on independent clocks
+ * The output device is the clock master; the input device's audio is carried across through
+ * a lock-free FIFO and an adaptive resampler driven by the drift estimator
+ */
+class AggregateAudioIODevice : public juce::AudioIODevice
+{
+public:
+    AggregateAudioIODevice(const juce::String& inputMemberName, const juce::String& outputMemberName,
+                           std::unique_ptr<juce::AudioIODevice> inputDevice,
+                           std::unique_ptr<juce::AudioIODevice> outputDevice);
+    ~AggregateAudioIODevice() override;
+
+    juce::StringArray getOutputChannelNames() override     { return outputDevice->getOutputChannelNames(); }
+    juce::StringArray getInputChannelNames() override      { return inputDevice->getInputChannelNames(); }
+    juce::Array<double> getAvailableSampleRates() override { return outputDevice->getAvailableSampleRates(); }
+    juce::Array<int> getAvailableBufferSizes() override    { return outputDevice->getAvailableBufferSizes(); }
+    int getDefaultBufferSize() override                    { return outputDevice->getDefaultBufferSize(); }
+
+    juce::String open(const juce::BigInteger& inputChannels, const juce::BigInteger& outputChannels,
+                      double sampleRate, int bufferSizeSamples) override;
+    void close() override;
+    bool isOpen() override                                 { return outputDevice->isOpen() && inputDevice->isOpen(); }
+
+    void start(juce::AudioIODeviceCallback* callback) override;
+    void stop() override;
+    bool isPlaying() override                              { return currentCallback != nullptr; }
+
+    juce::String getLastError() override                   { return lastError; }
+    int getCurrentBufferSizeSamples() override             { return outputDevice->getCurrentBufferSizeSamples(); }
+    double getCurrentSampleRate() override                 { return outputDevice->getCurrentSampleRate(); }
+    int getCurrentBitDepth() override                      { return outputDevice->getCurrentBitDepth(); }
+    juce::BigInteger getActiveOutputChannels() const override { return outputDevice->getActiveOutputChannels(); }
+    juce::BigInteger getActiveInputChannels() const override  { return inputDevice->getActiveInputChannels(); }
+    int getOutputLatencyInSamples() override               { return outputDevice->getOutputLatencyInSamples(); }
+    int getInputLatencyInSamples() override;
+    int getXRunCount() const noexcept override;
+
+    /** The qualified "Type: Device" names this aggregate was created from */
+    const juce::String& getInputMemberName() const noexcept  { return inputMemberName; }
+    const juce::String& getOutputMemberName() const noexcept { return getName(); }
+
+    /** Current clock drift correction applied to the input side, in parts per million */
+    double getDriftPpm() const noexcept                    { return driftPpm.load(); }
+
+    /** Number of times the FIFO ran dry or overflowed and had to be re-centred */
+    int getNumResyncs() const noexcept                     { return resyncs.load(); }
+
+private:
+    class InputSide;
+    class OutputSide;
+
+    void inputAboutToStart(juce::AudioIODevice* device);
+    void inputCallback(const float* const* inputs, int numInputs, int numSamples) noexcept;
+    void outputAboutToStart(juce::AudioIODevice* device);
+    void outputCallback(float* const* outputs, int numOutputs, int numSamples,
+                        const juce::AudioIODeviceCallbackContext& context) noexcept;
+    void outputStopped();
+
+    const juce::String inputMemberName;
+    std::unique_ptr<juce::AudioIODevice> inputDevice, outputDevice;
+    std::unique_ptr<InputSide> inputSide;
+    std::unique_ptr<OutputSide> outputSide;
+
+    AudioRingBuffer fifo;
+    AdaptiveResampler resampler;
+    DriftEstimator driftEstimator;
+    juce::AudioBuffer<float> staging, resampledInput;
+
+    std::atomic<double> inputSampleRate { 0.0 };
+    double outputSampleRate = 0.0;
+    int targetFill = 0;
+    bool primed = false;
+    bool hasPrimed = false;
+
+    std::atomic<double> driftPpm { 0.0 };
+    std::atomic<int> resyncs { 0 };
+    std::atomic<bool> needsResync { true };
+
+    juce::String lastError;
+    juce::CriticalSection callbackLock;
+    juce::AudioIODeviceCallback* currentCallback = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AggregateAudioIODevice)
+};
+
+/**
+ * Offers every input and output device of the other registered types as an aggregate pair
+ */
+class AggregateAudioIODeviceType : public juce::AudioIODeviceType
+{
+public:
+    static constexpr const char* typeName = "Nova Host Aggregate";
+
+    explicit AggregateAudioIODeviceType(juce::AudioDeviceManager& manager);
+
+    void scanForDevices() override;
+    juce::StringArray getDeviceNames(bool wantInputNames = false) const override;
+    int getDefaultDeviceIndex(bool forInput) const override  { return 0; }
+    int getIndexOfDevice(juce::AudioIODevice* device, bool asInput) const override;
+    bool hasSeparateInputsAndOutputs() const override       { return true; }
+    juce::AudioIODevice* createDevice(const juce::String& outputDeviceName,
+                                      const juce::String& inputDeviceName) override;
+
+private:
+    std::unique_ptr<juce::AudioIODevice> createMemberDevice(const juce::String& qualifiedName, bool asInput);
+
+    juce::AudioDeviceManager& deviceManager;
+    juce::StringArray inputNames, outputNames;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AggregateAudioIODeviceType)
+};
@@ -0,0 +1,175 @@
+//
+// AnalyzerWindow.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "AnalyzerWindow.h"
+#include <cmath>
+
+namespace
+{
+    const float lowestFrequency = 20.0f;
+    const float highestFrequency = 20000.0f;
+    const float lowestDecibels = -100.0f;
+    const float highestDecibels = 0.0f;
+
+    juce::String formatLufs(double lufs)
+    {
+        return lufs <= -99.0 ? juce::String("-inf") : juce::String(lufs, 1);
+    }
+}
+
+class AnalyzerWindow::Content : public juce::Component,
+                                private juce::Timer
+{
+public:
+    Content(ChainAnalyzer& analyzerToShow, const juce::StringArray& sourceNames, int selectedSource,
+            std::function<void(int)> onSourceChosen)
+        : analyzer(analyzerToShow),
+          sourceChosen(std::move(onSourceChosen))
+    {
+        sourceBox.addItemList(sourceNames, 1);
+        sourceBox.setSelectedItemIndex(juce::jmax(0, selectedSource), juce::dontSendNotification);
+        sourceBox.onChange = [this]
+        {
+            analyzer.resetLoudness();
+            if (sourceChosen != nullptr)
+                sourceChosen(sourceBox.getSelectedItemIndex());
+        };
+        addAndMakeVisible(sourceBox);
+
+        resetButton.setButtonText("Reset Loudness");
+        resetButton.onClick = [this] { analyzer.resetLoudness(); };
+        addAndMakeVisible(resetButton);
+
+        setSize(720, 360);
+        startTimerHz(30);
+    }
+
+    void resized() override
+    {
+        auto area = getLocalBounds().reduced(8);
+        auto controls = area.removeFromTop(24);
+
+        sourceBox.setBounds(controls.removeFromLeft(260));
+        resetButton.setBounds(controls.removeFromRight(120));
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        g.fillAll(juce::Colour(0xff16181c));
+
+        auto area = getLocalBounds().reduced(8);
+        area.removeFromTop(32);
+        auto readout = area.removeFromBottom(24);
+        const auto plot = area.toFloat();
+
+        // Octave lines from 31.5 Hz up
+        g.setColour(juce::Colours::white.withAlpha(0.1f));
+        for (float frequency = 31.25f; frequency < highestFrequency; frequency *= 2.0f)
+        {
+            const float x = frequencyToX(frequency, plot);
+            g.drawVerticalLine(juce::roundToInt(x), plot.getY(), plot.getBottom());
+        }
+        for (float decibels = highestDecibels - 20.0f; decibels > lowestDecibels; decibels -= 20.0f)
+            g.drawHorizontalLine(juce::roundToInt(decibelsToY(decibels, plot)), plot.getX(), plot.getRight());
+
+        if (results.spectrumDecibels.size() > 1)
+        {
+            juce::Path spectrumPath;
+            const float binWidth = (float) results.sampleRate / (float) ChainAnalyzer::fftSize;
+            bool started = false;
+
+            for (size_t bin = 1; bin < results.spectrumDecibels.size(); bin++)
+            {
+                const float frequency = (float) bin * binWidth;
+                if (frequency < lowestFrequency || frequency > highestFrequency)
+                    continue;
+
+                const juce::Point<float> point(frequencyToX(frequency, plot), decibelsToY(results.spectrumDecibels[bin], plot));
+                if (started)
+                    spectrumPath.lineTo(point);
+                else
+                    spectrumPath.startNewSubPath(point);
+                started = true;
+            }
+
+            g.setColour(juce::Colour(0xff4fc3f7));
+            g.strokePath(spectrumPath, juce::PathStrokeType(1.5f));
+        }
+
+        g.setColour(juce::Colours::white);
+        g.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 13.0f, juce::Font::plain));
+
+        juce::String text = "M " + formatLufs(results.momentaryLufs)
+                          + "   S " + formatLufs(results.shortTermLufs)
+                          + "   I " + formatLufs(results.integratedLufs) + " LUFS"
+                          + "   Correlation " + juce::String(results.correlation, 2);
+        if (results.numDroppedBlocks > 0)
+            text << "   (" << results.numDroppedBlocks << " blocks dropped)";
+
+        g.drawText(text, readout, juce::Justification::centredLeft);
+    }
+
+private:
+    void timerCallback() override
+    {
+        results = analyzer.getResults();
+        repaint();
+    }
+
+    static float frequencyToX(float frequency, juce::Rectangle<float> plot)
+    {
+        const float position = std::log(frequency / lowestFrequency) / std::log(highestFrequency / lowestFrequency);
+        return plot.getX() + position * plot.getWidth();
+    }
+
+    static float decibelsToY(float decibels, juce::Rectangle<float> plot)
+    {
+        return juce::jmap(juce::jlimit(lowestDecibels, highestDecibels, decibels),
+                          lowestDecibels, highestDecibels, plot.getBottom(), plot.getY());
+    }
+
+    ChainAnalyzer& analyzer;
+    std::function<void(int)> sourceChosen;
+    ChainAnalyzer::Results results;
+
+    juce::ComboBox sourceBox;
+    juce::TextButton resetButton;
+};
+
+AnalyzerWindow::AnalyzerWindow(ChainAnalyzer& analyzerToShow, const juce::StringArray& sourceNames, int selectedSource,
+                               std::function<void(int)> onSourceChosen, std::function<void()> onCloseRequested)
+    : juce::DocumentWindow("Analyzer", juce::Colours::black,
+                           juce::DocumentWindow::minimiseButton | juce::DocumentWindow::closeButton),
+      analyzer(analyzerToShow),
+      onClose(std::move(onCloseRequested))
+{
+    setContentOwned(new Content(analyzer, sourceNames, selectedSource, std::move(onSourceChosen)), true);
+    setUsingNativeTitleBar(true);
+    setResizable(true, false);
+    centreWithSize(getWidth(), getHeight());
+    setVisible(true);
+
+    analyzer.setActive(true);
+}
+
+AnalyzerWindow::~AnalyzerWindow()
+{
+    // Nobody is looking any more, so the audio side can stop copying
+    analyzer.setActive(false);
+    clearContentComponent();
+}
+
+void AnalyzerWindow::closeButtonPressed()
+{
+    if (onClose != nullptr)
+        onClose();
+}
+
+void AnalyzerWindow::minimisationStateChanged(bool isNowMinimised)
+{
+    analyzer.setActive(! isNowMinimised);
+}
@@ -0,0 +1,40 @@
+//
+// AnalyzerWindow.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "ChainAnalyzer.h"
+#include <functional>
+
+/**
+ * Shows the ChainAnalyzer: a log-frequency spectrum, momentary, short-term and integrated
+ * loudness and the stereo correlation, for the chain output or for one plugin
+ * The analyzer only runs while the window is open and not minimised
+ */
+class AnalyzerWindow : public juce::DocumentWindow
+{
+public:
+    /**
+     * sourceNames starts with the chain output, followed by the plugins
+     * onSourceChosen gets the index into sourceNames; onCloseRequested is where the owner deletes the window
+     */
+    AnalyzerWindow(ChainAnalyzer& analyzer, const juce::StringArray& sourceNames, int selectedSource,
+                   std::function<void(int)> onSourceChosen, std::function<void()> onCloseRequested);
+    ~AnalyzerWindow() override;
+
+    void closeButtonPressed() override;
+    void minimisationStateChanged(bool isNowMinimised) override;
+
+private:
+    class Content;
+
+    ChainAnalyzer& analyzer;
+    std::function<void()> onClose;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalyzerWindow)
+};
@@ -0,0 +1,121 @@
+//
+// AudioRingBuffer.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/**
+ * Single-producer/single-consumer multichannel sample FIFO
+ * All storage is allocated up front, so push() and pop() never allocate or lock
+ * and push() can be called from the audio thread
+ */
+class AudioRingBuffer
+{
+public:
+    AudioRingBuffer() = default;
+
+    /** Allocates storage for the given layout - call from a non-realtime thread only */
+    void allocate(int numChannelsToUse, int capacityInSamples)
+    {
+        storage.setSize(juce::jmax(1, numChannelsToUse), juce::jmax(1, capacityInSamples) + 1, false, true, false);
+        fifo.setTotalSize(storage.getNumSamples());
+        fifo.reset();
+    }
+
+    /** Releases the storage - the buffer must not be in use by either side */
+    void release()
+    {
+        storage.setSize(1, 1);
+        fifo.setTotalSize(1);
+        fifo.reset();
+    }
+
+    /** Discards everything that is queued - only safe while neither side is active */
+    void reset() noexcept                    { fifo.reset(); }
+
+    int getNumChannels() const noexcept      { return storage.getNumChannels(); }
+    int getCapacity() const noexcept         { return fifo.getTotalSize() - 1; }
+    int getNumReady() const noexcept         { return fifo.getNumReady(); }
+    int getFreeSpace() const noexcept        { return fifo.getFreeSpace(); }
+
+    /**
+     * Copies a block into the FIFO (producer side)
+     * Missing source channels are written as silence and extra ones are ignored
+     * Returns false without writing anything if the whole block does not fit
+     */
+    bool push(const float* const* source, int numSourceChannels, int numSamples) noexcept
+    {
+        if (numSamples <= 0)
+            return true;
+
+        if (fifo.getFreeSpace() < numSamples)
+            return false;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+        for (int ch = 0; ch < storage.getNumChannels(); ++ch)
+        {
+            const float* src = (ch < numSourceChannels) ? source[ch] : nullptr;
+
+            if (src != nullptr)
+            {
+                if (size1 > 0) storage.copyFrom(ch, start1, src, size1);
+                if (size2 > 0) storage.copyFrom(ch, start2, src + size1, size2);
+            }
+            else
+            {
+                if (size1 > 0) storage.clear(ch, start1, size1);
+                if (size2 > 0) storage.clear(ch, start2, size2);
+            }
+        }
+
+        fifo.finishedWrite(size1 + size2);
+        return true;
+    }
+
+    /**
+     * Moves up to maxSamples into dest starting at sample 0 (consumer side)
+     * dest must already be large enough - returns the number of samples read
+     */
+    int pop(juce::AudioBuffer<float>& dest, int maxSamples) noexcept
+    {
+        const int numToRead = juce::jmin(maxSamples, dest.getNumSamples(), fifo.getNumReady());
+
+        if (numToRead <= 0)
+            return 0;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(numToRead, start1, size1, start2, size2);
+
+        const int numChannelsToCopy = juce::jmin(dest.getNumChannels(), storage.getNumChannels());
+
+        for (int ch = 0; ch < numChannelsToCopy; ++ch)
+        {
+            if (size1 > 0) dest.copyFrom(ch, 0, storage, ch, start1, size1);
+            if (size2 > 0) dest.copyFrom(ch, size1, storage, ch, start2, size2);
+        }
+
+        fifo.finishedRead(size1 + size2);
+        return size1 + size2;
+    }
+
+    /** Drops up to numSamples of the oldest queued audio (consumer side) */
+    int skip(int numSamples) noexcept
+    {
+        const int numToSkip = juce::jmin(numSamples, fifo.getNumReady());
+        fifo.finishedRead(numToSkip);
+        return numToSkip;
+    }
+
+private:
+    juce::AbstractFifo fifo { 1 };
+    juce::AudioBuffer<float> storage { 1, 1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioRingBuffer)
+};
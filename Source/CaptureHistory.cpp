@@ -0,0 +1,395 @@
+//
+// CaptureHistory.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "CaptureHistory.h"
+#include <cmath>
+
+namespace
+{
+    // Seconds the transfer rings can buffer while the packing thread is busy
+    const int ringBufferSeconds = 2;
+
+    // FLAC streams cannot carry more than this many channels
+    const int maxFlacChannels = 8;
+
+    bool writeChannels(juce::AudioFormatWriter* writer, const juce::AudioBuffer<float>& audio,
+                       int firstChannel, int numChannels, int numSamples)
+    {
+        if (writer == nullptr || numChannels <= 0)
+            return true;
+
+        return writer->writeFromFloatArrays(audio.getArrayOfReadPointers() + firstChannel, numChannels, numSamples);
+    }
+
+    std::unique_ptr<juce::AudioFormatWriter> createWavWriter(const juce::File& file, double sampleRate, int numChannels)
+    {
+        if (numChannels <= 0)
+            return nullptr;
+
+        auto stream = std::make_unique<juce::FileOutputStream>(file, 1 << 20);
+        if (stream->failedToOpen())
+            return nullptr;
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(juce::WavAudioFormat().createWriterFor(stream.get(), sampleRate,
+                                                                                              (unsigned int) numChannels,
+                                                                                              32, {}, 0));
+        if (writer != nullptr)
+            stream.release();
+
+        return writer;
+    }
+}
+
+CaptureHistory::CaptureHistory()
+    : juce::Thread("Nova Host Capture History")
+{
+}
+
+CaptureHistory::~CaptureHistory()
+{
+    acceptingAudio.store(false);
+    signalThreadShouldExit();
+    notify();
+    waitForThreadToExit(-1);
+}
+
+void CaptureHistory::setConfiguration(int newMinutesToKeep, bool compressChunks)
+{
+    minutesToKeep.store(juce::jmax(0, newMinutesToKeep));
+    compress.store(compressChunks);
+    notify();
+}
+
+double CaptureHistory::getSecondsAvailable() const
+{
+    std::lock_guard<ProfiledMutex> lock(chunkMutex);
+
+    if (sampleRate <= 0.0)
+        return 0.0;
+
+    juce::int64 totalSamples = 0;
+    for (const auto& chunk : chunks)
+        totalSamples += chunk->numSamples;
+
+    return (double) totalSamples / sampleRate;
+}
+
+size_t CaptureHistory::getMemoryUsage() const
+{
+    std::lock_guard<ProfiledMutex> lock(chunkMutex);
+    return memoryUsage;
+}
+
+void CaptureHistory::tapAboutToStart(double newSampleRate, int numInputChannels, int numOutputChannels)
+{
+    // The device is stopped here, but the packing thread may still be reading the rings
+    acceptingAudio.store(false);
+    signalThreadShouldExit();
+    notify();
+    waitForThreadToExit(-1);
+
+    if (newSampleRate != sampleRate || numInputChannels != numInputs || numOutputChannels != numOutputs)
+    {
+        // Old chunks can't be stitched to audio with a different layout
+        std::lock_guard<ProfiledMutex> lock(chunkMutex);
+        chunks.clear();
+        memoryUsage = 0;
+        sampleRate = newSampleRate;
+        numInputs = numInputChannels;
+        numOutputs = numOutputChannels;
+    }
+
+    const int ringSize = (int) (newSampleRate * ringBufferSeconds);
+    inputRing.allocate(juce::jmax(1, numInputs), ringSize);
+    outputRing.allocate(juce::jmax(1, numOutputs), ringSize);
+
+    {
+        // One chunk holds a second of audio, inputs followed by outputs
+        std::lock_guard<ProfiledMutex> lock(pendingMutex);
+        pending.setSize(juce::jmax(1, numInputs + numOutputs), juce::jmax(1, (int) newSampleRate));
+        pendingSamples = 0;
+    }
+
+    startThread(juce::Thread::Priority::low);
+    acceptingAudio.store(true);
+}
+
+void CaptureHistory::tapInput(const float* const* data, int numChannels, int numSamples) noexcept
+{
+    inputPushed = false;
+
+    if (! acceptingAudio.load(std::memory_order_relaxed) || minutesToKeep.load(std::memory_order_relaxed) == 0)
+        return;
+
+    // Only accept the block if both halves fit, so input and output never drift apart
+    if (inputRing.getFreeSpace() < numSamples || outputRing.getFreeSpace() < numSamples)
+    {
+        droppedBlocks.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    inputPushed = inputRing.push(data, numChannels, numSamples);
+}
+
+void CaptureHistory::tapOutput(const float* const* data, int numChannels, int numSamples) noexcept
+{
+    if (inputPushed)
+        outputRing.push(data, numChannels, numSamples);
+
+    inputPushed = false;
+}
+
+void CaptureHistory::run()
+{
+    int lastReportedDrops = droppedBlocks.load();
+
+    while (! threadShouldExit())
+    {
+        if (minutesToKeep.load() == 0)
+        {
+            // History switched off - free everything and just keep the rings empty
+            {
+                std::lock_guard<ProfiledMutex> lock(chunkMutex);
+                chunks.clear();
+                memoryUsage = 0;
+            }
+            {
+                std::lock_guard<ProfiledMutex> lock(pendingMutex);
+                pendingSamples = 0;
+            }
+            memoryCapReported = false;
+            inputRing.skip(inputRing.getNumReady());
+            outputRing.skip(outputRing.getNumReady());
+            wait(200);
+            continue;
+        }
+
+        const int numReady = juce::jmin(inputRing.getNumReady(), outputRing.getNumReady());
+        if (numReady == 0)
+        {
+            wait(50);
+            continue;
+        }
+
+        {
+            std::lock_guard<ProfiledMutex> lock(pendingMutex);
+            const int numToMove = juce::jmin(numReady, pending.getNumSamples() - pendingSamples);
+
+            // Read straight into the pending chunk: inputs occupy the first channels, outputs the rest
+            juce::AudioBuffer<float> inputView(pending.getArrayOfWritePointers(), numInputs, pendingSamples, numToMove);
+            juce::AudioBuffer<float> outputView(pending.getArrayOfWritePointers() + numInputs, numOutputs, pendingSamples, numToMove);
+            inputRing.pop(inputView, numToMove);
+            outputRing.pop(outputView, numToMove);
+            pendingSamples += numToMove;
+
+            if (pendingSamples == pending.getNumSamples())
+                finishChunk();
+        }
+
+        const int currentDrops = droppedBlocks.load();
+        if (currentDrops != lastReportedDrops)
+        {
+            juce::Logger::writeToLog("Capture history dropped " + juce::String(currentDrops - lastReportedDrops)
+                                     + " block(s); the history will contain a gap");
+            lastReportedDrops = currentDrops;
+        }
+    }
+}
+
+void CaptureHistory::finishChunk()
+{
+    // Called with pendingMutex held, so a dump sees the audio either here or in the history
+    auto chunk = packChunk(pending, pendingSamples);
+    pendingSamples = 0;
+
+    std::lock_guard<ProfiledMutex> lock(chunkMutex);
+    memoryUsage += chunk->data.getSize();
+    chunks.push_back(std::move(chunk));
+    trimHistory();
+}
+
+void CaptureHistory::trimHistory()
+{
+    const juce::int64 samplesToKeep = (juce::int64) minutesToKeep.load() * 60 * (juce::int64) sampleRate;
+
+    juce::int64 totalSamples = 0;
+    for (const auto& chunk : chunks)
+        totalSamples += chunk->numSamples;
+
+    while (! chunks.empty() && totalSamples - chunks.front()->numSamples >= samplesToKeep)
+    {
+        totalSamples -= chunks.front()->numSamples;
+        memoryUsage -= chunks.front()->data.getSize();
+        chunks.pop_front();
+    }
+
+    if (memoryUsage > maxMemoryBytes && ! memoryCapReported)
+    {
+        juce::Logger::writeToLog("Capture history reached " + juce::File::descriptionOfSizeInBytes((juce::int64) maxMemoryBytes)
+                                 + "; keeping " + juce::String(juce::roundToInt(totalSamples / sampleRate)) + " seconds instead of "
+                                 + juce::String(minutesToKeep.load()) + " minutes");
+        memoryCapReported = true;
+    }
+
+    while (chunks.size() > 1 && memoryUsage > maxMemoryBytes)
+    {
+        memoryUsage -= chunks.front()->data.getSize();
+        chunks.pop_front();
+    }
+}
+
+std::shared_ptr<const CaptureHistory::Chunk> CaptureHistory::packChunk(const juce::AudioBuffer<float>& audio, int numSamples) const
+{
+    auto chunk = std::make_shared<Chunk>();
+    chunk->numChannels = numInputs + numOutputs;
+    chunk->numSamples = numSamples;
+
+    #if JUCE_USE_FLAC
+    const float peak = audio.getMagnitude(0, numSamples);
+
+    // Inf or NaN would not survive integer samples at any gain, so such chunks stay as floats
+    if (compress.load() && chunk->numChannels > 0 && chunk->numChannels <= maxFlacChannels && std::isfinite(peak))
+    {
+        // Integer samples clip at full scale, so hotter chunks are brought under it exactly
+        const juce::AudioBuffer<float>* source = &audio;
+        juce::AudioBuffer<float> scaled;
+        if (peak > 1.0f)
+        {
+            chunk->gain = (float) juce::nextPowerOfTwo((int) std::ceil(juce::jmin(peak, 1.0e6f)));
+            scaled.makeCopyOf(audio);
+            scaled.applyGain(0, numSamples, 1.0f / chunk->gain);
+            source = &scaled;
+        }
+
+        auto stream = std::make_unique<juce::MemoryOutputStream>(chunk->data, false);
+        std::unique_ptr<juce::AudioFormatWriter> writer(juce::FlacAudioFormat().createWriterFor(stream.get(), sampleRate,
+                                                                                               (unsigned int) chunk->numChannels,
+                                                                                               24, {}, 0));
+        if (writer != nullptr)
+        {
+            stream.release();
+            writer->writeFromFloatArrays(source->getArrayOfReadPointers(), chunk->numChannels, numSamples);
+
+            // Destroying the writer flushes the encoded frames into the chunk
+            writer.reset();
+            chunk->compressed = true;
+            return chunk;
+        }
+    }
+    #endif
+
+    return copyChunk(audio, chunk->numChannels, numSamples);
+}
+
+std::shared_ptr<const CaptureHistory::Chunk> CaptureHistory::copyChunk(const juce::AudioBuffer<float>& audio, int numChannels, int numSamples)
+{
+    auto chunk = std::make_shared<Chunk>();
+    chunk->numChannels = numChannels;
+    chunk->numSamples = numSamples;
+
+    const size_t bytesPerChannel = (size_t) numSamples * sizeof(float);
+    chunk->data.setSize(bytesPerChannel * (size_t) numChannels);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        chunk->data.copyFrom(audio.getReadPointer(ch), (size_t) ch * bytesPerChannel, bytesPerChannel);
+
+    return chunk;
+}
+
+bool CaptureHistory::unpackChunk(const Chunk& chunk, juce::AudioBuffer<float>& dest)
+{
+    dest.setSize(chunk.numChannels, chunk.numSamples, false, false, true);
+
+    if (! chunk.compressed)
+    {
+        const size_t bytesPerChannel = (size_t) chunk.numSamples * sizeof(float);
+
+        for (int ch = 0; ch < chunk.numChannels; ++ch)
+            chunk.data.copyTo(dest.getWritePointer(ch), (int) ((size_t) ch * bytesPerChannel), bytesPerChannel);
+
+        return true;
+    }
+
+    #if JUCE_USE_FLAC
+    std::unique_ptr<juce::AudioFormatReader> reader(juce::FlacAudioFormat().createReaderFor(
+        new juce::MemoryInputStream(chunk.data, false), true));
+
+    if (reader != nullptr && reader->read(&dest, 0, chunk.numSamples, 0, true, true))
+    {
+        if (chunk.gain != 1.0f)
+            dest.applyGain(chunk.gain);
+        return true;
+    }
+    #endif
+
+    return false;
+}
+
+void CaptureHistory::dumpToDirectory(const juce::File& directory, DumpCallback onFinished)
+{
+    ChunkList snapshot;
+    double snapshotRate;
+    int snapshotInputs, snapshotOutputs;
+
+    {
+        // Same order as the packing thread, which finishes a chunk with both held
+        std::lock_guard<ProfiledMutex> pendingLock(pendingMutex);
+        std::lock_guard<ProfiledMutex> lock(chunkMutex);
+        snapshot = chunks;
+        snapshotRate = sampleRate;
+        snapshotInputs = numInputs;
+        snapshotOutputs = numOutputs;
+
+        // The last second is the part the user just heard, so the unfinished chunk goes in too
+        if (pendingSamples > 0 && minutesToKeep.load() > 0)
+            snapshot.push_back(copyChunk(pending, numInputs + numOutputs, pendingSamples));
+    }
+
+    if (snapshot.empty())
+    {
+        onFinished(false, "The capture history is empty.");
+        return;
+    }
+
+    // The chunks are immutable and shared, so encoding can run without touching the live history
+    juce::int64 snapshotSamples = 0;
+    for (const auto& chunk : snapshot)
+        snapshotSamples += chunk->numSamples;
+
+    juce::Thread::launch([snapshot, snapshotRate, snapshotInputs, snapshotOutputs, snapshotSamples, directory, onFinished]
+    {
+        const juce::String baseName = "NovaHost history " + juce::Time::getCurrentTime().formatted("%Y-%m-%d %H-%M-%S");
+        const juce::File inputFile = directory.getNonexistentChildFile(baseName + " input", ".wav", false);
+        const juce::File outputFile = directory.getNonexistentChildFile(baseName + " output", ".wav", false);
+
+        bool ok = directory.createDirectory().wasOk();
+        auto inputWriter = ok ? createWavWriter(inputFile, snapshotRate, snapshotInputs) : nullptr;
+        auto outputWriter = ok ? createWavWriter(outputFile, snapshotRate, snapshotOutputs) : nullptr;
+        ok = ok && (inputWriter != nullptr || snapshotInputs == 0) && outputWriter != nullptr;
+
+        juce::AudioBuffer<float> audio;
+        for (const auto& chunk : snapshot)
+        {
+            if (! ok)
+                break;
+
+            ok = unpackChunk(*chunk, audio)
+                 && writeChannels(inputWriter.get(), audio, 0, snapshotInputs, chunk->numSamples)
+                 && writeChannels(outputWriter.get(), audio, snapshotInputs, snapshotOutputs, chunk->numSamples);
+        }
+
+        inputWriter.reset();
+        outputWriter.reset();
+
+        const juce::String message = ok ? "Saved " + juce::String(snapshotSamples / snapshotRate, 1) + " seconds to:\n"
+                                          + (snapshotInputs > 0 ? inputFile.getFullPathName() + "\n" : juce::String())
+                                          + outputFile.getFullPathName()
+                                        : "Could not write the capture history to " + directory.getFullPathName();
+
+        juce::MessageManager::callAsync([onFinished, ok, message] { onFinished(ok, message); });
+    });
+}
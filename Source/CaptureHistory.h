@@ -0,0 +1,106 @@
+//
+// CaptureHistory.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AudioRingBuffer.h"
+#include "HostAudioCallback.h"
+#include "ProfiledMutex.h"
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+/**
+ * Keeps a rolling in-memory history of the last few minutes of device input and chain output
+ * The audio thread only copies into small ring buffers; a background thread packs the audio
+ * into one-second chunks (optionally FLAC-compressed) and drops chunks that fall out of the window
+ *
+ * Compressed chunks are 24-bit, so they are not bit-exact copies of the float audio; a chunk that
+ * peaks above 0 dBFS is scaled down by a power of two first and scaled back up when it is read.
+ * The history never holds more than maxMemoryBytes, whatever the window, and is off by default.
+ */
+class CaptureHistory : public HostAudioTap,
+                       private juce::Thread
+{
+public:
+    /** Called on the message thread once a dump has finished */
+    using DumpCallback = std::function<void(bool succeeded, const juce::String& message)>;
+
+    /** Wide, high-rate devices get a shorter history rather than gigabytes of it */
+    static constexpr size_t maxMemoryBytes = (size_t) 1 << 30;
+
+    CaptureHistory();
+    ~CaptureHistory() override;
+
+    /** Sets how many minutes to keep (0 disables the history) and whether to compress chunks */
+    void setConfiguration(int minutesToKeep, bool compressChunks);
+
+    int getMinutesToKeep() const noexcept    { return minutesToKeep.load(); }
+    bool isCompressing() const noexcept      { return compress.load(); }
+
+    /** Seconds of audio currently held */
+    double getSecondsAvailable() const;
+
+    /** Bytes currently used by stored chunks */
+    size_t getMemoryUsage() const;
+
+    /**
+     * Writes the current history to an input and an output WAV file in the given folder
+     * Encoding happens on a background thread, so audio keeps running untouched
+     */
+    void dumpToDirectory(const juce::File& directory, DumpCallback onFinished);
+
+    // HostAudioTap
+    void tapAboutToStart(double sampleRate, int numInputChannels, int numOutputChannels) override;
+    void tapInput(const float* const* data, int numChannels, int numSamples) noexcept override;
+    void tapOutput(const float* const* data, int numChannels, int numSamples) noexcept override;
+
+private:
+    struct Chunk
+    {
+        juce::MemoryBlock data;
+        bool compressed = false;
+        float gain = 1.0f;      // what the stored samples are multiplied by to get the audio back
+        int numChannels = 0;
+        int numSamples = 0;
+    };
+
+    using ChunkList = std::deque<std::shared_ptr<const Chunk>>;
+
+    void run() override;
+    void finishChunk();
+    std::shared_ptr<const Chunk> packChunk(const juce::AudioBuffer<float>& audio, int numSamples) const;
+    static std::shared_ptr<const Chunk> copyChunk(const juce::AudioBuffer<float>& audio, int numChannels, int numSamples);
+    static bool unpackChunk(const Chunk& chunk, juce::AudioBuffer<float>& dest);
+    void trimHistory();
+
+    AudioRingBuffer inputRing, outputRing;
+
+    // The chunk being filled; a dump copies what it has so far
+    mutable ProfiledMutex pendingMutex { "CaptureHistory pending chunk" };
+    juce::AudioBuffer<float> pending;
+    int pendingSamples = 0;
+    bool inputPushed = false; // audio thread only
+
+    double sampleRate = 0.0;
+    int numInputs = 0, numOutputs = 0;
+
+    mutable ProfiledMutex chunkMutex { "CaptureHistory chunks" };
+    ChunkList chunks;
+    size_t memoryUsage = 0;
+
+    std::atomic<int> minutesToKeep { 0 };
+    std::atomic<bool> compress { true };
+    std::atomic<bool> acceptingAudio { false };
+    std::atomic<int> droppedBlocks { 0 };
+    bool memoryCapReported = false;     // packing thread only
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CaptureHistory)
+};
@@ -0,0 +1,312 @@
+//
+// ChainAnalyzer.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "ChainAnalyzer.h"
+#include <cmath>
+#include <numeric>
+
+namespace
+{
+    // About 2.7 s at 48 kHz, so a slow wake-up never loses audio
+    const int ringCapacity = 1 << 17;
+
+    const int activeIntervalMs = 33;
+    const int slowestIntervalMs = 250;
+
+    const float spectrumFloorDb = -120.0f;
+    const float spectrumFallPerWakeDb = 3.0f;
+
+    const int blocksPerGatingWindow = 4;    // 400 ms of 100 ms blocks
+    const int blocksPerShortTerm = 30;      // 3 s
+    const size_t maxGatingBlocks = 36000;   // an hour
+}
+
+//==============================================================================
+ChainAnalyzer::ChainAnalyzer()
+    : juce::Thread("Chain Analyzer")
+{
+    ring.allocate(2, ringCapacity);
+
+    history.assign((size_t) fftSize, 0.0f);
+    fftData.assign((size_t) fftSize * 2, 0.0f);
+    spectrum.assign((size_t) fftSize / 2, spectrumFloorDb);
+
+    startThread(juce::Thread::Priority::low);
+}
+
+ChainAnalyzer::~ChainAnalyzer()
+{
+    active.store(false);
+    stopThread(2000);
+}
+
+void ChainAnalyzer::setActive(bool shouldBeActive)
+{
+    active.store(shouldBeActive);
+    notify();
+}
+
+ChainAnalyzer::Results ChainAnalyzer::getResults() const
+{
+    std::lock_guard<ProfiledMutex> lock(resultsMutex);
+    return results;
+}
+
+//==============================================================================
+void ChainAnalyzer::tapAboutToStart(double sampleRate, int, int)
+{
+    deviceSampleRate.store(sampleRate > 0.0 ? sampleRate : 44100.0);
+}
+
+void ChainAnalyzer::tapOutput(const float* const* data, int numChannels, int numSamples) noexcept
+{
+    if (listeningToChainOutput.load(std::memory_order_relaxed))
+        push(data, numChannels, numSamples);
+}
+
+void ChainAnalyzer::push(const float* const* data, int numChannels, int numSamples) noexcept
+{
+    if (! active.load(std::memory_order_relaxed))
+        return;
+
+    // A mono source is analysed as the same signal on both sides
+    const float* channels[2] = { data[0], numChannels > 1 ? data[1] : data[0] };
+    if (numChannels <= 0 || ! ring.push(channels, 2, numSamples))
+        numDroppedBlocks.fetch_add(1, std::memory_order_relaxed);
+}
+
+//==============================================================================
+void ChainAnalyzer::run()
+{
+    juce::AudioBuffer<float> block(2, ringCapacity);
+    int intervalMs = activeIntervalMs;
+    bool wasActive = false;
+
+    while (! threadShouldExit())
+    {
+        if (! active.load())
+        {
+            wasActive = false;
+            wait(-1);
+            continue;
+        }
+
+        // Whatever queued up before the window was looked at again is stale
+        if (! wasActive)
+        {
+            ring.skip(ring.getNumReady());
+            wasActive = true;
+        }
+
+        const double sampleRate = deviceSampleRate.load();
+        if (sampleRate != analysisSampleRate || loudnessResetRequested.exchange(false))
+            prepareLoudness(sampleRate);
+
+        const juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+        const int numSamples = ring.pop(block, ringCapacity);
+
+        if (numSamples > 0)
+        {
+            analyseLoudness(block, numSamples);
+            analyseSpectrum(block, numSamples);
+            analyseCorrelation(block, numSamples);
+
+            std::lock_guard<ProfiledMutex> lock(resultsMutex);
+            results.spectrumDecibels = spectrum;
+            results.sampleRate = analysisSampleRate;
+            results.correlation = correlation;
+            results.numDroppedBlocks = numDroppedBlocks.load();
+        }
+
+        // Spend at most a quarter of the time analysing; give some of it back once the load drops
+        const double elapsedMs = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+        if (elapsedMs > intervalMs * 0.25)
+            intervalMs = juce::jmin(slowestIntervalMs, intervalMs * 2);
+        else if (elapsedMs < intervalMs * 0.05)
+            intervalMs = juce::jmax(activeIntervalMs, intervalMs / 2);
+
+        wait(intervalMs);
+    }
+}
+
+//==============================================================================
+void ChainAnalyzer::prepareLoudness(double sampleRate)
+{
+    analysisSampleRate = sampleRate;
+    samplesPerBlock = juce::jmax(1, juce::roundToInt(sampleRate * 0.1));
+    blockEnergy = 0.0;
+    blockSamples = 0;
+    recentBlocks.clear();
+    gatingBlocks.clear();
+
+    // The two K-weighting stages of BS.1770, redesigned for this sample rate
+    const double pi = juce::MathConstants<double>::pi;
+
+    {
+        const double f0 = 1681.974450955533, gainDb = 3.999843853973347, q = 0.7071752369554196;
+        const double k = std::tan(pi * f0 / sampleRate);
+        const double vh = std::pow(10.0, gainDb / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+
+        for (auto& filter : shelf)
+        {
+            filter = Biquad();
+            filter.b0 = (vh + vb * k / q + k * k) / a0;
+            filter.b1 = 2.0 * (k * k - vh) / a0;
+            filter.b2 = (vh - vb * k / q + k * k) / a0;
+            filter.a1 = 2.0 * (k * k - 1.0) / a0;
+            filter.a2 = (1.0 - k / q + k * k) / a0;
+        }
+    }
+
+    {
+        const double f0 = 38.13547087602444, q = 0.5003270373238773;
+        const double k = std::tan(pi * f0 / sampleRate);
+        const double a0 = 1.0 + k / q + k * k;
+
+        for (auto& filter : highPass)
+        {
+            filter = Biquad();
+            filter.b0 = 1.0;
+            filter.b1 = -2.0;
+            filter.b2 = 1.0;
+            filter.a1 = 2.0 * (k * k - 1.0) / a0;
+            filter.a2 = (1.0 - k / q + k * k) / a0;
+        }
+    }
+
+    std::lock_guard<ProfiledMutex> lock(resultsMutex);
+    results.momentaryLufs = results.shortTermLufs = results.integratedLufs = -100.0;
+}
+
+double ChainAnalyzer::toLufs(double meanSquare) noexcept
+{
+    return meanSquare > 0.0 ? -0.691 + 10.0 * std::log10(meanSquare) : -100.0;
+}
+
+void ChainAnalyzer::analyseLoudness(const juce::AudioBuffer<float>& block, int numSamples)
+{
+    const float* left = block.getReadPointer(0);
+    const float* right = block.getReadPointer(1);
+    bool blocksCompleted = false;
+
+    for (int i = 0; i < numSamples; i++)
+    {
+        const double l = highPass[0].process(shelf[0].process(left[i]));
+        const double r = highPass[1].process(shelf[1].process(right[i]));
+        blockEnergy += l * l + r * r;
+
+        if (++blockSamples < samplesPerBlock)
+            continue;
+
+        recentBlocks.push_back(blockEnergy / samplesPerBlock);
+        if ((int) recentBlocks.size() > blocksPerShortTerm)
+            recentBlocks.erase(recentBlocks.begin());
+
+        // Every 100 ms completes another overlapping 400 ms gating block
+        if ((int) recentBlocks.size() >= blocksPerGatingWindow && gatingBlocks.size() < maxGatingBlocks)
+            gatingBlocks.push_back(std::accumulate(recentBlocks.end() - blocksPerGatingWindow, recentBlocks.end(), 0.0) / blocksPerGatingWindow);
+
+        blockEnergy = 0.0;
+        blockSamples = 0;
+        blocksCompleted = true;
+    }
+
+    if (! blocksCompleted || recentBlocks.empty())
+        return;
+
+    const int numMomentary = juce::jmin(blocksPerGatingWindow, (int) recentBlocks.size());
+    const double momentary = std::accumulate(recentBlocks.end() - numMomentary, recentBlocks.end(), 0.0) / numMomentary;
+    const double shortTerm = std::accumulate(recentBlocks.begin(), recentBlocks.end(), 0.0) / (double) recentBlocks.size();
+
+    // Integrated: drop the blocks below -70 LUFS, then the ones 10 LU below what is left
+    double sum = 0.0;
+    int count = 0;
+    for (const double energy : gatingBlocks)
+        if (toLufs(energy) > -70.0) { sum += energy; count++; }
+
+    double integrated = -100.0;
+    if (count > 0)
+    {
+        const double relativeGate = toLufs(sum / count) - 10.0;
+        double gatedSum = 0.0;
+        int gatedCount = 0;
+        for (const double energy : gatingBlocks)
+            if (toLufs(energy) > -70.0 && toLufs(energy) > relativeGate) { gatedSum += energy; gatedCount++; }
+
+        if (gatedCount > 0)
+            integrated = toLufs(gatedSum / gatedCount);
+    }
+
+    std::lock_guard<ProfiledMutex> lock(resultsMutex);
+    results.momentaryLufs = toLufs(momentary);
+    results.shortTermLufs = toLufs(shortTerm);
+    results.integratedLufs = integrated;
+}
+
+void ChainAnalyzer::analyseSpectrum(const juce::AudioBuffer<float>& block, int numSamples)
+{
+    const float* left = block.getReadPointer(0);
+    const float* right = block.getReadPointer(1);
+
+    // Only the newest fftSize samples matter
+    const int first = juce::jmax(0, numSamples - fftSize);
+    for (int i = first; i < numSamples; i++)
+    {
+        history[(size_t) historyPosition] = 0.5f * (left[i] + right[i]);
+        historyPosition = (historyPosition + 1) % fftSize;
+    }
+
+    // Oldest sample first, then the window and the transform
+    std::copy(history.begin() + historyPosition, history.end(), fftData.begin());
+    std::copy(history.begin(), history.begin() + historyPosition, fftData.begin() + (fftSize - historyPosition));
+    window.multiplyWithWindowingTable(fftData.data(), (size_t) fftSize);
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    const float scale = 2.0f / (float) fftSize;
+    for (int bin = 0; bin < fftSize / 2; bin++)
+    {
+        const float level = juce::Decibels::gainToDecibels(fftData[(size_t) bin] * scale, spectrumFloorDb);
+
+        // Peaks show at once and fall back slowly, which reads better than the raw frames
+        spectrum[(size_t) bin] = juce::jmax(level, spectrum[(size_t) bin] - spectrumFallPerWakeDb);
+    }
+}
+
+void ChainAnalyzer::analyseCorrelation(const juce::AudioBuffer<float>& block, int numSamples)
+{
+    const float* left = block.getReadPointer(0);
+    const float* right = block.getReadPointer(1);
+    double lr = 0.0, ll = 0.0, rr = 0.0;
+
+    for (int i = 0; i < numSamples; i++)
+    {
+        lr += left[i] * right[i];
+        ll += left[i] * left[i];
+        rr += right[i] * right[i];
+    }
+
+    // Silence says nothing about the stereo image, so the last reading stays
+    if (ll <= 1.0e-12 || rr <= 1.0e-12)
+        return;
+
+    const float current = (float) (lr / std::sqrt(ll * rr));
+    correlation += (current - correlation) * 0.3f;
+}
+
+//==============================================================================
+TapProcessor::TapProcessor(HostAudioTap& tapToFeed)
+    : juce::AudioProcessor(BusesProperties().withInput("Input", juce::AudioChannelSet::stereo())),
+      tap(tapToFeed)
+{
+}
+
+void TapProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+{
+    tap.tapOutput(buffer.getArrayOfReadPointers(), getTotalNumInputChannels(), buffer.getNumSamples());
+}
@@ -0,0 +1,170 @@
+//
+// ChainAnalyzer.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AudioRingBuffer.h"
+#include "HostAudioCallback.h"
+#include "ProfiledMutex.h"
+#include <atomic>
+#include <vector>
+
+/**
+ * Spectrum, loudness and stereo correlation of the chain output or of one plugin's output
+ *
+ * The audio side only copies each block into a ring buffer, and only while someone is looking.
+ * A background thread drains the ring and does the FFT, the ITU-R BS.1770 loudness (momentary,
+ * short-term and gated integrated) and the correlation. It wakes about 30 times a second while
+ * active, backs off if the analysis falls behind, and sleeps entirely while inactive.
+ */
+class ChainAnalyzer : public HostAudioTap,
+                      private juce::Thread
+{
+public:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+
+    struct Results
+    {
+        std::vector<float> spectrumDecibels;    // fftSize / 2 bins from 0 Hz to half the sample rate
+        double sampleRate = 44100.0;
+        double momentaryLufs = -100.0;
+        double shortTermLufs = -100.0;
+        double integratedLufs = -100.0;
+        float correlation = 1.0f;
+        int numDroppedBlocks = 0;
+    };
+
+    ChainAnalyzer();
+    ~ChainAnalyzer() override;
+
+    /** Starts or stops the analysis; while inactive the audio side does nothing at all */
+    void setActive(bool shouldBeActive);
+    bool isActive() const noexcept                  { return active.load(); }
+
+    /** Listen to the device output (the default), or only to what arrives through getNodeTap() */
+    void setListeningToChainOutput(bool shouldListen) noexcept  { listeningToChainOutput.store(shouldListen); }
+
+    /** Feeds the analyzer from a plugin; give it to the linear chain or to a TapProcessor in the graph */
+    HostAudioTap& getNodeTap() noexcept             { return nodeTap; }
+
+    /** Starts the integrated loudness over */
+    void resetLoudness() noexcept                   { loudnessResetRequested.store(true); }
+
+    /** A copy of the latest figures; message thread */
+    Results getResults() const;
+
+    //==============================================================================
+    void tapAboutToStart(double sampleRate, int numInputChannels, int numOutputChannels) override;
+    void tapInput(const float* const*, int, int) noexcept override {}
+    void tapOutput(const float* const* data, int numChannels, int numSamples) noexcept override;
+
+private:
+    class NodeTap : public HostAudioTap
+    {
+    public:
+        explicit NodeTap(ChainAnalyzer& analyzer) : owner(analyzer) {}
+
+        void tapAboutToStart(double, int, int) override {}
+        void tapInput(const float* const*, int, int) noexcept override {}
+        void tapOutput(const float* const* data, int numChannels, int numSamples) noexcept override
+        {
+            owner.push(data, numChannels, numSamples);
+        }
+
+    private:
+        ChainAnalyzer& owner;
+    };
+
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+        double z1 = 0.0, z2 = 0.0;
+
+        double process(double x) noexcept
+        {
+            const double y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+            return y;
+        }
+    };
+
+    void push(const float* const* data, int numChannels, int numSamples) noexcept;
+    void run() override;
+
+    void prepareLoudness(double sampleRate);
+    void analyseLoudness(const juce::AudioBuffer<float>& block, int numSamples);
+    void analyseSpectrum(const juce::AudioBuffer<float>& block, int numSamples);
+    void analyseCorrelation(const juce::AudioBuffer<float>& block, int numSamples);
+    static double toLufs(double meanSquare) noexcept;
+
+    NodeTap nodeTap { *this };
+    AudioRingBuffer ring;
+    std::atomic<bool> active { false };
+    std::atomic<bool> listeningToChainOutput { true };
+    std::atomic<double> deviceSampleRate { 44100.0 };
+    std::atomic<int> numDroppedBlocks { 0 };
+    std::atomic<bool> loudnessResetRequested { false };
+
+    // Background thread only
+    juce::dsp::FFT fft { fftOrder };
+    juce::dsp::WindowingFunction<float> window { (size_t) fftSize, juce::dsp::WindowingFunction<float>::hann };
+    std::vector<float> history, fftData, spectrum;
+    int historyPosition = 0;
+
+    double analysisSampleRate = 0.0;
+    Biquad shelf[2], highPass[2];
+    double blockEnergy = 0.0;
+    int blockSamples = 0, samplesPerBlock = 4410;
+    std::vector<double> recentBlocks;       // the last 3 s of 100 ms energies, newest last
+    std::vector<double> gatingBlocks;       // 400 ms energies every 100 ms, for the integrated figure
+    float correlation = 1.0f;
+
+    mutable ProfiledMutex resultsMutex { "ChainAnalyzer results" };
+    Results results;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChainAnalyzer)
+};
+
+//==============================================================================
+/**
+ * Graph node that hands its input to a tap and outputs nothing
+ * Connected alongside a plugin's regular outputs, it lets the graph engine feed the analyzer
+ */
+class TapProcessor : public juce::AudioProcessor
+{
+public:
+    explicit TapProcessor(HostAudioTap& tapToFeed);
+
+    const juce::String getName() const override             { return "Tap"; }
+    void prepareToPlay(double, int) override {}
+    void releaseResources() override {}
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override;
+
+    double getTailLengthSeconds() const override            { return 0.0; }
+    bool acceptsMidi() const override                       { return false; }
+    bool producesMidi() const override                      { return false; }
+
+    juce::AudioProcessorEditor* createEditor() override     { return nullptr; }
+    bool hasEditor() const override                         { return false; }
+
+    int getNumPrograms() override                           { return 1; }
+    int getCurrentProgram() override                        { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override         { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+
+    void getStateInformation(juce::MemoryBlock&) override {}
+    void setStateInformation(const void*, int) override {}
+
+private:
+    HostAudioTap& tap;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TapProcessor)
+};
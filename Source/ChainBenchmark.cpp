@@ -0,0 +1,164 @@
+//
+// ChainBenchmark.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "ChainBenchmark.h"
+#include "LinearChainProcessor.h"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    const double benchmarkSampleRate = 48000.0;
+    const int warmupBlocks = 200;
+    const int measuredBlocks = 5000;
+    const int defaultNumStages = 8;
+
+    /** Stereo unity gain - about as cheap as a real plugin can be */
+    class UnityStage : public juce::AudioProcessor
+    {
+    public:
+        UnityStage()
+            : juce::AudioProcessor(BusesProperties()
+                                       .withInput("Input", juce::AudioChannelSet::stereo(), true)
+                                       .withOutput("Output", juce::AudioChannelSet::stereo(), true))
+        {
+        }
+
+        const juce::String getName() const override             { return "Unity"; }
+        void prepareToPlay(double, int) override {}
+        void releaseResources() override {}
+        void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override { buffer.applyGain(1.0f); }
+
+        double getTailLengthSeconds() const override             { return 0.0; }
+        bool acceptsMidi() const override                        { return false; }
+        bool producesMidi() const override                       { return false; }
+        juce::AudioProcessorEditor* createEditor() override      { return nullptr; }
+        bool hasEditor() const override                          { return false; }
+        int getNumPrograms() override                            { return 1; }
+        int getCurrentProgram() override                         { return 0; }
+        void setCurrentProgram(int) override {}
+        const juce::String getProgramName(int) override          { return {}; }
+        void changeProgramName(int, const juce::String&) override {}
+        void getStateInformation(juce::MemoryBlock&) override {}
+        void setStateInformation(const void*, int) override {}
+    };
+
+    struct Timing
+    {
+        double mean = 0.0, median = 0.0, p99 = 0.0;
+    };
+
+    Timing measure(juce::AudioProcessor& processor, int blockSize)
+    {
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+        juce::Random random(1);
+
+        std::vector<double> micros;
+        micros.reserve(measuredBlocks);
+
+        for (int i = 0; i < warmupBlocks + measuredBlocks; ++i)
+        {
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                for (int s = 0; s < blockSize; ++s)
+                    buffer.setSample(ch, s, random.nextFloat() * 2.0f - 1.0f);
+
+            const juce::int64 start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(buffer, midi);
+            const juce::int64 end = juce::Time::getHighResolutionTicks();
+
+            if (i >= warmupBlocks)
+                micros.push_back(juce::Time::highResolutionTicksToSeconds(end - start) * 1.0e6);
+        }
+
+        std::sort(micros.begin(), micros.end());
+
+        Timing timing;
+        for (double t : micros)
+            timing.mean += t;
+        timing.mean /= (double) micros.size();
+        timing.median = micros[micros.size() / 2];
+        timing.p99 = micros[(micros.size() * 99) / 100];
+        return timing;
+    }
+
+    juce::String formatTiming(const Timing& timing)
+    {
+        return juce::String(timing.mean, 2).paddedLeft(' ', 8)
+             + juce::String(timing.median, 2).paddedLeft(' ', 8)
+             + juce::String(timing.p99, 2).paddedLeft(' ', 8);
+    }
+
+    /** Builds the chain exactly the way IconMenu::loadActivePlugins() wires it, then times both engines */
+    juce::String benchmarkChain(int numStages, bool bypassEveryOther, int blockSize)
+    {
+        juce::AudioProcessorGraph graph;
+        auto inputNode = graph.addNode(std::make_unique<juce::AudioProcessorGraph::AudioGraphIOProcessor>(
+            juce::AudioProcessorGraph::AudioGraphIOProcessor::audioInputNode));
+        auto outputNode = graph.addNode(std::make_unique<juce::AudioProcessorGraph::AudioGraphIOProcessor>(
+            juce::AudioProcessorGraph::AudioGraphIOProcessor::audioOutputNode));
+
+        LinearChainProcessor chain;
+        juce::AudioProcessorGraph::NodeID previous = inputNode->nodeID;
+
+        for (int i = 0; i < numStages; ++i)
+        {
+            auto node = graph.addNode(std::make_unique<UnityStage>());
+            const bool bypass = bypassEveryOther && (i % 2) == 1;
+            chain.addStage(node->getProcessor(), bypass);
+
+            if (bypass)
+                continue;
+
+            for (int ch = 0; ch < 2; ++ch)
+                graph.addConnection({ { previous, ch }, { node->nodeID, ch } });
+            previous = node->nodeID;
+        }
+
+        for (int ch = 0; ch < 2; ++ch)
+            graph.addConnection({ { previous, ch }, { outputNode->nodeID, ch } });
+
+        graph.setPlayConfigDetails(2, 2, benchmarkSampleRate, blockSize);
+        graph.prepareToPlay(benchmarkSampleRate, blockSize);
+        const Timing graphTiming = measure(graph, blockSize);
+        graph.releaseResources();
+
+        chain.setPlayConfigDetails(2, 2, benchmarkSampleRate, blockSize);
+        chain.prepareToPlay(benchmarkSampleRate, blockSize);
+        const Timing chainTiming = measure(chain, blockSize);
+        chain.releaseResources();
+        chain.clearStages();
+
+        const double saving = graphTiming.mean - chainTiming.mean;
+
+        return juce::String(numStages).paddedLeft(' ', 6)
+             + juce::String(bypassEveryOther ? "yes" : "no").paddedLeft(' ', 9)
+             + juce::String(blockSize).paddedLeft(' ', 7)
+             + formatTiming(graphTiming)
+             + formatTiming(chainTiming)
+             + juce::String(saving, 2).paddedLeft(' ', 10)
+             + juce::String(numStages > 0 ? saving / numStages : 0.0, 3).paddedLeft(' ', 10);
+    }
+}
+
+int ChainBenchmark::run(int numStages)
+{
+    if (numStages <= 0)
+        numStages = defaultNumStages;
+
+    std::cout << "Chain engine benchmark: " << numStages << " unity stages, " << measuredBlocks
+              << " blocks per run, times in microseconds per block" << std::endl;
+    std::cout << "Stages Bypassed  Block   Graph: mean  median     p99  Linear: mean  median     p99"
+                 "  Saving  Per stage" << std::endl;
+
+    for (bool bypass : { false, true })
+        for (int blockSize : { 32, 64, 128, 256, 512, 1024 })
+            std::cout << benchmarkChain(numStages, bypass, blockSize) << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,22 @@
+//
+// ChainBenchmark.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/**
+ * Measures the per-block cost of running a chain through the AudioProcessorGraph versus the
+ * LinearChainProcessor, using trivial built-in stages so only the host overhead is timed
+ * Run with -benchmark-chain[=numStages]; the report is written to stdout
+ */
+class ChainBenchmark
+{
+public:
+    /** Runs the benchmark and returns a process exit code */
+    static int run(int numStages);
+};
@@ -0,0 +1,351 @@
+//
+// ChainBuilder.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "ChainBuilder.h"
+#include <iostream>
+
+namespace
+{
+    const int CHANNEL_ONE = 0;
+    const int CHANNEL_TWO = 1;
+
+    void connectStereo(juce::AudioProcessorGraph& graph, juce::AudioProcessorGraph::NodeID source,
+                       juce::AudioProcessorGraph::NodeID destination)
+    {
+        graph.addConnection({{ source, CHANNEL_ONE }, { destination, CHANNEL_ONE }});
+        graph.addConnection({{ source, CHANNEL_TWO }, { destination, CHANNEL_TWO }});
+    }
+}
+
+//==============================================================================
+juce::String SidechainSource::toString() const
+{
+    if (pluginIdentifier.isNotEmpty())
+        return "plugin:" + pluginIdentifier;
+    if (inputChannel >= 0)
+        return "input:" + juce::String(inputChannel);
+    return {};
+}
+
+SidechainSource SidechainSource::fromString(const juce::String& text)
+{
+    SidechainSource source;
+    if (text.startsWith("plugin:"))
+        source.pluginIdentifier = text.fromFirstOccurrenceOf("plugin:", false, false);
+    else if (text.startsWith("input:"))
+        source.inputChannel = juce::jmax(0, text.fromFirstOccurrenceOf("input:", false, false).getIntValue());
+    return source;
+}
+
+//==============================================================================
+
+ChainBuilder::ChainBuilder(juce::AudioPluginFormatManager& manager)
+    : formatManager(manager)
+{
+}
+
+std::unique_ptr<juce::AudioPluginInstance> ChainBuilder::createInstance(const ChainEntry& entry, double sampleRate,
+                                                                        int blockSize, juce::String& errorMessage)
+{
+    std::unique_ptr<juce::AudioPluginInstance> instance = formatManager.createPluginInstance(
+        entry.plugin, sampleRate, blockSize, errorMessage);
+
+    if (instance == nullptr)
+        return nullptr;
+
+    // Apply saved state if available
+    if (entry.state.isNotEmpty())
+    {
+        juce::MemoryBlock savedPluginBinary;
+        if (savedPluginBinary.fromBase64Encoding(entry.state))
+        {
+            // Protect against corrupt state data
+            try
+            {
+                instance->setStateInformation(savedPluginBinary.getData(),
+                                              static_cast<int>(savedPluginBinary.getSize()));
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << "Error loading state for plugin " << entry.plugin.name << ": " << e.what() << std::endl;
+            }
+        }
+    }
+
+    return instance;
+}
+
+ChainBuilder::Result ChainBuilder::build(const std::vector<ChainEntry>& entries, juce::AudioProcessorGraph& graph,
+                                         LinearChainProcessor& linearChain, double sampleRate, int blockSize)
+{
+    Result result;
+
+    linearChain.clearStages();
+    linearChain.setMidiInput(midiRouter);
+
+    // Plugins worth keeping stay in the graph with their connections cut; every other node goes
+    std::map<juce::String, juce::AudioProcessorGraph::Node::Ptr> keptNodes;
+    std::vector<juce::AudioProcessorGraph::NodeID> nodesToRemove;
+    for (auto node : graph.getNodes())
+    {
+        auto instance = dynamic_cast<juce::AudioPluginInstance*>(node->getProcessor());
+        const juce::String identifier = instance != nullptr ? instance->getPluginDescription().createIdentifierString() : juce::String();
+
+        if (identifier.isNotEmpty() && pluginsToKeep.contains(identifier) && keptNodes.count(identifier) == 0)
+            keptNodes[identifier] = node;
+        else
+            nodesToRemove.push_back(node->nodeID);
+    }
+
+    for (const auto nodeID : nodesToRemove)
+        graph.removeNode(nodeID);
+    for (const auto& kept : keptNodes)
+        graph.disconnectNode(kept.second->nodeID);
+
+    // Create input/output nodes using proper API for current JUCE version
+    result.inputNode = graph.addNode(std::make_unique<juce::AudioProcessorGraph::AudioGraphIOProcessor>(
+        juce::AudioProcessorGraph::AudioGraphIOProcessor::audioInputNode)).get();
+
+    result.outputNode = graph.addNode(std::make_unique<juce::AudioProcessorGraph::AudioGraphIOProcessor>(
+        juce::AudioProcessorGraph::AudioGraphIOProcessor::audioOutputNode)).get();
+
+    auto midiInputNode = graph.addNode(std::make_unique<juce::AudioProcessorGraph::AudioGraphIOProcessor>(
+        juce::AudioProcessorGraph::AudioGraphIOProcessor::midiInputNode));
+
+    juce::AudioProcessorGraph::Node* lastNode = nullptr;
+
+    // For sidechains: where each plugin sits
+    std::map<juce::String, juce::AudioProcessorGraph::Node*> placedNodes;
+
+    // Bypassed plugins go first when the whole chain, as last measured, would not fit
+    bool hibernateBypassed = false;
+    if (memoryMonitor != nullptr && memoryMonitor->getBudgetAction() == PluginMemoryMonitor::BudgetAction::hibernate
+        && memoryMonitor->getBudgetBytes() > 0)
+    {
+        juce::int64 expectedBytes = memoryMonitor->getLateGrowthBytes();
+        for (const auto& entry : entries)
+            expectedBytes += memoryMonitor->getExpectedBytes(entry.plugin);
+
+        hibernateBypassed = expectedBytes > memoryMonitor->getBudgetBytes();
+    }
+
+    if (memoryMonitor != nullptr)
+        memoryMonitor->beginChain();
+
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        const ChainEntry& entry = entries[i];
+        const juce::String identifier = entry.plugin.createIdentifierString();
+
+        if (shouldSkipForBudget(entry, hibernateBypassed, result))
+            continue;
+
+        juce::AudioProcessorGraph::Node* currentNode = nullptr;
+        bool sidechainBusEnabled = false;
+        bool canRestoreLayout = false;
+        juce::AudioProcessor::BusesLayout originalLayout;
+
+        auto kept = keptNodes.find(identifier);
+        if (kept != keptNodes.end())
+        {
+            // Its sidechain did not change, so the bus it had is still the one it needs; what its
+            // layout was before that bus went on is no longer known
+            currentNode = kept->second.get();
+            keptNodes.erase(kept);
+
+            if (memoryMonitor != nullptr)
+                memoryMonitor->keepInstance(entry.plugin);
+
+            auto* instance = static_cast<juce::AudioPluginInstance*>(currentNode->getProcessor());
+            sidechainBusEnabled = entry.sidechain.isEnabled() && ! entry.bypass && enableSidechainBus(*instance);
+        }
+        else
+        {
+            juce::String errorMessage;
+            const MemoryUsage before = memoryMonitor != nullptr ? MemoryUsage::sampleProcess() : MemoryUsage();
+            std::unique_ptr<juce::AudioPluginInstance> instance = createInstance(entry, sampleRate, blockSize, errorMessage);
+
+            if (instance == nullptr)
+            {
+                // Log the error and continue with the next plugin
+                std::cerr << "Failed to create plugin instance for " << entry.plugin.name << ": " << errorMessage << std::endl;
+                result.errors.add(entry.plugin.name + ": " + errorMessage);
+                continue;
+            }
+
+            if (memoryMonitor != nullptr)
+            {
+                memoryMonitor->recordInstance(entry.plugin, before);
+
+                // A first load has no prediction to go by, so check what it actually took
+                if (memoryMonitor->getBudgetAction() == PluginMemoryMonitor::BudgetAction::refuse && memoryMonitor->isOverBudget())
+                {
+                    result.errors.add(entry.plugin.name + ": needs " + PluginMemoryMonitor::formatBytes(memoryMonitor->getFootprint(entry.plugin))
+                                      + ", which does not fit the memory budget");
+                    memoryMonitor->removeInstance(entry.plugin);
+                    continue;
+                }
+            }
+
+            // The sidechain bus has to be on before the graph prepares the plugin
+            originalLayout = instance->getBusesLayout();
+            canRestoreLayout = true;
+            sidechainBusEnabled = entry.sidechain.isEnabled() && ! entry.bypass && enableSidechainBus(*instance);
+
+            currentNode = graph.addNode(std::move(instance)).get();
+        }
+
+        const bool acceptsMidi = currentNode->getProcessor()->acceptsMidi();
+
+        if (sidechainBusEnabled)
+        {
+            if (connectSidechain(entry, graph, currentNode, result.inputNode, placedNodes))
+            {
+                result.isPureChain = false;
+            }
+            else if (! canRestoreLayout || ! currentNode->getProcessor()->setBusesLayout(originalLayout))
+            {
+                // A plugin stuck with an unconnected key bus would get the wrong channels on the linear engine
+                result.isPureChain = false;
+            }
+        }
+
+        linearChain.addStage(currentNode->getProcessor(), entry.bypass);
+        linearChain.setStageMidiRoute(linearChain.getNumStages() - 1, entry.midiRoute);
+        linearChain.setStageRateDivisor(linearChain.getNumStages() - 1, entry.rateDivisor);
+        result.numPluginsLoaded++;
+
+        // In the graph each MIDI plugin gets its own route node between the MIDI input and the plugin
+        if (acceptsMidi && midiInputNode != nullptr)
+        {
+            auto routeNode = graph.addNode(std::make_unique<MidiRouteProcessor>(midiRouter, entry.midiRoute));
+            graph.addConnection({{ midiInputNode->nodeID, juce::AudioProcessorGraph::midiChannelIndex },
+                                 { routeNode->nodeID, juce::AudioProcessorGraph::midiChannelIndex }});
+            graph.addConnection({{ routeNode->nodeID, juce::AudioProcessorGraph::midiChannelIndex },
+                                 { currentNode->nodeID, juce::AudioProcessorGraph::midiChannelIndex }});
+        }
+
+        // Skip connections if plugin is bypassed
+        if (entry.bypass)
+            continue;
+
+        connectStereo(graph, lastNode != nullptr ? lastNode->nodeID : result.inputNode->nodeID, currentNode->nodeID);
+        lastNode = currentNode;
+        placedNodes[identifier] = currentNode;
+    }
+
+    // Kept plugins the chain no longer has room for
+    for (const auto& kept : keptNodes)
+        graph.removeNode(kept.second->nodeID);
+
+    // Connect the last plugin to the output, or pass straight through if nothing is active
+    connectStereo(graph, lastNode != nullptr ? lastNode->nodeID : result.inputNode->nodeID, result.outputNode->nodeID);
+
+    if (memoryMonitor != nullptr)
+        memoryMonitor->endChain();
+
+    return result;
+}
+
+bool ChainBuilder::enableSidechainBus(juce::AudioPluginInstance& instance)
+{
+    if (instance.getBusCount(true) < 2)
+        return false;
+
+    // Stereo keys if the plugin takes them, otherwise mono
+    for (const auto& channelSet : { juce::AudioChannelSet::stereo(), juce::AudioChannelSet::mono() })
+    {
+        auto layout = instance.getBusesLayout();
+        layout.inputBuses.getReference(1) = channelSet;
+
+        if (instance.checkBusesLayoutSupported(layout) && instance.setBusesLayout(layout))
+            return true;
+    }
+
+    return false;
+}
+
+bool ChainBuilder::connectSidechain(const ChainEntry& entry, juce::AudioProcessorGraph& graph, juce::AudioProcessorGraph::Node* node,
+                                    juce::AudioProcessorGraph::Node* inputNode,
+                                    const std::map<juce::String, juce::AudioProcessorGraph::Node*>& placedNodes)
+{
+    auto* instance = node->getProcessor();
+    const int numSidechainChannels = instance->getChannelCountOfBus(true, 1);
+    const int firstSidechainChannel = instance->getChannelIndexInProcessBlockBuffer(true, 1, 0);
+    if (numSidechainChannels <= 0 || firstSidechainChannel < 0)
+        return false;
+
+    juce::AudioProcessorGraph::NodeID sourceID;
+    int firstSourceChannel = 0;
+    int numSourceChannels = 2;
+
+    if (entry.sidechain.pluginIdentifier.isNotEmpty())
+    {
+        auto placed = placedNodes.find(entry.sidechain.pluginIdentifier);
+        if (placed == placedNodes.end())
+        {
+            std::cerr << "Sidechain source for " << entry.plugin.name << " is not earlier in the chain" << std::endl;
+            return false;
+        }
+
+        sourceID = placed->second->nodeID;
+        numSourceChannels = placed->second->getProcessor()->getTotalNumOutputChannels();
+    }
+    else
+    {
+        sourceID = inputNode->nodeID;
+        firstSourceChannel = entry.sidechain.inputChannel;
+        numSourceChannels = inputNode->getProcessor()->getTotalNumOutputChannels() - firstSourceChannel;
+    }
+
+    numSourceChannels = juce::jmin(numSourceChannels, numSidechainChannels);
+    if (numSourceChannels <= 0)
+    {
+        std::cerr << "Sidechain source for " << entry.plugin.name << " has no channels" << std::endl;
+        return false;
+    }
+
+    // The graph delays whichever of a node's inputs arrives early, so the key lines up with the audio it is keying
+    bool connected = false;
+    for (int channel = 0; channel < numSidechainChannels; channel++)
+    {
+        // A mono source feeds both sides of a stereo key
+        const int sourceChannel = firstSourceChannel + juce::jmin(channel, numSourceChannels - 1);
+        connected |= graph.addConnection({{ sourceID, sourceChannel }, { node->nodeID, firstSidechainChannel + channel }});
+    }
+
+    return connected;
+}
+
+bool ChainBuilder::shouldSkipForBudget(const ChainEntry& entry, bool hibernateBypassed, Result& result)
+{
+    if (memoryMonitor == nullptr)
+        return false;
+
+    switch (memoryMonitor->getBudgetAction())
+    {
+        case PluginMemoryMonitor::BudgetAction::refuse:
+            if (! memoryMonitor->wouldExceedBudget(entry.plugin))
+                return false;
+
+            result.errors.add(entry.plugin.name + ": does not fit the memory budget");
+            return true;
+
+        case PluginMemoryMonitor::BudgetAction::hibernate:
+            // Bypassed plugins are silent anyway; their saved state brings them back when switched on
+            if (! entry.bypass || ! (hibernateBypassed || memoryMonitor->wouldExceedBudget(entry.plugin)))
+                return false;
+
+            memoryMonitor->recordHibernated(entry.plugin);
+            result.numPluginsHibernated++;
+            return true;
+
+        case PluginMemoryMonitor::BudgetAction::warn:
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,108 @@
+//
+// ChainBuilder.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "LinearChainProcessor.h"
+#include "MidiInputRouter.h"
+#include "PluginMemoryMonitor.h"
+#include <map>
+#include <vector>
+
+/**
+ * What keys a plugin's sidechain input: a pair of device input channels, or an earlier plugin's output
+ */
+struct SidechainSource
+{
+    int inputChannel = -1;          // first channel of the device input pair, or -1
+    juce::String pluginIdentifier;  // a plugin earlier in the chain, or empty
+
+    bool isEnabled() const noexcept     { return inputChannel >= 0 || pluginIdentifier.isNotEmpty(); }
+
+    /** "input:2" or "plugin:<identifier>", as stored in the settings; empty when disabled */
+    juce::String toString() const;
+    static SidechainSource fromString(const juce::String& text);
+};
+
+/**
+ * One plugin slot of a chain, in processing order
+ */
+struct ChainEntry
+{
+    juce::PluginDescription plugin;
+    juce::String state;         // base64 plugin state as stored in the settings, may be empty
+    bool bypass = false;
+    MidiRoute midiRoute;        // which device MIDI reaches the plugin
+    SidechainSource sidechain;
+    int rateDivisor = 1;        // runs the plugin at the device rate divided by this, on the linear engine only
+};
+
+/**
+ * Builds the processing chain into an AudioProcessorGraph and a LinearChainProcessor
+ * Shared by the tray host and the offline tools so both render through identical wiring
+ */
+class ChainBuilder
+{
+public:
+    struct Result
+    {
+        juce::AudioProcessorGraph::Node* inputNode = nullptr;
+        juce::AudioProcessorGraph::Node* outputNode = nullptr;
+        int numPluginsLoaded = 0;
+        int numPluginsHibernated = 0;
+        bool isPureChain = true;
+        juce::StringArray errors;
+    };
+
+    explicit ChainBuilder(juce::AudioPluginFormatManager& formatManager);
+
+    /** Measures every instance and applies the monitor's budget; without one nothing is limited */
+    void setMemoryMonitor(PluginMemoryMonitor* monitorToUse)   { memoryMonitor = monitorToUse; }
+
+    /** Device MIDI for the plugins that accept MIDI; without a router they only get the player's MIDI */
+    void setMidiRouter(const MidiInputRouter* routerToUse)     { midiRouter = routerToUse; }
+
+    /**
+     * Plugins, by identifier, that the next build keeps from the graph instead of creating again
+     * A kept plugin keeps its live state and its last measured footprint. Its sidechain must not
+     * have changed, since the bus layout it was given is not undone.
+     */
+    void setPluginsToKeep(const juce::StringArray& identifiers)  { pluginsToKeep = identifiers; }
+
+    /**
+     * Rebuilds the graph and the linear chain as input -> entries -> output
+     * Neither processor may be attached to a player while this runs
+     *
+     * Every node but the kept plugins is replaced. New plugins are created in order on the calling
+     * thread, which has to be the message thread: off it, JUCE creates plugins through the message
+     * thread and would wait for it forever.
+     *
+     * Sidechains are only wired in the graph, so a chain with any of them is not a pure chain.
+     * The graph's input node must already have the device's input channels for input sidechains.
+     */
+    Result build(const std::vector<ChainEntry>& entries, juce::AudioProcessorGraph& graph,
+                 LinearChainProcessor& linearChain, double sampleRate, int blockSize);
+
+private:
+    std::unique_ptr<juce::AudioPluginInstance> createInstance(const ChainEntry& entry, double sampleRate,
+                                                              int blockSize, juce::String& errorMessage);
+
+    bool shouldSkipForBudget(const ChainEntry& entry, bool hibernateBypassed, Result& result);
+
+    static bool enableSidechainBus(juce::AudioPluginInstance& instance);
+    bool connectSidechain(const ChainEntry& entry, juce::AudioProcessorGraph& graph, juce::AudioProcessorGraph::Node* node,
+                          juce::AudioProcessorGraph::Node* inputNode,
+                          const std::map<juce::String, juce::AudioProcessorGraph::Node*>& placedNodes);
+
+    juce::AudioPluginFormatManager& formatManager;
+    PluginMemoryMonitor* memoryMonitor = nullptr;
+    const MidiInputRouter* midiRouter = nullptr;
+    juce::StringArray pluginsToKeep;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChainBuilder)
+};
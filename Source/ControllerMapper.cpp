@@ -0,0 +1,303 @@
+//
+// ControllerMapper.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "ControllerMapper.h"
+#include <cmath>
+
+namespace
+{
+    // Long enough to hide the 7-bit steps of a MIDI controller, short enough to feel immediate
+    const double smoothingSeconds = 0.02;
+    const float snapDistance = 1.0e-4f;
+}
+
+//==============================================================================
+juce::String ControllerSource::getDescription() const
+{
+    switch (kind)
+    {
+        case Kind::midiController:  return "CC " + juce::String(controller) + " (channel " + juce::String(channel) + ")";
+        case Kind::osc:             return "OSC " + address;
+        case Kind::none:
+        default:                    return "Nothing";
+    }
+}
+
+bool ControllerSource::operator== (const ControllerSource& other) const noexcept
+{
+    if (kind != other.kind)
+        return false;
+
+    if (kind == Kind::midiController)
+        return channel == other.channel && controller == other.controller;
+
+    return kind != Kind::osc || address == other.address;
+}
+
+//==============================================================================
+ControllerMapper::ControllerMapper(const MidiInputRouter& router, juce::AudioProcessorGraph& graphToUse)
+    : midiRouter(router), graph(graphToUse)
+{
+    oscReceiver.addListener(this);
+    currentTable.swap(std::make_unique<Table>());
+}
+
+ControllerMapper::~ControllerMapper()
+{
+    oscReceiver.removeListener(this);
+    oscReceiver.disconnect();
+}
+
+void ControllerMapper::setMappings(const std::vector<ControllerMapping>& newMappings)
+{
+    mappings = newMappings;
+
+    auto table = std::make_unique<Table>();
+    table->targets.reset(new Target[mappings.size()]);
+
+    for (const auto& mapping : mappings)
+    {
+        juce::AudioProcessorParameter* parameter = nullptr;
+
+        for (auto node : graph.getNodes())
+        {
+            auto instance = dynamic_cast<juce::AudioPluginInstance*>(node->getProcessor());
+            if (instance != nullptr && instance->getPluginDescription().createIdentifierString() == mapping.pluginIdentifier)
+            {
+                parameter = instance->getParameters()[mapping.parameterIndex];
+                break;
+            }
+        }
+
+        // Plugins that are not in the chain right now keep their mappings for later
+        if (parameter == nullptr || ! mapping.source.isValid())
+            continue;
+
+        const int index = table->numTargets++;
+        Target& target = table->targets[index];
+        target.parameter = parameter;
+        target.minimum = mapping.minimum;
+        target.maximum = mapping.maximum;
+
+        // Start from where the parameter is, so the first control move glides from there
+        const float range = mapping.maximum - mapping.minimum;
+        target.current = std::abs(range) > 0.0f ? juce::jlimit(0.0f, 1.0f, (parameter->getValue() - mapping.minimum) / range) : 0.0f;
+
+        // Several parameters on one control form a list through the targets
+        int* slot = nullptr;
+        if (mapping.source.kind == ControllerSource::Kind::midiController)
+            slot = &table->midiSlots[(mapping.source.channel - 1) * 128 + mapping.source.controller];
+        else
+            slot = &table->oscSlots.emplace(mapping.source.address, -1).first->second;
+
+        target.next = *slot;
+        *slot = index;
+    }
+
+    currentTable.swap(std::move(table));
+}
+
+void ControllerMapper::detachParameters()
+{
+    currentTable.swap(std::make_unique<Table>());
+}
+
+std::unique_ptr<juce::XmlElement> ControllerMapper::createXml() const
+{
+    auto xml = std::make_unique<juce::XmlElement>("CONTROLLERMAPPINGS");
+
+    for (const auto& mapping : mappings)
+    {
+        auto* mappingXml = xml->createNewChildElement("MAPPING");
+        if (mapping.source.kind == ControllerSource::Kind::midiController)
+        {
+            mappingXml->setAttribute("channel", mapping.source.channel);
+            mappingXml->setAttribute("controller", mapping.source.controller);
+        }
+        else
+        {
+            mappingXml->setAttribute("osc", mapping.source.address);
+        }
+
+        mappingXml->setAttribute("plugin", mapping.pluginIdentifier);
+        mappingXml->setAttribute("parameter", mapping.parameterIndex);
+        mappingXml->setAttribute("min", mapping.minimum);
+        mappingXml->setAttribute("max", mapping.maximum);
+    }
+
+    return xml;
+}
+
+void ControllerMapper::restoreFromXml(const juce::XmlElement& xml)
+{
+    std::vector<ControllerMapping> restored;
+
+    for (auto* mappingXml : xml.getChildWithTagNameIterator("MAPPING"))
+    {
+        ControllerMapping mapping;
+        if (mappingXml->hasAttribute("osc"))
+        {
+            mapping.source.kind = ControllerSource::Kind::osc;
+            mapping.source.address = mappingXml->getStringAttribute("osc");
+        }
+        else
+        {
+            mapping.source.kind = ControllerSource::Kind::midiController;
+            mapping.source.channel = juce::jlimit(1, 16, mappingXml->getIntAttribute("channel", 1));
+            mapping.source.controller = juce::jlimit(0, 127, mappingXml->getIntAttribute("controller"));
+        }
+
+        mapping.pluginIdentifier = mappingXml->getStringAttribute("plugin");
+        mapping.parameterIndex = mappingXml->getIntAttribute("parameter", -1);
+        mapping.minimum = (float) mappingXml->getDoubleAttribute("min", 0.0);
+        mapping.maximum = (float) mappingXml->getDoubleAttribute("max", 1.0);
+        restored.push_back(mapping);
+    }
+
+    setMappings(restored);
+}
+
+//==============================================================================
+void ControllerMapper::setLearning(bool shouldLearn) noexcept
+{
+    if (shouldLearn)
+    {
+        learnedMidi.store(-1);
+        const juce::SpinLock::ScopedLockType lock(learnedOscLock);
+        learnedOscAddress.clear();
+    }
+
+    learning.store(shouldLearn);
+}
+
+ControllerSource ControllerMapper::getLearnedSource() const
+{
+    ControllerSource source;
+    const int midi = learnedMidi.load();
+
+    const juce::SpinLock::ScopedLockType lock(learnedOscLock);
+    const bool oscIsNewer = learnedOscAddress.isNotEmpty() && (midi < 0 || (juce::int32) (learnedOscTime - learnedMidiTime.load()) > 0);
+
+    if (oscIsNewer)
+    {
+        source.kind = ControllerSource::Kind::osc;
+        source.address = learnedOscAddress;
+    }
+    else if (midi >= 0)
+    {
+        source.kind = ControllerSource::Kind::midiController;
+        source.channel = midi / 128 + 1;
+        source.controller = midi % 128;
+    }
+
+    return source;
+}
+
+//==============================================================================
+bool ControllerMapper::setOscPort(int port)
+{
+    oscReceiver.disconnect();
+    oscPort = 0;
+
+    if (port <= 0)
+        return true;
+
+    if (! oscReceiver.connect(port))
+    {
+        juce::Logger::writeToLog("Cannot listen for OSC on port " + juce::String(port));
+        return false;
+    }
+
+    oscPort = port;
+    return true;
+}
+
+void ControllerMapper::oscMessageReceived(const juce::OSCMessage& message)
+{
+    if (message.isEmpty())
+        return;
+
+    // Floats are taken as 0-1, integers as MIDI-style 0-127
+    const auto& argument = message[0];
+    float value;
+    if (argument.isFloat32())
+        value = argument.getFloat32();
+    else if (argument.isInt32())
+        value = (float) argument.getInt32() / 127.0f;
+    else
+        return;
+
+    const juce::String address = message.getAddressPattern().toString();
+
+    if (learning.load())
+    {
+        const juce::SpinLock::ScopedLockType lock(learnedOscLock);
+        learnedOscAddress = address;
+        learnedOscTime = juce::Time::getMillisecondCounter();
+    }
+
+    const RcuPointer<Table>::ScopedReader reader(currentTable);
+    if (reader.get() == nullptr)
+        return;
+
+    auto found = reader->oscSlots.find(address);
+    if (found != reader->oscSlots.end())
+        setWanted(*reader.get(), found->second, juce::jlimit(0.0f, 1.0f, value));
+}
+
+void ControllerMapper::setWanted(Table& table, int firstTarget, float value) noexcept
+{
+    for (int i = firstTarget; i >= 0; i = table.targets[i].next)
+        table.targets[i].wanted.store(value, std::memory_order_relaxed);
+}
+
+//==============================================================================
+void ControllerMapper::tapAboutToStart(double newSampleRate, int, int)
+{
+    sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+}
+
+void ControllerMapper::tapInput(const float* const*, int, int numSamples) noexcept
+{
+    const RcuPointer<Table>::ScopedReader reader(currentTable);
+    Table* table = reader.get();
+    if (table == nullptr)
+        return;
+
+    // The router has already filled this block's MIDI, since it was registered first
+    for (const auto metadata : midiRouter.getCurrentBlock())
+    {
+        if (metadata.numBytes != 3 || (metadata.data[0] & 0xf0) != 0xb0)
+            continue;
+
+        const int slot = (metadata.data[0] & 0x0f) * 128 + (metadata.data[1] & 0x7f);
+
+        if (learning.load(std::memory_order_relaxed))
+        {
+            learnedMidi.store(slot);
+            learnedMidiTime.store(juce::Time::getMillisecondCounter());
+        }
+
+        setWanted(*table, table->midiSlots[slot], (float) (metadata.data[2] & 0x7f) / 127.0f);
+    }
+
+    const float coefficient = (float) (1.0 - std::exp(-numSamples / (sampleRate * smoothingSeconds)));
+
+    for (int i = 0; i < table->numTargets; i++)
+    {
+        Target& target = table->targets[i];
+        const float wanted = target.wanted.load(std::memory_order_relaxed);
+        if (wanted < 0.0f || target.current == wanted)
+            continue;
+
+        target.current += (wanted - target.current) * coefficient;
+        if (std::abs(wanted - target.current) < snapDistance)
+            target.current = wanted;
+
+        target.parameter->setValue(target.minimum + target.current * (target.maximum - target.minimum));
+    }
+}
@@ -0,0 +1,151 @@
+//
+// ControllerMapper.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "HostAudioCallback.h"
+#include "MidiInputRouter.h"
+#include "RcuPointer.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/** A hardware control: a MIDI controller on one channel, or an OSC address */
+struct ControllerSource
+{
+    enum class Kind
+    {
+        none,
+        midiController,
+        osc
+    };
+
+    Kind kind = Kind::none;
+    int channel = 0;        // 1-16
+    int controller = 0;     // 0-127
+    juce::String address;
+
+    bool isValid() const noexcept   { return kind != Kind::none; }
+    juce::String getDescription() const;
+
+    bool operator== (const ControllerSource& other) const noexcept;
+};
+
+/** Drives one plugin parameter from a control; the control's 0-1 range covers minimum to maximum */
+struct ControllerMapping
+{
+    ControllerSource source;
+    juce::String pluginIdentifier;
+    int parameterIndex = -1;
+    float minimum = 0.0f;
+    float maximum = 1.0f;
+};
+
+//==============================================================================
+/**
+ * Moves plugin parameters from MIDI controllers and OSC messages without going through the message thread
+ *
+ * The mappings are compiled into an immutable table: a slot per MIDI channel and controller,
+ * a hash of OSC addresses, and the parameter handles they drive. Edits build a new table and
+ * swap it in atomically; the old one is freed once no reader is left in it. MIDI controllers
+ * are read from the router's block on the audio thread, OSC values are written straight into
+ * the table from the OSC thread, and every block the audio thread glides each parameter
+ * towards its latest value before the chain processes.
+ */
+class ControllerMapper : public HostAudioTap,
+                         private juce::OSCReceiver::Listener<juce::OSCReceiver::RealtimeCallback>
+{
+public:
+    ControllerMapper(const MidiInputRouter& router, juce::AudioProcessorGraph& graph);
+    ~ControllerMapper() override;
+
+    //==============================================================================
+    /** Message thread only; resolves the mappings against the plugins in the graph */
+    void setMappings(const std::vector<ControllerMapping>& newMappings);
+    const std::vector<ControllerMapping>& getMappings() const noexcept     { return mappings; }
+
+    /** Drops every parameter handle; call before the graph's plugins are deleted */
+    void detachParameters();
+
+    /** Looks the parameters up again after the graph was rebuilt */
+    void attachParameters()                                                 { setMappings(mappings); }
+
+    std::unique_ptr<juce::XmlElement> createXml() const;
+    void restoreFromXml(const juce::XmlElement& xml);
+
+    //==============================================================================
+    /** While learning, every incoming control is remembered so it can be mapped */
+    void setLearning(bool shouldLearn) noexcept;
+    bool isLearning() const noexcept                                        { return learning.load(); }
+
+    /** The control that moved last since learning started */
+    ControllerSource getLearnedSource() const;
+
+    //==============================================================================
+    /** Listens for OSC on a UDP port; 0 stops listening */
+    bool setOscPort(int port);
+    int getOscPort() const noexcept                                         { return oscPort; }
+
+    //==============================================================================
+    void tapAboutToStart(double sampleRate, int numInputChannels, int numOutputChannels) override;
+    void tapInput(const float* const* data, int numChannels, int numSamples) noexcept override;
+    void tapOutput(const float* const*, int, int) noexcept override {}
+
+private:
+    struct Target
+    {
+        juce::AudioProcessorParameter* parameter = nullptr;
+        float minimum = 0.0f, maximum = 1.0f;
+        std::atomic<float> wanted { -1.0f };    // control value, negative until the control moves
+        float current = 0.0f;                   // audio thread only
+        int next = -1;                          // the next target driven by the same control
+    };
+
+    struct StringHash
+    {
+        size_t operator()(const juce::String& s) const noexcept    { return (size_t) s.hash(); }
+    };
+
+    struct Table
+    {
+        static constexpr int numMidiSlots = 16 * 128;
+
+        Table() noexcept    { std::fill(std::begin(midiSlots), std::end(midiSlots), -1); }
+
+        int midiSlots[numMidiSlots];
+        std::unordered_map<juce::String, int, StringHash> oscSlots;
+        std::unique_ptr<Target[]> targets;
+        int numTargets = 0;
+    };
+
+    void oscMessageReceived(const juce::OSCMessage& message) override;
+    static void setWanted(Table& table, int firstTarget, float value) noexcept;
+
+    const MidiInputRouter& midiRouter;
+    juce::AudioProcessorGraph& graph;
+    std::vector<ControllerMapping> mappings;
+
+    RcuPointer<Table> currentTable;     // read by the audio and OSC threads
+
+    double sampleRate = 44100.0;
+
+    // Learning: MIDI is noticed on the audio thread, so it only stores numbers there
+    std::atomic<bool> learning { false };
+    std::atomic<int> learnedMidi { -1 };            // channel index * 128 + controller
+    std::atomic<juce::uint32> learnedMidiTime { 0 };
+    mutable juce::SpinLock learnedOscLock;
+    juce::String learnedOscAddress;
+    juce::uint32 learnedOscTime = 0;
+
+    juce::OSCReceiver oscReceiver;
+    int oscPort = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ControllerMapper)
+};
@@ -0,0 +1,217 @@
+//
+// DeviceReconfigurationCoordinator.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "DeviceReconfigurationCoordinator.h"
+#include "VirtualAudioDevice.h"
+
+namespace
+{
+    const double fadeMilliseconds = 20.0;
+    const int maxFadeWaitMs = 100;
+    const int reconnectPollMs = 2000;
+}
+
+DeviceReconfigurationCoordinator::DeviceReconfigurationCoordinator(juce::AudioDeviceManager& manager,
+                                                                   HostAudioCallback& callback)
+    : deviceManager(manager), hostCallback(callback)
+{
+    // Before the callback is added to the device, so the very first device fades too
+    hostCallback.setFadeTime(fadeMilliseconds);
+}
+
+DeviceReconfigurationCoordinator::~DeviceReconfigurationCoordinator()
+{
+    stopTimer();
+    cancelPendingUpdate();
+    hostCallback.onDeviceError = nullptr;
+    deviceManager.removeChangeListener(this);
+}
+
+void DeviceReconfigurationCoordinator::start()
+{
+    // Errors arrive on the device's thread; the check itself belongs on the message thread
+    hostCallback.onDeviceError = [this](const juce::String&) { triggerAsyncUpdate(); };
+    deviceManager.addChangeListener(this);
+
+    checkDevice(false);
+}
+
+juce::String DeviceReconfigurationCoordinator::applySetup(const juce::AudioDeviceManager::AudioDeviceSetup& setup,
+                                                          const juce::String& typeName)
+{
+    fadeOutAndWait();
+
+    const juce::ScopedValueSetter<bool> switchingScope(switching, true);
+
+    if (typeName.isNotEmpty() && typeName != deviceManager.getCurrentAudioDeviceType())
+        deviceManager.setCurrentAudioDeviceType(typeName, true);
+
+    const juce::String error = deviceManager.setAudioDeviceSetup(setup, true);
+
+    // A setup that matched the running one does not restart the device, so nothing fades in by itself
+    hostCallback.fadeIn();
+    return error;
+}
+
+void DeviceReconfigurationCoordinator::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    checkDevice(false);
+}
+
+void DeviceReconfigurationCoordinator::handleAsyncUpdate()
+{
+    checkDevice(true);
+}
+
+void DeviceReconfigurationCoordinator::timerCallback()
+{
+    if (! usingFallback)
+    {
+        stopTimer();
+        return;
+    }
+
+    if (! isPreferredDeviceAvailable(true))
+        return;
+
+    juce::Logger::writeToLog("Audio device " + preferredSetup.outputDeviceName + " is back, switching to it");
+
+    const juce::String error = applySetup(preferredSetup, preferredType);
+    if (error.isNotEmpty())
+    {
+        // Listed but not usable yet; keep the fallback and try again on the next poll
+        juce::Logger::writeToLog("Cannot reopen " + preferredSetup.outputDeviceName + ": " + error);
+        switchToFallback();
+        return;
+    }
+
+    usingFallback = false;
+    stopTimer();
+
+    if (onFallbackChanged != nullptr)
+        onFallbackChanged();
+}
+
+void DeviceReconfigurationCoordinator::checkDevice(bool rescan)
+{
+    if (switching)
+        return;
+
+    auto* device = deviceManager.getCurrentAudioDevice();
+
+    if (usingFallback)
+    {
+        // Anything other than the fallback device was chosen by the user and replaces the lost one
+        const bool onFallbackDevice = device != nullptr
+                                      && deviceManager.getCurrentAudioDeviceType() == VirtualAudioIODeviceType::typeName
+                                      && device->getName() == VirtualAudioIODeviceType::defaultDeviceName;
+        if (onFallbackDevice)
+            return;
+
+        usingFallback = false;
+        stopTimer();
+
+        if (onFallbackChanged != nullptr)
+            onFallbackChanged();
+    }
+    else if (hasPreferred && (device == nullptr || rescan) && ! isPreferredDeviceAvailable(rescan))
+    {
+        switchToFallback();
+        return;
+    }
+    else if (hasPreferred && device != nullptr && device->getName() != preferredSetup.outputDeviceName
+             && ! isPreferredDeviceAvailable(false))
+    {
+        // The device manager replaced the lost device with the system default
+        switchToFallback();
+        return;
+    }
+
+    if (device != nullptr && device->isOpen())
+        rememberCurrentDevice();
+}
+
+bool DeviceReconfigurationCoordinator::isPreferredDeviceAvailable(bool rescan) const
+{
+    for (auto* type : deviceManager.getAvailableDeviceTypes())
+    {
+        if (type->getTypeName() != preferredType)
+            continue;
+
+        if (rescan)
+            type->scanForDevices();
+
+        const juce::StringArray outputs = type->getDeviceNames(false);
+        const juce::StringArray inputs = type->getDeviceNames(true);
+
+        return (preferredSetup.outputDeviceName.isEmpty() || outputs.contains(preferredSetup.outputDeviceName))
+            && (preferredSetup.inputDeviceName.isEmpty() || inputs.contains(preferredSetup.inputDeviceName));
+    }
+
+    return false;
+}
+
+void DeviceReconfigurationCoordinator::rememberCurrentDevice()
+{
+    auto* device = deviceManager.getCurrentAudioDevice();
+    if (device == nullptr)
+        return;
+
+    preferredType = deviceManager.getCurrentAudioDeviceType();
+    preferredSetup = deviceManager.getAudioDeviceSetup();
+    hasPreferred = true;
+
+    sampleRate = device->getCurrentSampleRate();
+    blockSize = device->getCurrentBufferSizeSamples();
+
+    if (onDeviceChosen != nullptr)
+        onDeviceChosen();
+}
+
+void DeviceReconfigurationCoordinator::switchToFallback()
+{
+    juce::Logger::writeToLog("Audio device " + preferredSetup.outputDeviceName + " lost, using the virtual device");
+
+    // Same format as before, so the plugins only see a re-prepare
+    juce::AudioDeviceManager::AudioDeviceSetup fallback;
+    fallback.outputDeviceName = VirtualAudioIODeviceType::defaultDeviceName;
+    fallback.inputDeviceName = VirtualAudioIODeviceType::defaultDeviceName;
+    fallback.sampleRate = sampleRate;
+    fallback.bufferSize = blockSize;
+
+    {
+        const juce::ScopedValueSetter<bool> switchingScope(switching, true);
+        deviceManager.setCurrentAudioDeviceType(VirtualAudioIODeviceType::typeName, false);
+
+        const juce::String error = deviceManager.setAudioDeviceSetup(fallback, false);
+        if (error.isNotEmpty())
+            juce::Logger::writeToLog("Cannot open the virtual device: " + error);
+    }
+
+    hostCallback.fadeIn();
+
+    const bool wasUsingFallback = usingFallback;
+    usingFallback = true;
+    startTimer(reconnectPollMs);
+
+    if (! wasUsingFallback && onFallbackChanged != nullptr)
+        onFallbackChanged();
+}
+
+void DeviceReconfigurationCoordinator::fadeOutAndWait()
+{
+    auto* device = deviceManager.getCurrentAudioDevice();
+    if (device == nullptr || ! device->isPlaying())
+        return;
+
+    hostCallback.fadeOut();
+
+    // A few blocks at most; a stalled device must not hang the message thread
+    const juce::uint32 deadline = juce::Time::getMillisecondCounter() + (juce::uint32) maxFadeWaitMs;
+    while (! hostCallback.isFadedOut() && juce::Time::getMillisecondCounter() < deadline)
+        juce::Thread::sleep(2);
+}
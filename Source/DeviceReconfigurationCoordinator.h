@@ -0,0 +1,77 @@
+//
+// DeviceReconfigurationCoordinator.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "HostAudioCallback.h"
+#include <functional>
+
+/**
+ * Keeps the chain running across audio device changes
+ *
+ * Changes made through applySetup() fade the output out first and fade back in once the
+ * device restarts; the plugin instances are only re-prepared, never rebuilt. Every device
+ * start fades in, including restarts caused by the audio settings dialog.
+ *
+ * When the chosen device disappears (a USB interface unplugged, a driver error) the host
+ * switches to the virtual device at the same sample rate and buffer size, so the chain keeps
+ * processing. The lost device is polled, and once it is back the host returns to it.
+ */
+class DeviceReconfigurationCoordinator : private juce::ChangeListener,
+                                         private juce::AsyncUpdater,
+                                         private juce::Timer
+{
+public:
+    DeviceReconfigurationCoordinator(juce::AudioDeviceManager& deviceManager, HostAudioCallback& callback);
+    ~DeviceReconfigurationCoordinator() override;
+
+    /** Starts watching the device manager; call once it has been initialised */
+    void start();
+
+    /** Fades out, applies the setup on the given device type (current one if empty) and fades back in */
+    juce::String applySetup(const juce::AudioDeviceManager::AudioDeviceSetup& setup, const juce::String& typeName = {});
+
+    /** True while the virtual device stands in for a lost one */
+    bool isUsingFallback() const noexcept              { return usingFallback; }
+    juce::String getLostDeviceName() const             { return preferredSetup.outputDeviceName; }
+
+    /** The format of the last device that ran, for creating plugins while no device is open */
+    double getSampleRate() const noexcept              { return sampleRate; }
+    int getBlockSize() const noexcept                  { return blockSize; }
+
+    /** Called on the message thread when the fallback starts or ends */
+    std::function<void()> onFallbackChanged;
+
+    /** Called when a device the user chose starts running - never for the fallback */
+    std::function<void()> onDeviceChosen;
+
+private:
+    void changeListenerCallback(juce::ChangeBroadcaster*) override;
+    void handleAsyncUpdate() override;
+    void timerCallback() override;
+
+    void checkDevice(bool rescan);
+    bool isPreferredDeviceAvailable(bool rescan) const;
+    void rememberCurrentDevice();
+    void switchToFallback();
+    void fadeOutAndWait();
+
+    juce::AudioDeviceManager& deviceManager;
+    HostAudioCallback& hostCallback;
+
+    juce::String preferredType;
+    juce::AudioDeviceManager::AudioDeviceSetup preferredSetup;
+    bool hasPreferred = false;
+    bool usingFallback = false;
+    bool switching = false;
+
+    double sampleRate = 44100.0;
+    int blockSize = 512;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeviceReconfigurationCoordinator)
+};
@@ -0,0 +1,274 @@
+//
+// DiskRecorder.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "DiskRecorder.h"
+#include <thread>
+
+namespace
+{
+    // Seconds of audio each ring buffer can hold before the audio thread starts dropping blocks
+    const int ringBufferSeconds = 4;
+
+    // Largest block handed to the encoder at once
+    const int writerBlockSize = 16384;
+
+    // Output streams flush in chunks of this size, keeping file writes large and few
+    const size_t fileWriteBufferSize = 1 << 20;
+
+    // FLAC streams cannot carry more than this many channels
+    const int maxFlacChannels = 8;
+}
+
+DiskRecorder::DiskRecorder()
+    : juce::Thread("Nova Host Disk Recorder")
+{
+}
+
+DiskRecorder::~DiskRecorder()
+{
+    cancelPendingUpdate();
+    stop();
+}
+
+juce::File DiskRecorder::getDefaultDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userMusicDirectory).getChildFile("Nova Host Recordings");
+}
+
+bool DiskRecorder::start(const juce::File& directory, Format format,
+                         double sampleRate, int numInputChannels, int numOutputChannels,
+                         juce::String& errorMessage)
+{
+    jassert(juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    // An interrupted recording is disarmed but its writer may still be running on the old files
+    if (isRecording() || isThreadRunning())
+        stop();
+
+    if (sampleRate <= 0.0)
+    {
+        errorMessage = "No audio device is running";
+        return false;
+    }
+
+    const juce::Result dirResult = directory.createDirectory();
+    if (dirResult.failed())
+    {
+        errorMessage = "Could not create " + directory.getFullPathName() + ": " + dirResult.getErrorMessage();
+        return false;
+    }
+
+    const juce::String baseName = "NovaHost " + juce::Time::getCurrentTime().formatted("%Y-%m-%d %H-%M-%S");
+    const juce::String extension = (format == Format::flac) ? ".flac" : ".wav";
+
+    if (! openStream(input, directory.getNonexistentChildFile(baseName + " input", extension, false),
+                     format, sampleRate, numInputChannels, errorMessage)
+        || ! openStream(output, directory.getNonexistentChildFile(baseName + " output", extension, false),
+                        format, sampleRate, numOutputChannels, errorMessage))
+    {
+        closeStream(input);
+        closeStream(output);
+        return false;
+    }
+
+    recordingSampleRate = sampleRate;
+    overruns.store(0);
+    droppedSamples.store(0);
+    lastReportedOverruns = 0;
+
+    startThread(juce::Thread::Priority::high);
+
+    // Only now let the audio thread see the buffers
+    armed.store(true);
+
+    juce::Logger::writeToLog("Recording started: " + input.file.getFullPathName()
+                             + ", " + output.file.getFullPathName());
+    return true;
+}
+
+void DiskRecorder::stop()
+{
+    const bool wasRunning = isThreadRunning();
+    armed.store(false);
+
+    // Wait for any push that saw the old armed state to finish before touching the rings. This
+    // store-then-load, and the push's increment-then-load, need sequential consistency: with
+    // release/acquire both sides could read the other's old value
+    while (activePushes.load() != 0)
+        std::this_thread::yield();
+
+    signalThreadShouldExit();
+    notify();
+    waitForThreadToExit(-1);
+
+    closeStream(input);
+    closeStream(output);
+
+    if (wasRunning)
+        juce::Logger::writeToLog("Recording stopped with " + juce::String(getNumOverruns()) + " overruns ("
+                                 + juce::String(getNumDroppedSamples()) + " samples dropped)");
+}
+
+bool DiskRecorder::openStream(Stream& stream, const juce::File& file, Format format,
+                              double sampleRate, int numChannels, juce::String& errorMessage)
+{
+    numChannels = juce::jmax(1, numChannels);
+
+    if (format == Format::flac && numChannels > maxFlacChannels)
+    {
+        juce::Logger::writeToLog("FLAC supports at most " + juce::String(maxFlacChannels)
+                                 + " channels, recording " + file.getFileName() + " as WAV instead");
+        format = Format::wav;
+    }
+
+    juce::File target = (format == Format::wav) ? file.withFileExtension(".wav") : file;
+    auto fileStream = std::make_unique<juce::FileOutputStream>(target, fileWriteBufferSize);
+
+    if (fileStream->failedToOpen())
+    {
+        errorMessage = "Could not open " + target.getFullPathName() + " for writing";
+        return false;
+    }
+
+    std::unique_ptr<juce::AudioFormat> audioFormat;
+    int bitsPerSample = 32;
+
+    #if JUCE_USE_FLAC
+    if (format == Format::flac)
+    {
+        audioFormat = std::make_unique<juce::FlacAudioFormat>();
+        bitsPerSample = 24;
+    }
+    #endif
+
+    if (audioFormat == nullptr)
+        audioFormat = std::make_unique<juce::WavAudioFormat>();
+
+    std::unique_ptr<juce::AudioFormatWriter> writer(audioFormat->createWriterFor(fileStream.get(), sampleRate,
+                                                                                  (unsigned int) numChannels,
+                                                                                  bitsPerSample, {}, 0));
+
+    if (writer == nullptr)
+    {
+        errorMessage = "Could not create a " + audioFormat->getFormatName() + " writer for " + target.getFileName();
+        fileStream.reset();
+        target.deleteFile();
+        return false;
+    }
+
+    // The writer owns the stream from here on
+    fileStream.release();
+
+    stream.file = target;
+    stream.writer = std::move(writer);
+    stream.ring.allocate(numChannels, (int) (sampleRate * ringBufferSeconds));
+    stream.scratch.setSize(numChannels, writerBlockSize);
+    return true;
+}
+
+void DiskRecorder::closeStream(Stream& stream)
+{
+    // Destroying the writer finalises the header and flushes the file
+    stream.writer.reset();
+    stream.ring.release();
+    stream.scratch.setSize(1, 1);
+}
+
+int DiskRecorder::drainStream(Stream& stream)
+{
+    if (stream.writer == nullptr)
+        return 0;
+
+    int totalWritten = 0;
+
+    while (stream.ring.getNumReady() > 0)
+    {
+        const int numRead = stream.ring.pop(stream.scratch, writerBlockSize);
+
+        if (! stream.writer->writeFromAudioSampleBuffer(stream.scratch, 0, numRead))
+        {
+            juce::Logger::writeToLog("Recorder write failed for " + stream.file.getFullPathName());
+            stream.ring.skip(stream.ring.getNumReady());
+            break;
+        }
+
+        totalWritten += numRead;
+    }
+
+    return totalWritten;
+}
+
+void DiskRecorder::run()
+{
+    while (! threadShouldExit())
+    {
+        const int numWritten = drainStream(input) + drainStream(output);
+
+        const int currentOverruns = overruns.load(std::memory_order_relaxed);
+        if (currentOverruns != lastReportedOverruns)
+        {
+            juce::Logger::writeToLog("Recorder overrun: " + juce::String(currentOverruns - lastReportedOverruns)
+                                     + " block(s) dropped, " + juce::String(getNumDroppedSamples())
+                                     + " samples lost in total");
+            lastReportedOverruns = currentOverruns;
+        }
+
+        // Nothing queued, so let the buffers fill up a bit before the next pass
+        if (numWritten == 0)
+            wait(10);
+    }
+
+    // Flush whatever the audio thread queued before it was disarmed
+    while (drainStream(input) + drainStream(output) > 0) {}
+}
+
+void DiskRecorder::pushBlock(Stream& stream, const float* const* data, int numChannels, int numSamples) noexcept
+{
+    if (! armed.load())
+        return;
+
+    activePushes.fetch_add(1);
+
+    // Re-check now that stop() is guaranteed to wait for us
+    if (armed.load() && ! stream.ring.push(data, numChannels, numSamples))
+    {
+        overruns.fetch_add(1, std::memory_order_relaxed);
+        droppedSamples.fetch_add(numSamples, std::memory_order_relaxed);
+    }
+
+    activePushes.fetch_sub(1);
+}
+
+void DiskRecorder::tapAboutToStart(double sampleRate, int, int)
+{
+    // A file can only have one sample rate, so stop feeding it if the device changed underneath us
+    if (isRecording() && sampleRate != recordingSampleRate)
+    {
+        armed.store(false);
+        juce::Logger::writeToLog("Recording interrupted: device sample rate changed from "
+                                 + juce::String(recordingSampleRate) + " to " + juce::String(sampleRate));
+
+        // Finalise the interrupted files on the message thread, where start() and stop() run
+        triggerAsyncUpdate();
+    }
+}
+
+void DiskRecorder::handleAsyncUpdate()
+{
+    if (! isRecording())
+        stop();
+}
+
+void DiskRecorder::tapInput(const float* const* data, int numChannels, int numSamples) noexcept
+{
+    pushBlock(input, data, numChannels, numSamples);
+}
+
+void DiskRecorder::tapOutput(const float* const* data, int numChannels, int numSamples) noexcept
+{
+    pushBlock(output, data, numChannels, numSamples);
+}
@@ -0,0 +1,92 @@
+//
+// DiskRecorder.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AudioRingBuffer.h"
+#include "HostAudioCallback.h"
+#include <atomic>
+#include <memory>
+
+/**
+ * Records the device input and the processed chain output to disk
+ * The audio thread only copies blocks into preallocated ring buffers; a background
+ * thread drains them and does all encoding and file I/O
+ */
+class DiskRecorder : public HostAudioTap,
+                     private juce::Thread,
+                     private juce::AsyncUpdater
+{
+public:
+    enum class Format
+    {
+        wav = 0,
+        flac
+    };
+
+    DiskRecorder();
+    ~DiskRecorder() override;
+
+    /**
+     * Creates the output files and starts recording (message thread)
+     * Returns false and fills in errorMessage if the files could not be created
+     */
+    bool start(const juce::File& directory, Format format,
+               double sampleRate, int numInputChannels, int numOutputChannels,
+               juce::String& errorMessage);
+
+    /** Stops recording, flushes everything still queued and closes the files (message thread) */
+    void stop();
+
+    bool isRecording() const noexcept        { return armed.load(); }
+
+    /** Number of blocks that were dropped because the writer could not keep up */
+    int getNumOverruns() const noexcept      { return overruns.load(std::memory_order_relaxed); }
+
+    /** Total number of sample frames lost to overruns */
+    juce::int64 getNumDroppedSamples() const noexcept { return droppedSamples.load(std::memory_order_relaxed); }
+
+    juce::File getInputFile() const          { return input.file; }
+    juce::File getOutputFile() const         { return output.file; }
+
+    /** Default folder used when the user has not configured one */
+    static juce::File getDefaultDirectory();
+
+    // HostAudioTap
+    void tapAboutToStart(double sampleRate, int numInputChannels, int numOutputChannels) override;
+    void tapInput(const float* const* data, int numChannels, int numSamples) noexcept override;
+    void tapOutput(const float* const* data, int numChannels, int numSamples) noexcept override;
+
+private:
+    struct Stream
+    {
+        juce::File file;
+        AudioRingBuffer ring;
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+        juce::AudioBuffer<float> scratch;
+    };
+
+    void run() override;
+    void handleAsyncUpdate() override;
+    bool openStream(Stream& stream, const juce::File& file, Format format,
+                    double sampleRate, int numChannels, juce::String& errorMessage);
+    int drainStream(Stream& stream);
+    void closeStream(Stream& stream);
+    void pushBlock(Stream& stream, const float* const* data, int numChannels, int numSamples) noexcept;
+
+    Stream input, output;
+    double recordingSampleRate = 0.0;
+
+    std::atomic<bool> armed { false };
+    std::atomic<int> activePushes { 0 };
+    std::atomic<int> overruns { 0 };
+    std::atomic<juce::int64> droppedSamples { 0 };
+    int lastReportedOverruns = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DiskRecorder)
+};
@@ -0,0 +1,120 @@
+//
+// HostAudioCallback.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "HostAudioCallback.h"
+
+HostAudioCallback::HostAudioCallback(juce::AudioProcessorPlayer& playerToUse)
+    : player(playerToUse)
+{
+}
+
+void HostAudioCallback::addTap(HostAudioTap* tap)
+{
+    jassert(tap != nullptr);
+    taps.push_back(tap);
+}
+
+void HostAudioCallback::addPath(HostAudioPath* path)
+{
+    jassert(path != nullptr);
+    paths.push_back(path);
+}
+
+void HostAudioCallback::audioDeviceIOCallbackWithContext(const float* const* inputChannelData,
+                                                         int numInputChannels,
+                                                         float* const* outputChannelData,
+                                                         int numOutputChannels,
+                                                         int numSamples,
+                                                         const juce::AudioIODeviceCallbackContext& context)
+{
+    // Some drivers hand us aliased input/output buffers, so capture the input first
+    for (auto* tap : taps)
+        tap->tapInput(inputChannelData, numInputChannels, numSamples);
+
+    for (auto* path : paths)
+        path->pathInput(inputChannelData, numInputChannels, outputChannelData, numOutputChannels, numSamples);
+
+    player.audioDeviceIOCallbackWithContext(inputChannelData, numInputChannels,
+                                            outputChannelData, numOutputChannels,
+                                            numSamples, context);
+
+    for (auto* path : paths)
+        path->pathOutput(inputChannelData, numInputChannels, outputChannelData, numOutputChannels, numSamples);
+
+    // Taps see the faded signal, since that is what is heard
+    applyFade(outputChannelData, numOutputChannels, numSamples);
+
+    for (auto* tap : taps)
+        tap->tapOutput(outputChannelData, numOutputChannels, numSamples);
+}
+
+void HostAudioCallback::audioDeviceAboutToStart(juce::AudioIODevice* device)
+{
+    const int numInputs = device->getActiveInputChannels().countNumberOfSetBits();
+    const int numOutputs = device->getActiveOutputChannels().countNumberOfSetBits();
+
+    for (auto* tap : taps)
+        tap->tapAboutToStart(device->getCurrentSampleRate(), numInputs, numOutputs);
+
+    for (auto* path : paths)
+        path->pathAboutToStart(device->getCurrentSampleRate(), device->getCurrentBufferSizeSamples(), numInputs, numOutputs);
+
+    deviceSampleRate = device->getCurrentSampleRate();
+    if (fadeMilliseconds.load() * deviceSampleRate / 1000.0 >= 1.0)
+    {
+        currentGain = 0.0f;
+        targetGain.store(1.0f);
+    }
+
+    player.audioDeviceAboutToStart(device);
+}
+
+void HostAudioCallback::audioDeviceStopped()
+{
+    player.audioDeviceStopped();
+}
+
+void HostAudioCallback::audioDeviceError(const juce::String& errorMessage)
+{
+    juce::Logger::writeToLog("Audio device error: " + errorMessage);
+    player.audioDeviceError(errorMessage);
+
+    if (onDeviceError != nullptr)
+        onDeviceError(errorMessage);
+}
+
+void HostAudioCallback::applyFade(float* const* outputChannelData, int numOutputChannels, int numSamples) noexcept
+{
+    const float target = targetGain.load();
+
+    if (currentGain == target)
+    {
+        if (target == 0.0f)
+            for (int channel = 0; channel < numOutputChannels; channel++)
+                if (outputChannelData[channel] != nullptr)
+                    juce::FloatVectorOperations::clear(outputChannelData[channel], numSamples);
+
+        fadedOut.store(target == 0.0f);
+        return;
+    }
+
+    // Worked out per fade, so a fade time set after the device started still applies
+    const double fadeSamples = fadeMilliseconds.load(std::memory_order_relaxed) * deviceSampleRate / 1000.0;
+    const float gainStep = fadeSamples >= 1.0 ? (float) (1.0 / fadeSamples) : 1.0f;
+
+    for (int i = 0; i < numSamples; i++)
+    {
+        currentGain = target > currentGain ? juce::jmin(target, currentGain + gainStep)
+                                           : juce::jmax(target, currentGain - gainStep);
+
+        for (int channel = 0; channel < numOutputChannels; channel++)
+            if (outputChannelData[channel] != nullptr)
+                outputChannelData[channel][i] *= currentGain;
+    }
+
+    fadedOut.store(currentGain == 0.0f);
+}
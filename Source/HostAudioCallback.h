@@ -0,0 +1,110 @@
+//
+// HostAudioCallback.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+#include <functional>
+#include <vector>
+
+/**
+ * Something that observes the raw device input and the processed output
+ * The tap methods run on the audio thread and must not block, allocate or do I/O
+ */
+class HostAudioTap
+{
+public:
+    virtual ~HostAudioTap() = default;
+
+    /** Called before the device starts streaming - allocation is allowed here */
+    virtual void tapAboutToStart(double sampleRate, int numInputChannels, int numOutputChannels) = 0;
+
+    /** Called with the device input before the chain processes it */
+    virtual void tapInput(const float* const* data, int numChannels, int numSamples) noexcept = 0;
+
+    /** Called with the device output after the chain has processed it */
+    virtual void tapOutput(const float* const* data, int numChannels, int numSamples) noexcept = 0;
+};
+
+/**
+ * A second signal path computed in the same device callback as the chain
+ * It reads the device input buffers directly and writes output channels the chain leaves
+ * silent. Both methods run on the audio thread and must not block, allocate or do I/O.
+ */
+class HostAudioPath
+{
+public:
+    virtual ~HostAudioPath() = default;
+
+    /** Called before the device starts streaming - allocation and preparing plugins are allowed here */
+    virtual void pathAboutToStart(double sampleRate, int blockSize, int numInputChannels, int numOutputChannels) = 0;
+
+    /** Called before the chain runs, while the input is still intact even where a driver aliases it with the output */
+    virtual void pathInput(const float* const* input, int numInputChannels,
+                           float* const* output, int numOutputChannels, int numSamples) noexcept = 0;
+
+    /** Called once the chain has written the output, before the fade */
+    virtual void pathOutput(const float* const* input, int numInputChannels,
+                            float* const* output, int numOutputChannels, int numSamples) noexcept = 0;
+};
+
+/**
+ * The device callback the host registers with the AudioDeviceManager
+ * Forwards everything to the AudioProcessorPlayer and feeds the registered taps
+ */
+class HostAudioCallback : public juce::AudioIODeviceCallback
+{
+public:
+    explicit HostAudioCallback(juce::AudioProcessorPlayer& playerToUse);
+
+    /** Registers a tap - only call this before the callback is added to a device */
+    void addTap(HostAudioTap* tap);
+
+    /** Registers a path computed alongside the chain - only call this before the callback is added to a device */
+    void addPath(HostAudioPath* path);
+
+    /**
+     * Length of the output fades; 0, the default, disables them
+     * With fading on, every device start fades in from silence
+     */
+    void setFadeTime(double milliseconds) noexcept    { fadeMilliseconds.store(milliseconds); }
+
+    /** Ramps the output to silence, e.g. before the device is reconfigured */
+    void fadeOut() noexcept                            { targetGain.store(0.0f); }
+    void fadeIn() noexcept                             { targetGain.store(1.0f); }
+    bool isFadedOut() const noexcept                   { return fadedOut.load(); }
+
+    /** Called from whichever thread the device reports an error on */
+    std::function<void(const juce::String&)> onDeviceError;
+
+    void audioDeviceIOCallbackWithContext(const float* const* inputChannelData,
+                                          int numInputChannels,
+                                          float* const* outputChannelData,
+                                          int numOutputChannels,
+                                          int numSamples,
+                                          const juce::AudioIODeviceCallbackContext& context) override;
+
+    void audioDeviceAboutToStart(juce::AudioIODevice* device) override;
+    void audioDeviceStopped() override;
+    void audioDeviceError(const juce::String& errorMessage) override;
+
+private:
+    void applyFade(float* const* outputChannelData, int numOutputChannels, int numSamples) noexcept;
+
+    juce::AudioProcessorPlayer& player;
+    std::vector<HostAudioTap*> taps;
+    std::vector<HostAudioPath*> paths;
+
+    std::atomic<double> fadeMilliseconds { 0.0 };
+    std::atomic<float> targetGain { 1.0f };
+    std::atomic<bool> fadedOut { false };
+    float currentGain = 1.0f;   // audio thread only
+    double deviceSampleRate = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HostAudioCallback)
+};
@@ -3,6 +3,11 @@
 #include "SafePluginScanner.h"
 #include "SplashScreen.h"
 #include "GPUAccelerationManager.h"
+#include "ChainBenchmark.h"
+#include "RegressionHarness.h"
+#include "ScannerBenchmark.h"
+#include "ShutdownWatchdog.h"
+#include "StressHarness.h"
 
 #if ! (JUCE_PLUGINHOST_VST || JUCE_PLUGINHOST_VST3 || JUCE_PLUGINHOST_AU)
  #error "If you're building the plugin host, you probably want to enable VST and/or AU support"
@@ -15,6 +20,63 @@ public:
 
     void initialise(const String& commandLine) override
     {
+        // Headless benchmark mode - no tray icon, no audio device, report on stdout
+        StringArray benchmarkChain = getOption("-benchmark-chain");
+        if (benchmarkChain.size() == 2)
+        {
+            setApplicationReturnValue(ChainBenchmark::run(benchmarkChain[1].getIntValue()));
+            quit();
+            return;
+        }
+
+        StringArray benchmarkScanner = getOption("-benchmark-scanner");
+        if (benchmarkScanner.size() == 2)
+        {
+            // Without "=" there is no test plugin folder
+            String testPlugins = benchmarkScanner[1];
+            setApplicationReturnValue(ScannerBenchmark::run(testPlugins.isEmpty() ? File()
+                                                                                : File::getCurrentWorkingDirectory().getChildFile(testPlugins)));
+            quit();
+            return;
+        }
+
+        // The stress test needs the message loop, so it finishes asynchronously
+        StringArray stressTest = getOption("-stress-test");
+        if (stressTest.size() == 2)
+        {
+            StringArray testPlugins = getOption("-test-plugins");
+            File testPluginDirectory = File::getCurrentWorkingDirectory().getChildFile(testPlugins.size() == 2 ? testPlugins[1]
+                                                                                                               : String("TestPlugins/build"));
+            double minutes = stressTest[1].getDoubleValue();
+
+            stressHarness = std::make_unique<StressHarness>(testPluginDirectory, minutes);
+            stressHarness->onFinished = [this](int result)
+            {
+                setApplicationReturnValue(result);
+                quit();
+            };
+
+            if (! stressHarness->start())
+            {
+                setApplicationReturnValue(1);
+                quit();
+            }
+            return;
+        }
+
+        StringArray regression = getOption("-regression");
+        if (regression.size() == 2 && regression[1].isNotEmpty())
+        {
+            StringArray report = getOption("-report");
+            File reportFile = report.size() == 2 ? File::getCurrentWorkingDirectory().getChildFile(report[1])
+                                                 : File::getCurrentWorkingDirectory().getChildFile("regression-report.json");
+
+            setApplicationReturnValue(RegressionHarness::run(File::getCurrentWorkingDirectory().getChildFile(regression[1]),
+                                                             reportFile, getOption("-update-golden").size() == 2));
+            quit();
+            return;
+        }
+
         // Enable high-DPI support on all platforms
         #if JUCE_WINDOWS
         Desktop::getInstance().setGlobalScaleFactor(1.0);
@@ -36,9 +98,30 @@ public:
         appProperties = std::make_unique<ApplicationProperties>();
         appProperties->setStorageParameters(options);
 
+        // Remember the requested audio backend so it survives restarts without the flag
+        StringArray jackClient = getOption("-jack-client");
+        if (jackClient.size() == 2)
+            appProperties->getUserSettings()->setValue("preferJackClient", jackClient[1] != "off");
+
         LookAndFeel::setDefaultLookAndFeel(&lookAndFeel);
 
-        mainWindow = std::make_unique<IconMenu>();
+        // A session file replaces the saved chain and is applied again whenever it is saved
+        File sessionFile;
+        StringArray session = getOption("-session");
+        if (session.size() == 2)
+        {
+            String path = session[1];
+            if (path.isEmpty())
+            {
+                // "--session FILE" as well as "-session=FILE"
+                const StringArray parameters = getCommandLineParameters();
+                path = parameters[parameters.indexOf(session[0]) + 1];
+            }
+            if (path.isNotEmpty())
+                sessionFile = File::getCurrentWorkingDirectory().getChildFile(path.unquoted());
+        }
+
+        mainWindow = std::make_unique<IconMenu>(sessionFile);
         #if JUCE_MAC
             Process::setDockIconVisible(false);
         #endif
@@ -46,6 +129,13 @@ public:
 
     void shutdown() override
     {
+        // A plugin that hangs while quitting cannot keep the process alive past the deadline
+        ShutdownWatchdog watchdog(appProperties != nullptr ? appProperties->getUserSettings()->getDoubleValue("shutdownDeadlineSeconds", 5.0)
+                                                           : 5.0);
+
+        stressHarness = nullptr;
+        if (mainWindow != nullptr)
+            mainWindow->shutDown(watchdog);
         mainWindow = nullptr;
         appProperties = nullptr;
         LookAndFeel::setDefaultLookAndFeel(nullptr);
@@ -72,6 +162,7 @@ public:
 
 private:
     std::unique_ptr<IconMenu> mainWindow;
+    std::unique_ptr<StressHarness> stressHarness;
     std::unique_ptr<DialogWindow> splashWindow;
     
     // Initialize GPU acceleration for the application
@@ -149,6 +240,23 @@ private:
         return found;
     }
 
+    /**
+     * Finds "-name", "--name" or "-name=value" exactly, unlike getParameter's substring match
+     * Returns the argument as given and its value, which is empty without "="
+     */
+    StringArray getOption(const String& name) {
+        const StringArray parameters = JUCEApplication::getCommandLineParameters();
+        for (const auto& param : parameters)
+        {
+            const String flag = param.startsWith("--") ? param.substring(1) : param;
+            if (flag == name)
+                return { param, String() };
+            if (flag.startsWith(name + "="))
+                return { param, flag.fromFirstOccurrenceOf("=", false, false) };
+        }
+        return {};
+    }
+
     void checkArguments(PropertiesFile::Options *options) {
         StringArray multiInstance = getParameter("-multi-instance");
         if (multiInstance.size() == 2)
@@ -8,9 +8,14 @@
 
 #include <JuceHeader.h>
 #include "IconMenu.hpp"
+#include "AggregateAudioDevice.h"
+#include "ChainBuilder.h"
+#include "JackClientDevice.h"
 #include "PluginWindow.h"
 #include "SafePluginScanner.h"
 #include "SplashScreen.h"
+#include "VirtualAudioDevice.h"
+#include <algorithm>
 #include <ctime>
 #include <limits>
 #include <climits> // For INT_MAX
@@ -77,8 +82,8 @@ private:
     IconMenu& owner;
 };
 
-IconMenu::IconMenu() : INDEX_EDIT(1000000), INDEX_BYPASS(2000000), INDEX_DELETE(3000000), INDEX_MOVE_UP(4000000), INDEX_MOVE_DOWN(5000000),
-                       menuIconLeftClicked(false), inputNode(nullptr), outputNode(nullptr)
+IconMenu::IconMenu(const juce::File& sessionFileToLoad) : INDEX_EDIT(1000000), INDEX_BYPASS(2000000), INDEX_DELETE(3000000), INDEX_MOVE_UP(4000000), INDEX_MOVE_DOWN(5000000), INDEX_MIDI(6000000), INDEX_SIDECHAIN(7000000),
+                       menuIconLeftClicked(false), hostCallback(player), controllerMapper(midiRouter, graph), modulationEngine(graph), snapshotMorpher(graph), deviceCoordinator(deviceManager, hostCallback), inputNode(nullptr), outputNode(nullptr), sessionFile(sessionFileToLoad)
 {
     // Initialization with explicit format registration rather than just defaults
     // This ensures all available plugin formats are supported
@@ -109,14 +114,81 @@ IconMenu::IconMenu() : INDEX_EDIT(1000000), INDEX_BYPASS(2000000), INDEX_DELETE(
     x = y = 0;
     #endif
     
+    // Taps must be registered before the callback is attached to a device
+    hostCallback.addTap(&recorder);
+    hostCallback.addTap(&captureHistory);
+    hostCallback.addTap(&midiRouter);
+    hostCallback.addTap(&controllerMapper);     // after the router, whose MIDI it reads
+    hostCallback.addTap(&modulationEngine);
+    hostCallback.addTap(&snapshotMorpher);
+    hostCallback.addTap(&analyzer);
+    hostCallback.addPath(&monitorPath);
+    monitorPath.setOutputChannel(getAppProperties().getUserSettings()->getIntValue("monitorOutputChannel", -1));
+    applyCaptureHistorySettings();
+    
+    applyMemoryBudgetSettings();
+    memoryMonitor.onOverBudget = [this] { handleMemoryOverBudget(); };
+    
+    if (auto savedCosts = std::unique_ptr<juce::XmlElement>(getAppProperties().getUserSettings()->getXmlValue("pluginCostModel")))
+        costModel->restoreFromXml(*savedCosts);
+    costModel->setChainToWatch(&linearChain);
+    
+    // Controller mappings find their parameters once the chain is loaded
+    if (auto savedMappings = std::unique_ptr<juce::XmlElement>(getAppProperties().getUserSettings()->getXmlValue("controllerMappings")))
+        controllerMapper.restoreFromXml(*savedMappings);
+    controllerMapper.setOscPort(getAppProperties().getUserSettings()->getIntValue("oscPort", 0));
+    if (auto savedModulation = std::unique_ptr<juce::XmlElement>(getAppProperties().getUserSettings()->getXmlValue("modulation")))
+        modulationEngine.restoreFromXml(*savedModulation);
+    if (auto savedSnapshots = std::unique_ptr<juce::XmlElement>(getAppProperties().getUserSettings()->getXmlValue("parameterSnapshots")))
+        snapshotMorpher.restoreFromXml(*savedSnapshots);
+    
+    // Read the saved chain's plugin files ahead while the device and plugin lists load
+    if (auto savedChain = std::unique_ptr<juce::XmlElement>(getAppProperties().getUserSettings()->getXmlValue("pluginListActive")))
+    {
+        juce::KnownPluginList chainList;
+        chainList.recreateFromXml(*savedChain);
+        prefetcher.prefetch(chainList.getTypes());
+    }
+    
     // Audio device initialization
     startAudioDevice();
     
     // Plugins - load on a background thread to avoid UI stutter on startup
     juce::Thread::launch([this] {
         loadAllPluginLists();
-        juce::MessageManager::callAsync([this] { 
-            loadActivePlugins();
+        
+        // A session is checked in full and its plugin files read ahead before anything is replaced
+        auto session = std::make_shared<Session>();
+        juce::StringArray sessionErrors;
+        const bool sessionValid = sessionFile != juce::File() && Session::load(sessionFile, knownPluginList, *session, sessionErrors);
+        if (sessionValid)
+        {
+            juce::Array<juce::PluginDescription> sessionPlugins;
+            for (const auto& plugin : session->plugins)
+                sessionPlugins.add(plugin.plugin);
+            prefetcher.prefetch(sessionPlugins);
+        }
+        
+        juce::MessageManager::callAsync([this, session, sessionValid, sessionErrors] { 
+            if (sessionValid)
+                applySession(*session);
+            else
+            {
+                // The saved chain stands in for a session that cannot be used
+                if (! sessionErrors.isEmpty())
+                    reportSessionErrors(sessionErrors);
+                loadActivePlugins();
+            }
+            
+            if (sessionFile != juce::File())
+            {
+                sessionWatcher.onChanged = [this] { reloadSession(); };
+                sessionWatcher.watch(sessionFile);
+            }
+            
+            prefetcher.cancel();
+            juce::Logger::writeToLog("Prefetched " + juce::String(prefetcher.getNumFilesPrefetched()) + " plugin files ("
+                                     + PluginMemoryMonitor::formatBytes(prefetcher.getBytesPrefetched()) + ")");
             setIcon();
             setIconTooltip(juce::JUCEApplication::getInstance()->getApplicationName());
         });
@@ -131,18 +203,61 @@ void IconMenu::startAudioDevice()
     const int defaultNumInputChannels = 2;
     const int defaultNumOutputChannels = 2;
     
+    // Offer our own device types alongside the platform backends. The built-in types have to
+    // be created first, otherwise the device manager would skip them once ours are registered
+    auto* settings = getAppProperties().getUserSettings();
+    deviceManager.getAvailableDeviceTypes();
+    deviceManager.addAudioDeviceType(std::make_unique<VirtualAudioIODeviceType>());
+
+    #if NOVAHOST_JACK_CLIENT
+    deviceManager.addAudioDeviceType(std::make_unique<JackClientAudioIODeviceType>(
+        juce::JUCEApplication::getInstance()->getApplicationName(), "chain",
+        settings->getIntValue("jackChannelsPerChain", 2),
+        settings->getBoolValue("jackAutoConnect", true)));
+    #endif
+
+    // Registered last so it can pair up devices from every other type
+    deviceManager.addAudioDeviceType(std::make_unique<AggregateAudioIODeviceType>(deviceManager));
+    
     // Initialize device manager with conservative settings first
     deviceManager.initialise(defaultNumInputChannels, defaultNumOutputChannels, 
                              savedAudioState.get(), true, {}, nullptr);
     
+    #if NOVAHOST_JACK_CLIENT
+    if (settings->getBoolValue("preferJackClient", false))
+        deviceManager.setCurrentAudioDeviceType(JackClientAudioIODeviceType::typeName, true);
+    #endif
+    
     // Set up graph processor and player
     player.setProcessor(&graph);
-    deviceManager.addAudioCallback(&player);
+    deviceManager.addAudioCallback(&hostCallback);
+    
+    // Every enabled MIDI input feeds the router; the saved state already says which are enabled
+    deviceManager.addMidiInputDeviceCallback({}, &midiRouter);
+    
+    // Device changes re-prepare the chain in place, and a lost device falls back to the virtual one
+    deviceCoordinator.onDeviceChosen = [this] { saveAudioDeviceState(); };
+    deviceCoordinator.onFallbackChanged = [this]
+    {
+        const juce::String appName = juce::JUCEApplication::getInstance()->getApplicationName();
+        setIconTooltip(deviceCoordinator.isUsingFallback() ? appName + " - " + deviceCoordinator.getLostDeviceName() + " disconnected"
+                                                           : appName);
+    };
+    deviceCoordinator.start();
+}
+
+void IconMenu::saveAudioDeviceState()
+{
+    if (auto state = deviceManager.createStateXml())
+    {
+        getAppProperties().getUserSettings()->setValue("audioDeviceState", state.get());
+        getAppProperties().getUserSettings()->saveIfNeeded();
+    }
 }
 
 void IconMenu::loadAllPluginLists()
 {
-    std::unique_lock<std::mutex> lock(pluginLoadMutex);
+    std::unique_lock<ProfiledMutex> lock(pluginLoadMutex);
     
     // Plugins - all available
     auto savedPluginList = std::unique_ptr<juce::XmlElement>(getAppProperties().getUserSettings()->getXmlValue("pluginList"));
@@ -150,6 +265,7 @@ void IconMenu::loadAllPluginLists()
         knownPluginList.recreateFromXml(*savedPluginList);
     pluginSortMethod = juce::KnownPluginList::sortByManufacturer;
     knownPluginList.addChangeListener(this);
+    searchIndex.update(knownPluginList.getTypes());
     
     // Plugins - active in chain
     auto savedPluginListActive = std::unique_ptr<juce::XmlElement>(getAppProperties().getUserSettings()->getXmlValue("pluginListActive"));
@@ -161,11 +277,55 @@ void IconMenu::loadAllPluginLists()
 IconMenu::~IconMenu()
 {
     // Properly shut down audio to prevent crashes on exit
-    deviceManager.removeAudioCallback(&player);
+    deviceManager.removeMidiInputDeviceCallback({}, &midiRouter);
+    deviceManager.removeAudioCallback(&hostCallback);
     player.setProcessor(nullptr);
+    recorder.stop();
     
     // Save any plugin states before destruction
+    if (! hasShutDown)
+        savePluginStates();
+    
+    // A scan measurement may still hold the cost model, but it must not look at the chain any more
+    costModel->setChainToWatch(nullptr);
+    
+    // Editors go before the plugins they show
+    PluginWindow::closeAllCurrentlyOpenWindows();
+}
+
+void IconMenu::shutDown(const ShutdownWatchdog& watchdog)
+{
+    if (hasShutDown)
+        return;
+    hasShutDown = true;
+    
+    // Silence first, so whatever happens next cannot click
+    if (auto* device = deviceManager.getCurrentAudioDevice(); device != nullptr && device->isPlaying())
+    {
+        hostCallback.fadeOut();
+        const juce::uint32 fadeDeadline = juce::Time::getMillisecondCounter() + 200;
+        while (! hostCallback.isFadedOut() && juce::Time::getMillisecondCounter() < fadeDeadline)
+            juce::Thread::sleep(2);
+    }
+    
+    deviceManager.removeMidiInputDeviceCallback({}, &midiRouter);
+    deviceManager.removeAudioCallback(&hostCallback);
+    player.setProcessor(nullptr);
+    recorder.stop();
+    PluginWindow::closeAllCurrentlyOpenWindows();
+    
+    // Half of what is left for reading the states; a slow plugin keeps its last saved state
+    const PluginStateCapture::Result captured = PluginStateCapture::captureAll(graph, watchdog.getSecondsLeft() * 0.5);
+    for (const auto& [plugin, state] : captured.states)
+        getAppProperties().getUserSettings()->setValue(getKey("state", plugin), state);
+    
+    // The settings file is replaced through a temporary file, so the copy on disk is never half written
     savePluginStates();
+    
+    // Deleting a plugin whose capture is still running would crash, and waiting could hang; everything
+    // else is saved by now, so this is still a clean quit
+    if (! captured.unfinished.isEmpty())
+        ShutdownWatchdog::exitNow("Exiting without unloading plugins still saving their state: " + captured.unfinished.joinIntoString(", "), 0);
 }
 
 void IconMenu::setIcon()
@@ -195,127 +355,797 @@ void IconMenu::setIcon()
     #endif
 }
 
-void IconMenu::loadActivePlugins()
+void IconMenu::loadActivePlugins(const juce::StringArray& pluginsToKeep)
 {
-    const int INPUT_NODE_ID = 1000000;
-    const int OUTPUT_NODE_ID = INPUT_NODE_ID + 1;
-    const int CHANNEL_ONE = 0;
-    const int CHANNEL_TWO = 1;
-    
     PluginWindow::closeAllCurrentlyOpenWindows();
-    graph.clear();
     
-    // Create input/output nodes using proper API for current JUCE version
-    inputNode = graph.addNode(std::make_unique<juce::AudioProcessorGraph::AudioGraphIOProcessor>(
-        juce::AudioProcessorGraph::AudioGraphIOProcessor::audioInputNode)).get();
+    // Detach whichever engine is playing before its processors are deleted
+    player.setProcessor(nullptr);
+    
+    std::vector<ChainEntry> entries;
+    
+    {
+        // Lock to prevent concurrent access to plugin list during load
+        std::lock_guard<ProfiledMutex> lock(pluginLoadMutex);
+        int pluginTime = 0;
+        
+        for (int i = 1; i <= activePluginList.getNumTypes(); i++)
+        {
+            ChainEntry entry;
+            entry.plugin = getNextPluginOlderThanTime(pluginTime);
+            entry.state = getAppProperties().getUserSettings()->getValue(getKey("state", entry.plugin));
+            entry.bypass = getAppProperties().getUserSettings()->getBoolValue(getKey("bypass", entry.plugin), false);
+            entry.midiRoute = getMidiRoute(entry.plugin);
+            entry.sidechain = SidechainSource::fromString(getAppProperties().getUserSettings()->getValue(getKey("sidechain", entry.plugin)));
+            entry.rateDivisor = getAppProperties().getUserSettings()->getIntValue(getKey("rate", entry.plugin), 1);
+            entries.push_back(entry);
+        }
+    }
+    
+    // Create plugins at the device format - the graph is not necessarily the engine being played
+    double sampleRate = deviceCoordinator.getSampleRate();
+    int blockSize = deviceCoordinator.getBlockSize();
+    if (auto* device = deviceManager.getCurrentAudioDevice())
+    {
+        sampleRate = device->getCurrentSampleRate();
+        blockSize = device->getCurrentBufferSizeSamples();
+        
+        // Input sidechains connect to device channels beyond the first pair, so the input node needs them all
+        graph.setPlayConfigDetails(device->getActiveInputChannels().countNumberOfSetBits(),
+                                   device->getActiveOutputChannels().countNumberOfSetBits(), sampleRate, blockSize);
+    }
     
-    outputNode = graph.addNode(std::make_unique<juce::AudioProcessorGraph::AudioGraphIOProcessor>(
-        juce::AudioProcessorGraph::AudioGraphIOProcessor::audioOutputNode)).get();
+    ChainBuilder builder(formatManager);
+    builder.setMemoryMonitor(&memoryMonitor);
+    builder.setMidiRouter(&midiRouter);
+    builder.setPluginsToKeep(pluginsToKeep);
+    controllerMapper.detachParameters();
+    modulationEngine.detachParameters();
+    snapshotMorpher.stop();
+    monitorPath.clear();
+    const ChainBuilder::Result chain = builder.build(entries, graph, linearChain, sampleRate, blockSize);
+    controllerMapper.attachParameters();
+    modulationEngine.attachParameters();
+    inputNode = chain.inputNode;
+    outputNode = chain.outputNode;
+    analyzerTapNode = {};
+    attachAnalyzer();
+    buildMonitorPath();
     
-    // Default passthrough connection when no plugins are active
-    if (activePluginList.getNumTypes() == 0)
+    // A plain serial chain runs in place on the linear engine; the graph stays the fallback
+    usingLinearChain = chain.isPureChain && getAppProperties().getUserSettings()->getBoolValue("linearChainEngine", true);
+    player.setProcessor(usingLinearChain ? static_cast<juce::AudioProcessor*>(&linearChain) : &graph);
+}
+
+void IconMenu::reloadSession()
+{
+    Session next;
+    juce::StringArray errors;
+    
+    // A half-edited file is reported and the running chain carries on as it is
+    if (Session::load(sessionFile, knownPluginList, next, errors))
+        applySession(next);
+    else
+        reportSessionErrors(errors);
+}
+
+void IconMenu::applySession(const Session& next)
+{
+    Session::Difference difference;
+    if (sessionApplied)
+        difference = Session::compare(runningSession, next);
+    else
     {
-        graph.addConnection({{ inputNode->nodeID, CHANNEL_ONE }, { outputNode->nodeID, CHANNEL_ONE }});
-        graph.addConnection({{ inputNode->nodeID, CHANNEL_TWO }, { outputNode->nodeID, CHANNEL_TWO }});
+        difference.device = next.device.isSpecified();
+        difference.chain = true;
+    }
+    
+    if (difference.isEmpty())
         return;
+    
+    if (difference.device)
+    {
+        auto setup = deviceManager.getAudioDeviceSetup();
+        if (next.device.inputDevice.isNotEmpty())
+            setup.inputDeviceName = next.device.inputDevice;
+        if (next.device.outputDevice.isNotEmpty())
+            setup.outputDeviceName = next.device.outputDevice;
+        if (next.device.sampleRate > 0.0)
+            setup.sampleRate = next.device.sampleRate;
+        if (next.device.bufferSize > 0)
+            setup.bufferSize = next.device.bufferSize;
+        
+        const juce::String error = deviceCoordinator.applySetup(setup, next.device.type);
+        if (error.isNotEmpty())
+            reportSessionErrors(juce::StringArray("Audio device: " + error));
     }
     
-    // Lock to prevent concurrent access to plugin list during load
-    std::lock_guard<std::mutex> lock(pluginLoadMutex);
+    bool rebuild = difference.chain;
+    if (difference.chain)
+        writeSessionChain(next);
     
-    struct PluginLoadJob {
-        juce::PluginDescription plugin;
-        juce::String stateKey;
-        int nodeId;
-        bool bypass;
-    };
+    // The settings have to match for the next rebuild, whether it happens now or later
+    for (const size_t i : difference.stateChanged)
+        getAppProperties().getUserSettings()->setValue(getKey("state", next.plugins[i].plugin), next.plugins[i].state);
     
-    // Prepare all plugin load jobs first
-    std::vector<PluginLoadJob> loadJobs;
-    int pluginTime = 0;
+    if (! difference.chain)
+    {
+        for (const size_t i : difference.bypassChanged)
+        {
+            const SessionPlugin& plugin = next.plugins[i];
+            getAppProperties().getUserSettings()->setValue(getKey("bypass", plugin.plugin), plugin.bypass);
+            
+            // The linear engine skips bypassed stages by flag, so no rebuild is needed
+            if (! setBypassInLinearChain(plugin.plugin, plugin.bypass))
+                rebuild = true;
+        }
+    }
     
-    for (int i = 1; i <= activePluginList.getNumTypes(); i++)
+    // Plugins both sessions have keep their instances, unless a new sidechain needs a new bus layout
+    std::vector<bool> kept(next.plugins.size(), false);
+    if (sessionApplied)
     {
-        juce::PluginDescription plugin = getNextPluginOlderThanTime(pluginTime);
-        juce::String pluginUid = getKey("state", plugin);
-        juce::String key = getKey("bypass", plugin);
-        bool bypass = getAppProperties().getUserSettings()->getBoolValue(key, false);
+        juce::StringArray loaded;
+        for (auto node : graph.getNodes())
+            if (auto instance = dynamic_cast<juce::AudioPluginInstance*>(node->getProcessor()))
+                loaded.add(instance->getPluginDescription().createIdentifierString());
         
-        loadJobs.push_back({plugin, pluginUid, i, bypass});
+        for (size_t i = 0; i < next.plugins.size(); i++)
+        {
+            const bool reloaded = std::find(difference.reloaded.begin(), difference.reloaded.end(), i) != difference.reloaded.end();
+            kept[i] = loaded.contains(next.plugins[i].plugin.createIdentifierString()) && ! reloaded;
+        }
+    }
+    
+    if (rebuild)
+    {
+        juce::StringArray pluginsToKeep;
+        for (size_t i = 0; i < next.plugins.size(); i++)
+            if (kept[i])
+                pluginsToKeep.add(next.plugins[i].plugin.createIdentifierString());
+        
+        loadActivePlugins(pluginsToKeep);
+    }
+    
+    // A new state resets the plugin's parameters, and new instances start from their saved state,
+    // so both get every listed value again
+    std::vector<size_t> parameterPlugins = difference.parametersChanged;
+    for (const size_t i : difference.stateChanged)
+        parameterPlugins.push_back(i);
+    for (size_t i = 0; i < next.plugins.size(); i++)
+        if (rebuild && ! kept[i])
+            parameterPlugins.push_back(i);
+    
+    std::sort(parameterPlugins.begin(), parameterPlugins.end());
+    parameterPlugins.erase(std::unique(parameterPlugins.begin(), parameterPlugins.end()), parameterPlugins.end());
+    
+    for (const size_t i : parameterPlugins)
+    {
+        const SessionPlugin& plugin = next.plugins[i];
+        const bool setState = std::find(difference.stateChanged.begin(), difference.stateChanged.end(), i) != difference.stateChanged.end();
+        if (plugin.parameters.empty() && ! setState)
+            continue;
+        
+        for (auto node : graph.getNodes())
+        {
+            auto instance = dynamic_cast<juce::AudioPluginInstance*>(node->getProcessor());
+            if (instance == nullptr || ! instance->getPluginDescription().isDuplicateOf(plugin.plugin))
+                continue;
+            
+            // The running instance takes the new state, instead of being created again with it
+            juce::MemoryBlock state;
+            if (setState && state.fromBase64Encoding(plugin.state))
+                instance->setStateInformation(state.getData(), (int) state.getSize());
+            
+            // Parameter names can only be checked once the plugin exists
+            const juce::StringArray unmatched = Session::applyParameters(plugin, *instance);
+            if (! unmatched.isEmpty())
+                juce::Logger::writeToLog("Session: " + plugin.plugin.name + " has no parameter " + unmatched.joinIntoString(", "));
+            break;
+        }
     }
     
-    // Load and connect all plugins
-    juce::AudioProcessorGraph::Node* lastNode = nullptr;
-    bool hasInputConnected = false;
+    runningSession = next;
+    sessionApplied = true;
+}
+
+void IconMenu::writeSessionChain(const Session& next)
+{
+    auto* settings = getAppProperties().getUserSettings();
     
-    for (const auto& job : loadJobs)
     {
-        juce::String errorMessage;
-        std::unique_ptr<juce::AudioPluginInstance> instance = formatManager.createPluginInstance(
-            job.plugin, graph.getSampleRate(), graph.getBlockSize(), errorMessage);
+        std::lock_guard<ProfiledMutex> lock(pluginLoadMutex);
+        
+        // The session replaces the chain where the tray keeps it, so menu edits carry on from there.
+        // The list's own change message would rebuild a second time, after the parameters are set
+        activePluginList.removeChangeListener(this);
+        activePluginList.clear();
         
-        if (instance == nullptr)
+        for (size_t i = 0; i < next.plugins.size(); i++)
         {
-            // Log the error and continue with the next plugin
-            std::cerr << "Failed to create plugin instance for " << job.plugin.name << ": " << errorMessage << std::endl;
+            const SessionPlugin& plugin = next.plugins[i];
+            settings->setValue(getKey("time", plugin.plugin), (int) i + 1);
+            settings->setValue(getKey("uid", plugin.plugin), (int) i + 2);
+            settings->setValue(getKey("bypass", plugin.plugin), plugin.bypass);
+            
+            if (plugin.state.isNotEmpty())
+                settings->setValue(getKey("state", plugin.plugin), plugin.state);
+            if (plugin.sidechain.isEnabled())
+                settings->setValue(getKey("sidechain", plugin.plugin), plugin.sidechain.toString());
+            else
+                settings->removeValue(getKey("sidechain", plugin.plugin));
+            if (plugin.rateDivisor > 1)
+                settings->setValue(getKey("rate", plugin.plugin), plugin.rateDivisor);
+            else
+                settings->removeValue(getKey("rate", plugin.plugin));
+            
+            activePluginList.addType(plugin.plugin);
+        }
+        
+        activePluginList.dispatchPendingMessages();
+        activePluginList.addChangeListener(this);
+    }
+    
+    savePluginStates();
+}
+
+void IconMenu::reportSessionErrors(const juce::StringArray& errors)
+{
+    const juce::String message = "Problems with the session " + sessionFile.getFileName() + ":\n\n" + errors.joinIntoString("\n");
+    juce::Logger::writeToLog(message);
+    juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon, "Session", message);
+}
+
+void IconMenu::buildMonitorPath()
+{
+    auto* settings = getAppProperties().getUserSettings();
+    juce::StringArray monitored;
+    
+    for (const auto& plugin : getTimeSortedList())
+        if (settings->getBoolValue(getKey("monitor", plugin), false) && ! settings->getBoolValue(getKey("bypass", plugin), false))
+            monitored.add(plugin.createIdentifierString());
+    
+    const juce::StringArray leftOut = monitorPath.build(graph, formatManager, monitored);
+    if (! leftOut.isEmpty())
+        juce::Logger::writeToLog("Monitor path without " + leftOut.joinIntoString("; "));
+}
+
+void IconMenu::addMonitorMenu(juce::PopupMenu& monitorMenu)
+{
+    const int numPlugins = monitorPath.getNumPlugins();
+    monitorMenu.addItem(-1, numPlugins == 0 ? juce::String("Dry Input") : juce::String(numPlugins) + " Latency-Free Plugins", false);
+    monitorMenu.addSeparator();
+    
+    // The first pair belongs to the chain
+    const int firstChannel = monitorPath.getOutputChannel();
+    const int numOutputs = deviceManager.getCurrentAudioDevice() != nullptr
+                         ? deviceManager.getCurrentAudioDevice()->getActiveOutputChannels().countNumberOfSetBits() : 0;
+    monitorMenu.addItem(50, "Off", true, firstChannel < 0);
+    for (int pair = 0; pair < 15 && 2 + pair * 2 + 1 < numOutputs; pair++)
+        monitorMenu.addItem(51 + pair, "Outputs " + juce::String(3 + pair * 2) + "/" + juce::String(4 + pair * 2),
+                            true, firstChannel == 2 + pair * 2);
+}
+
+void IconMenu::showAnalyzer()
+{
+    if (analyzerWindow != nullptr)
+    {
+        analyzerWindow->toFront(true);
+        return;
+    }
+    
+    const std::vector<juce::PluginDescription> plugins = getTimeSortedList();
+    juce::StringArray sourceNames("Chain Output");
+    int selectedSource = 0;
+    for (size_t i = 0; i < plugins.size(); i++)
+    {
+        sourceNames.add(plugins[i].name);
+        if (plugins[i].createIdentifierString() == analyzerSourcePlugin)
+            selectedSource = (int) i + 1;
+    }
+    
+    analyzerWindow.reset(new AnalyzerWindow(analyzer, sourceNames, selectedSource,
+        [this, plugins](int source)
+        {
+            analyzerSourcePlugin = source > 0 && source <= (int) plugins.size() ? plugins[(size_t) source - 1].createIdentifierString() : juce::String();
+            attachAnalyzer();
+        },
+        [this]
+        {
+            // The window asks to be closed from its own close button
+            juce::MessageManager::callAsync([this] { analyzerWindow = nullptr; });
+        }));
+}
+
+void IconMenu::attachAnalyzer()
+{
+    linearChain.clearStageTaps();
+    if (analyzerTapNode != juce::AudioProcessorGraph::NodeID())
+        graph.removeNode(analyzerTapNode);
+    analyzerTapNode = {};
+    
+    analyzer.setListeningToChainOutput(analyzerSourcePlugin.isEmpty());
+    if (analyzerSourcePlugin.isEmpty())
+        return;
+    
+    for (auto node : graph.getNodes())
+    {
+        auto instance = dynamic_cast<juce::AudioPluginInstance*>(node->getProcessor());
+        if (instance == nullptr || instance->getPluginDescription().createIdentifierString() != analyzerSourcePlugin)
             continue;
+        
+        // The linear engine copies the stage output itself...
+        const int stage = linearChain.indexOfStage(instance);
+        if (stage >= 0)
+            linearChain.setStageTap(stage, &analyzer.getNodeTap());
+        
+        // ...and the graph engine gets a node listening alongside the plugin's outputs
+        const int numOutputs = instance->getTotalNumOutputChannels();
+        if (numOutputs > 0)
+        {
+            if (auto tapNode = graph.addNode(std::make_unique<TapProcessor>(analyzer.getNodeTap())))
+            {
+                analyzerTapNode = tapNode->nodeID;
+                for (int channel = 0; channel < 2; channel++)
+                    graph.addConnection({ { node->nodeID, juce::jmin(channel, numOutputs - 1) }, { tapNode->nodeID, channel } });
+            }
+        }
+        break;
+    }
+}
+
+bool IconMenu::setBypassInLinearChain(const juce::PluginDescription& plugin, bool shouldBeBypassed)
+{
+    if (player.getCurrentProcessor() != &linearChain)
+        return false;
+    
+    for (auto node : graph.getNodes())
+    {
+        if (auto instance = dynamic_cast<juce::AudioPluginInstance*>(node->getProcessor()))
+        {
+            if (instance->getPluginDescription().createIdentifierString() == plugin.createIdentifierString())
+            {
+                const int stage = linearChain.indexOfStage(instance);
+                if (stage < 0)
+                    return false;
+                
+                linearChain.setStageBypassed(stage, shouldBeBypassed);
+                
+                // The monitor path leaves bypassed plugins out, so it has to follow
+                if (getAppProperties().getUserSettings()->getBoolValue(getKey("monitor", plugin), false))
+                    buildMonitorPath();
+                return true;
+            }
         }
+    }
+    
+    return false;
+}
+
+MidiRoute IconMenu::getMidiRoute(const juce::PluginDescription& plugin)
+{
+    const juce::String packed = getAppProperties().getUserSettings()->getValue(getKey("midi", plugin));
+    return packed.isEmpty() ? MidiRoute() : MidiRoute::unpack((juce::uint64) packed.getLargeIntValue());
+}
+
+void IconMenu::setMidiRoute(const juce::PluginDescription& plugin, const MidiRoute& route)
+{
+    getAppProperties().getUserSettings()->setValue(getKey("midi", plugin), juce::String((juce::int64) route.pack()));
+    
+    // Both engines take the new route while playing: the linear chain per stage, the graph in the plugin's route node
+    for (auto node : graph.getNodes())
+    {
+        auto instance = dynamic_cast<juce::AudioPluginInstance*>(node->getProcessor());
+        if (instance == nullptr || instance->getPluginDescription().createIdentifierString() != plugin.createIdentifierString())
+            continue;
         
-        // Apply saved state if available
-        juce::String savedPluginState = getAppProperties().getUserSettings()->getValue(job.stateKey);
-        if (savedPluginState.isNotEmpty())
+        const int stage = linearChain.indexOfStage(instance);
+        if (stage >= 0)
+            linearChain.setStageMidiRoute(stage, route);
+        
+        for (auto& connection : graph.getConnections())
+        {
+            if (connection.destination.nodeID != node->nodeID || ! connection.source.isMIDI())
+                continue;
+            
+            if (auto source = graph.getNodeForId(connection.source.nodeID))
+                if (auto routeProcessor = dynamic_cast<MidiRouteProcessor*>(source->getProcessor()))
+                    routeProcessor->setRoute(route);
+        }
+    }
+}
+
+void IconMenu::handleMidiRouteItem(const juce::PluginDescription& plugin, int item)
+{
+    MidiRoute route = getMidiRoute(plugin);
+    
+    // Item layout matches the MIDI submenu built in mouseDown
+    if (item == 0)
+        route.enabled = ! route.enabled;
+    else if (item >= 1 && item <= 16)
+        route.channelMask ^= 1 << (item - 1);
+    else if (item == 17)
+        route.channelMask = 0xffff;
+    else if (item >= 20 && item <= 36)
+        route.outputChannel = item - 20;
+    else if (item >= 40 && item <= 45)
+        route.types ^= 1 << (item - 40);
+    
+    setMidiRoute(plugin, route);
+}
+
+void IconMenu::addSidechainMenu(juce::PopupMenu& pluginSubMenu, const std::vector<juce::PluginDescription>& plugins, int index, int uid)
+{
+    // Only plugins that are loaded and have a second input bus can take a key
+    bool hasSidechainBus = false;
+    for (auto node : graph.getNodes())
+        if (auto instance = dynamic_cast<juce::AudioPluginInstance*>(node->getProcessor()))
+            if (instance->getPluginDescription().createIdentifierString() == plugins[(size_t) index].createIdentifierString())
+                hasSidechainBus = instance->getBusCount(true) >= 2;
+    
+    const SidechainSource current = SidechainSource::fromString(getAppProperties().getUserSettings()->getValue(getKey("sidechain", plugins[(size_t) index])));
+    const int sidechainBase = INDEX_SIDECHAIN + uid * 64;
+    juce::PopupMenu sidechainMenu;
+    sidechainMenu.addItem(sidechainBase, "None", true, ! current.isEnabled());
+    sidechainMenu.addSeparator();
+    
+    int numInputs = 2;
+    if (auto* device = deviceManager.getCurrentAudioDevice())
+        numInputs = device->getActiveInputChannels().countNumberOfSetBits();
+    for (int pair = 0; pair < juce::jmin(numInputs / 2, 16); pair++)
+        sidechainMenu.addItem(sidechainBase + 1 + pair, "Input " + juce::String(pair * 2 + 1) + "/" + juce::String(pair * 2 + 2),
+                              true, current.inputChannel == pair * 2);
+    
+    // Only earlier plugins, so the key never depends on the plugin's own output
+    if (index > 0)
+        sidechainMenu.addSeparator();
+    for (int k = 0; k < juce::jmin(index, 40); k++)
+        sidechainMenu.addItem(sidechainBase + 20 + k, "Output of " + plugins[(size_t) k].name, true,
+                              current.pluginIdentifier == plugins[(size_t) k].createIdentifierString());
+    
+    pluginSubMenu.addSubMenu("Sidechain", sidechainMenu, hasSidechainBus);
+}
+
+void IconMenu::handleSidechainItem(const juce::PluginDescription& plugin, int item)
+{
+    SidechainSource source;
+    if (item >= 1 && item <= 16)
+        source.inputChannel = (item - 1) * 2;
+    else if (item >= 20)
+    {
+        const std::vector<juce::PluginDescription> plugins = getTimeSortedList();
+        if (item - 20 >= (int) plugins.size())
+            return;
+        source.pluginIdentifier = plugins[(size_t) (item - 20)].createIdentifierString();
+    }
+    
+    getAppProperties().getUserSettings()->setValue(getKey("sidechain", plugin), source.toString());
+    loadActivePlugins();
+}
+
+void IconMenu::toggleMidiInputDevice(int index)
+{
+    const auto devices = juce::MidiInput::getAvailableDevices();
+    if (! juce::isPositiveAndBelow(index, devices.size()))
+        return;
+    
+    const juce::String identifier = devices[index].identifier;
+    deviceManager.setMidiInputDeviceEnabled(identifier, ! deviceManager.isMidiInputDeviceEnabled(identifier));
+    saveAudioDeviceState();
+}
+
+void IconMenu::addControllerMenu(juce::PopupMenu& controllerMenu)
+{
+    controllerMenu.addItem(28, "Learn", true, controllerMapper.isLearning());
+    learnChoices.clear();
+    
+    // Learning: move a control, then pick the parameter it should drive
+    if (controllerMapper.isLearning())
+    {
+        const ControllerSource learned = controllerMapper.getLearnedSource();
+        if (! learned.isValid())
         {
-            juce::MemoryBlock savedPluginBinary;
-            if (savedPluginBinary.fromBase64Encoding(savedPluginState))
+            controllerMenu.addItem(-1, "Move a control, then open this menu again", false);
+        }
+        else
+        {
+            juce::PopupMenu mapMenu;
+            for (auto node : graph.getNodes())
             {
-                // Protect against corrupt state data
-                try
-                {
-                    instance->setStateInformation(savedPluginBinary.getData(), 
-                                                static_cast<int>(savedPluginBinary.getSize()));
-                }
-                catch (const std::exception& e)
+                auto instance = dynamic_cast<juce::AudioPluginInstance*>(node->getProcessor());
+                if (instance == nullptr)
+                    continue;
+                
+                juce::PopupMenu parameterMenu;
+                const auto& parameters = instance->getParameters();
+                for (int i = 0; i < parameters.size() && learnChoices.size() < 400000; i++)
                 {
-                    std::cerr << "Error loading state for plugin " << job.plugin.name << ": " << e.what() << std::endl;
+                    parameterMenu.addItem(100000 + (int) learnChoices.size(), parameters[i]->getName(64));
+                    learnChoices.push_back({ instance->getPluginDescription().createIdentifierString(), i });
                 }
+                mapMenu.addSubMenu(instance->getName(), parameterMenu, parameters.size() > 0);
             }
+            controllerMenu.addSubMenu("Map " + learned.getDescription() + " To", mapMenu);
+        }
+    }
+    
+    // Existing mappings, removable one by one
+    const auto& mappings = controllerMapper.getMappings();
+    if (! mappings.empty())
+    {
+        juce::PopupMenu removeMenu;
+        for (int i = 0; i < juce::jmin((int) mappings.size(), 100); i++)
+        {
+            juce::String label = mappings[(size_t) i].source.getDescription() + " -> ";
+            for (int j = 0; j < activePluginList.getNumTypes(); j++)
+                if (activePluginList.getType(j).createIdentifierString() == mappings[(size_t) i].pluginIdentifier)
+                    label += activePluginList.getType(j).name;
+            removeMenu.addItem(300 + i, label + " #" + juce::String(mappings[(size_t) i].parameterIndex + 1));
         }
+        controllerMenu.addSeparator();
+        controllerMenu.addSubMenu("Remove Mapping", removeMenu);
+        controllerMenu.addItem(30, "Clear All Mappings");
+    }
+    
+    controllerMenu.addSeparator();
+    controllerMenu.addItem(29, "Receive OSC on Port 9000", true, controllerMapper.getOscPort() > 0);
+}
+
+void IconMenu::saveControllerMappings()
+{
+    if (auto xml = controllerMapper.createXml())
+        getAppProperties().getUserSettings()->setValue("controllerMappings", xml.get());
+}
+
+void IconMenu::addModulationMenu(juce::PopupMenu& modulationMenu)
+{
+    const auto& sources = modulationEngine.getSources();
+    const auto& routes = modulationEngine.getRoutes();
+    const bool canAdd = (int) sources.size() < ModulationEngine::maxSources;
+    modulationChoices.clear();
+    
+    modulationMenu.addItem(31, "Add LFO", canAdd);
+    modulationMenu.addItem(32, "Add Envelope Follower", canAdd);
+    modulationMenu.addItem(33, "Add Step Sequencer", canAdd);
+    
+    // Each source: its settings, then the parameters it could drive
+    const juce::String shapeLabels[] = { "Sine", "Triangle", "Saw", "Square" };
+    const float rates[] = { 0.1f, 0.25f, 0.5f, 1.0f, 2.0f, 4.0f, 8.0f };
+    if (! sources.empty())
+        modulationMenu.addSeparator();
+    
+    for (int i = 0; i < (int) sources.size(); i++)
+    {
+        const ModulationSource& source = sources[(size_t) i];
+        const int sourceBase = 500 + i * 20;
+        juce::PopupMenu sourceMenu;
         
-        juce::AudioProcessorGraph::Node* currentNode = graph.addNode(std::move(instance)).get();
+        if (source.type == ModulationSource::Type::lfo)
+        {
+            for (int shape = 0; shape < 4; shape++)
+                sourceMenu.addItem(sourceBase + 1 + shape, shapeLabels[shape], true, (int) source.shape == shape);
+            sourceMenu.addSeparator();
+        }
         
-        // Skip connections if plugin is bypassed
-        if (job.bypass)
-            continue;
+        if (source.type != ModulationSource::Type::envelopeFollower)
+        {
+            for (int r = 0; r < 7; r++)
+                sourceMenu.addItem(sourceBase + 5 + r, juce::String(rates[r]) + (source.type == ModulationSource::Type::lfo ? " Hz" : " Steps/s"),
+                                   true, source.rate == rates[r]);
+            sourceMenu.addSeparator();
+        }
+        
+        juce::PopupMenu targetMenu;
+        for (auto node : graph.getNodes())
+        {
+            auto instance = dynamic_cast<juce::AudioPluginInstance*>(node->getProcessor());
+            if (instance == nullptr)
+                continue;
             
-        // Input to plugin
-        if (!hasInputConnected)
+            juce::PopupMenu parameterMenu;
+            const auto& parameters = instance->getParameters();
+            for (int p = 0; p < parameters.size() && modulationChoices.size() < 400000; p++)
+            {
+                ModulationRoute route;
+                route.source = i;
+                route.pluginIdentifier = instance->getPluginDescription().createIdentifierString();
+                route.parameterIndex = p;
+                route.base = parameters[p]->getValue();
+                
+                parameterMenu.addItem(500000 + (int) modulationChoices.size(), parameters[p]->getName(64));
+                modulationChoices.push_back(route);
+            }
+            targetMenu.addSubMenu(instance->getName(), parameterMenu, parameters.size() > 0);
+        }
+        sourceMenu.addSubMenu("Modulate", targetMenu);
+        sourceMenu.addItem(sourceBase, "Remove");
+        
+        modulationMenu.addSubMenu(juce::String(i + 1) + ": " + source.getDescription(), sourceMenu);
+    }
+    
+    // Each route: its depth, or remove it
+    const float depths[] = { 0.1f, 0.25f, 0.5f, 1.0f, -0.5f, -1.0f };
+    if (! routes.empty())
+        modulationMenu.addSeparator();
+    
+    for (int r = 0; r < juce::jmin((int) routes.size(), 50); r++)
+    {
+        const ModulationRoute& route = routes[(size_t) r];
+        const int routeBase = 900 + r * 10;
+        juce::PopupMenu routeMenu;
+        
+        for (int d = 0; d < 6; d++)
+            routeMenu.addItem(routeBase + 1 + d, "Depth " + juce::String(juce::roundToInt(depths[d] * 100)) + "%", true, route.depth == depths[d]);
+        routeMenu.addSeparator();
+        routeMenu.addItem(routeBase, "Remove");
+        
+        juce::String label = juce::String(route.source + 1) + " -> ";
+        for (int j = 0; j < activePluginList.getNumTypes(); j++)
+            if (activePluginList.getType(j).createIdentifierString() == route.pluginIdentifier)
+                label += activePluginList.getType(j).name;
+        modulationMenu.addSubMenu(label + " #" + juce::String(route.parameterIndex + 1), routeMenu);
+    }
+    
+    if (modulationEngine.getNumOverBudgetBlocks() > 0)
+    {
+        modulationMenu.addSeparator();
+        modulationMenu.addItem(-1, juce::String(modulationEngine.getNumOverBudgetBlocks()) + " blocks over the modulation budget", false);
+    }
+}
+
+void IconMenu::handleModulationItem(int id)
+{
+    auto sources = modulationEngine.getSources();
+    auto routes = modulationEngine.getRoutes();
+    const float rates[] = { 0.1f, 0.25f, 0.5f, 1.0f, 2.0f, 4.0f, 8.0f };
+    const float depths[] = { 0.1f, 0.25f, 0.5f, 1.0f, -0.5f, -1.0f };
+    
+    if (id >= 31 && id <= 33)
+    {
+        ModulationSource source;
+        source.type = (ModulationSource::Type) (id - 31);
+        sources.push_back(source);
+    }
+    else if (id >= 500 && id < 820)
+    {
+        const int index = (id - 500) / 20;
+        const int item = (id - 500) % 20;
+        if (index >= (int) sources.size())
+            return;
+        
+        if (item == 0)
         {
-            graph.addConnection({{ inputNode->nodeID, CHANNEL_ONE }, { currentNode->nodeID, CHANNEL_ONE }});
-            graph.addConnection({{ inputNode->nodeID, CHANNEL_TWO }, { currentNode->nodeID, CHANNEL_TWO }});
-            hasInputConnected = true;
+            modulationEngine.removeSource(index);
+            saveModulation();
+            return;
         }
-        else if (lastNode != nullptr)
+        else if (item <= 4)
+            sources[(size_t) index].shape = (ModulationSource::Shape) (item - 1);
+        else if (item <= 11)
+            sources[(size_t) index].rate = rates[item - 5];
+    }
+    else if (id >= 900 && id < 1400)
+    {
+        const int index = (id - 900) / 10;
+        const int item = (id - 900) % 10;
+        if (index >= (int) routes.size())
+            return;
+        
+        if (item == 0)
+            routes.erase(routes.begin() + index);
+        else if (item <= 6)
+            routes[(size_t) index].depth = depths[item - 1];
+    }
+    else if (id >= 500000 && id - 500000 < (int) modulationChoices.size())
+    {
+        routes.push_back(modulationChoices[(size_t) (id - 500000)]);
+    }
+    
+    modulationEngine.setConfiguration(sources, routes);
+    saveModulation();
+}
+
+void IconMenu::saveModulation()
+{
+    if (auto xml = modulationEngine.createXml())
+        getAppProperties().getUserSettings()->setValue("modulation", xml.get());
+}
+
+void IconMenu::addSnapshotMenu(juce::PopupMenu& snapshotMenu)
+{
+    const double morphSeconds[] = { 0.0, 0.5, 2.0, 5.0, 10.0 };
+    
+    for (int slot = 0; slot < SnapshotMorpher::numSlots; slot++)
+    {
+        const bool stored = ! snapshotMorpher.getSlot(slot).isEmpty();
+        juce::PopupMenu slotMenu;
+        slotMenu.addItem(40 + slot, stored ? "Replace With Current Chain" : "Store Current Chain");
+        slotMenu.addSeparator();
+        
+        for (int t = 0; t < 5; t++)
+            slotMenu.addItem(1400 + slot * 10 + t, morphSeconds[t] == 0.0 ? juce::String("Recall")
+                                                                          : "Morph Here Over " + juce::String(morphSeconds[t]) + " s", stored);
+        
+        snapshotMenu.addSubMenu("Slot " + juce::String(slot + 1) + (stored ? juce::String() : juce::String(" (empty)")), slotMenu);
+    }
+    
+    snapshotMenu.addSeparator();
+    snapshotMenu.addItem(48, "Stop Morph", snapshotMorpher.isMorphing());
+}
+
+void IconMenu::addPluginToChain(const juce::PluginDescription& plugin)
+{
+    if (memoryMonitor.getBudgetAction() == PluginMemoryMonitor::BudgetAction::refuse && memoryMonitor.wouldExceedBudget(plugin))
+    {
+        juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon, "Memory Budget Exceeded",
+            plugin.name + " needs " + PluginMemoryMonitor::formatBytes(memoryMonitor.getExpectedBytes(plugin))
+            + ", which does not fit in the memory budget.");
+        return;
+    }
+    
+    auto* settings = getAppProperties().getUserSettings();
+    juce::Array<juce::PluginDescription> processing;
+    
+    for (int j = 0; j < activePluginList.getNumTypes(); j++)
+    {
+        const juce::PluginDescription existing = activePluginList.getType(j);
+        
+        // Settings are keyed by plugin, so each plugin can only be in the chain once
+        if (existing.isDuplicateOf(plugin))
         {
-            // Connect previous plugin to current
-            graph.addConnection({{ lastNode->nodeID, CHANNEL_ONE }, { currentNode->nodeID, CHANNEL_ONE }});
-            graph.addConnection({{ lastNode->nodeID, CHANNEL_TWO }, { currentNode->nodeID, CHANNEL_TWO }});
+            juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::InfoIcon, "Add Plugin",
+                plugin.name + " is already in the chain.");
+            return;
         }
         
-        lastNode = currentNode;
+        if (! settings->getBoolValue(getKey("bypass", existing), false))
+            processing.add(existing);
     }
     
-    // Connect last plugin to output
-    if (lastNode != nullptr)
+    // Predict the callback load with the plugin added, from the measured load when a device runs
+    const double sampleRate = deviceCoordinator.getSampleRate();
+    const int blockSize = deviceCoordinator.getBlockSize();
+    const double measuredLoad = deviceManager.getCurrentAudioDevice() != nullptr ? deviceManager.getCpuUsage() : -1.0;
+    const PluginCostModel::Prediction prediction = costModel->predictLoadWith(processing, plugin, sampleRate, blockSize, measuredLoad);
+    const double warningLoad = settings->getDoubleValue("cpuWarningLoad", 0.8);
+    
+    if (prediction.candidateMeasured && prediction.predictedLoad > warningLoad)
     {
-        graph.addConnection({{ lastNode->nodeID, CHANNEL_ONE }, { outputNode->nodeID, CHANNEL_ONE }});
-        graph.addConnection({{ lastNode->nodeID, CHANNEL_TWO }, { outputNode->nodeID, CHANNEL_TWO }});
+        const juce::String message = "Adding " + plugin.name + " is expected to raise the audio load from "
+            + juce::String(juce::roundToInt(prediction.currentLoad * 100.0)) + "% to "
+            + juce::String(juce::roundToInt(prediction.predictedLoad * 100.0)) + "% of the "
+            + juce::String(1000.0 * blockSize / sampleRate, 1) + " ms deadline, which may cause dropouts.";
+        
+        juce::AlertWindow::showOkCancelBox(juce::AlertWindow::WarningIcon, "Audio Load", message, "Add Anyway", "Cancel", nullptr,
+            juce::ModalCallbackFunction::create([this, plugin](int result)
+            {
+                if (result != 0)
+                    insertPluginIntoChain(plugin);
+            }));
+        return;
     }
-    else if (!hasInputConnected)
+    
+    insertPluginIntoChain(plugin);
+}
+
+void IconMenu::insertPluginIntoChain(const juce::PluginDescription& plugin)
+{
+    auto* settings = getAppProperties().getUserSettings();
+    int lastTime = 0;
+    int lastUid = 1;
+    
+    for (int j = 0; j < activePluginList.getNumTypes(); j++)
     {
-        // Default connection if no plugins were loaded successfully
-        graph.addConnection({{ inputNode->nodeID, CHANNEL_ONE }, { outputNode->nodeID, CHANNEL_ONE }});
-        graph.addConnection({{ inputNode->nodeID, CHANNEL_TWO }, { outputNode->nodeID, CHANNEL_TWO }});
+        const juce::PluginDescription existing = activePluginList.getType(j);
+        lastTime = juce::jmax(lastTime, settings->getIntValue(getKey("time", existing), 0));
+        lastUid = juce::jmax(lastUid, settings->getIntValue(getKey("uid", existing), j + 2));
     }
+    
+    // Appended after the newest plugin; the change listener saves the list and rebuilds the chain
+    settings->setValue(getKey("time", plugin), lastTime + 1);
+    settings->setValue(getKey("uid", plugin), lastUid + 1);
+    settings->setValue(getKey("bypass", plugin), false);
+    activePluginList.addType(plugin);
 }
 
 juce::PluginDescription IconMenu::getNextPluginOlderThanTime(int &time)
@@ -349,8 +1179,19 @@ juce::PluginDescription IconMenu::getNextPluginOlderThanTime(int &time)
     return juce::PluginDescription();
 }
 
+void IconMenu::saveCostModel()
+{
+    if (auto xml = costModel->createXml())
+    {
+        getAppProperties().getUserSettings()->setValue("pluginCostModel", xml.get());
+        getAppProperties().getUserSettings()->saveIfNeeded();
+    }
+}
+
 void IconMenu::savePluginStates()
 {
+    saveCostModel();
+    
     auto xmlPluginListActive = std::unique_ptr<juce::XmlElement>(activePluginList.createXml());
     
     if (xmlPluginListActive != nullptr)
@@ -405,6 +1246,7 @@ void IconMenu::mouseDown(const juce::MouseEvent& e)
         
         // First menu section - Add Plugin
         menu.addItem(1, "Add Plugin");
+        menu.addItem(27, "Quick Add Plugin...");
         menu.addSeparator();
         
         std::vector<juce::PluginDescription> plugins = getTimeSortedList();
@@ -438,7 +1280,70 @@ void IconMenu::mouseDown(const juce::MouseEvent& e)
                 if (i < (int)plugins.size() - 1)
                     pluginSubMenu.addItem(INDEX_MOVE_DOWN + uid, "Move Down");
                 
-                menu.addSubMenu(plugins[i].name, pluginSubMenu);
+                // Which device MIDI the plugin hears; plugins that take no MIDI simply ignore it
+                {
+                    const MidiRoute route = getMidiRoute(plugins[i]);
+                    const int midiBase = INDEX_MIDI + uid * 64;
+                    const juce::String typeNames[] = { "Notes", "Controllers", "Pitch Bend", "Program Changes", "Pressure", "Other" };
+                    
+                    juce::PopupMenu midiMenu, channelMenu, outputMenu;
+                    midiMenu.addItem(midiBase, "Receive MIDI Input", true, route.enabled);
+                    midiMenu.addSeparator();
+                    
+                    for (int channel = 1; channel <= 16; channel++)
+                        channelMenu.addItem(midiBase + channel, "Channel " + juce::String(channel), true, (route.channelMask & (1 << (channel - 1))) != 0);
+                    channelMenu.addSeparator();
+                    channelMenu.addItem(midiBase + 17, "All Channels", route.channelMask != 0xffff);
+                    midiMenu.addSubMenu("Channels", channelMenu, route.enabled);
+                    
+                    outputMenu.addItem(midiBase + 20, "Keep Channel", true, route.outputChannel == 0);
+                    for (int channel = 1; channel <= 16; channel++)
+                        outputMenu.addItem(midiBase + 20 + channel, "Channel " + juce::String(channel), true, route.outputChannel == channel);
+                    midiMenu.addSubMenu("Send On", outputMenu, route.enabled);
+                    
+                    midiMenu.addSeparator();
+                    for (int type = 0; type < 6; type++)
+                        midiMenu.addItem(midiBase + 40 + type, typeNames[type], route.enabled, (route.types & (1 << type)) != 0);
+                    
+                    pluginSubMenu.addSubMenu("MIDI", midiMenu);
+                    
+                    // Morphing just this plugin, leaving the rest of the chain where it is
+                    juce::PopupMenu pluginMorphMenu;
+                    for (int slot = 0; slot < SnapshotMorpher::numSlots; slot++)
+                        if (snapshotMorpher.getSlot(slot).find(plugins[i].createIdentifierString()) != nullptr)
+                            pluginMorphMenu.addItem(midiBase + 48 + slot, "Slot " + juce::String(slot + 1));
+                    pluginSubMenu.addSubMenu("Morph To Snapshot (2 s)", pluginMorphMenu, pluginMorphMenu.getNumItems() > 0);
+                    pluginSubMenu.addItem(midiBase + 56, "In Monitor Path", true,
+                                          getAppProperties().getUserSettings()->getBoolValue(getKey("monitor", plugins[i]), false));
+                    
+                    // Plugins that oversample or scale with the rate can run at a fraction of a high device rate
+                    juce::PopupMenu rateMenu;
+                    const int rateDivisor = getAppProperties().getUserSettings()->getIntValue(getKey("rate", plugins[i]), 1);
+                    const double deviceRate = deviceCoordinator.getSampleRate();
+                    if (! usingLinearChain)
+                    {
+                        // Still settable, so it takes effect once the chain is back on the linear engine
+                        rateMenu.addItem(-1, "Ignored: sidechains or settings put the chain on the graph engine", false);
+                        rateMenu.addSeparator();
+                    }
+                    for (int divisor = 1; divisor <= SampleRateBridge::maxFactor; divisor++)
+                        rateMenu.addItem(midiBase + 56 + divisor,
+                                         (divisor == 1 ? juce::String("Device Rate") : "1/" + juce::String(divisor))
+                                             + " (" + juce::String(deviceRate / divisor / 1000.0, 1) + " kHz)",
+                                         true, rateDivisor == divisor);
+                    pluginSubMenu.addSubMenu(usingLinearChain ? "Internal Rate" : "Internal Rate (Not Applied)", rateMenu);
+                    
+                    addSidechainMenu(pluginSubMenu, plugins, i, uid);
+                }
+                
+                // Show what each plugin costs, so the memory hogs stand out
+                juce::String pluginLabel = plugins[i].name;
+                if (memoryMonitor.isHibernated(plugins[i]))
+                    pluginLabel += " (hibernated)";
+                else if (memoryMonitor.getFootprint(plugins[i]) >= 0)
+                    pluginLabel += " (" + PluginMemoryMonitor::formatBytes(memoryMonitor.getFootprint(plugins[i])) + ")";
+                
+                menu.addSubMenu(pluginLabel, pluginSubMenu);
             }
             
             menu.addSeparator();
@@ -448,6 +1353,35 @@ void IconMenu::mouseDown(const juce::MouseEvent& e)
         menu.addSeparator();
         menu.addItem(3, "Audio Settings");
         
+        // MIDI input devices feeding the chain
+        juce::PopupMenu midiInputMenu;
+        const auto midiDevices = juce::MidiInput::getAvailableDevices();
+        if (midiDevices.isEmpty())
+            midiInputMenu.addItem(-1, "No MIDI Inputs", false);
+        for (int i = 0; i < juce::jmin(midiDevices.size(), 100); i++)
+            midiInputMenu.addItem(200 + i, midiDevices[i].name, true, deviceManager.isMidiInputDeviceEnabled(midiDevices[i].identifier));
+        if (midiRouter.getNumDropped() > 0)
+        {
+            midiInputMenu.addSeparator();
+            midiInputMenu.addItem(-1, juce::String(midiRouter.getNumDropped()) + " messages dropped", false);
+        }
+        menu.addSubMenu("MIDI Inputs", midiInputMenu);
+        
+        // Hardware controls driving plugin parameters
+        juce::PopupMenu controllerMenu;
+        addControllerMenu(controllerMenu);
+        menu.addSubMenu("Controllers", controllerMenu);
+        
+        // LFOs, envelope followers and step sequencers driving plugin parameters
+        juce::PopupMenu modulationMenu;
+        addModulationMenu(modulationMenu);
+        menu.addSubMenu("Modulation", modulationMenu);
+        
+        // Parameter snapshots of the whole chain, recalled at once or morphed to
+        juce::PopupMenu snapshotMenu;
+        addSnapshotMenu(snapshotMenu);
+        menu.addSubMenu("Snapshots", snapshotMenu);
+        
         // Set icon color menu item
         #if JUCE_WINDOWS || JUCE_LINUX
         juce::PopupMenu iconColorMenu;
@@ -457,6 +1391,57 @@ void IconMenu::mouseDown(const juce::MouseEvent& e)
         menu.addSubMenu("Icon Color", iconColorMenu);
         #endif
         
+        // Recording controls
+        juce::PopupMenu recordingMenu;
+        if (recorder.isRecording())
+        {
+            juce::String stopLabel = "Stop Recording";
+            if (recorder.getNumOverruns() > 0)
+                stopLabel += " (" + juce::String(recorder.getNumOverruns()) + " overruns)";
+            recordingMenu.addItem(7, stopLabel);
+        }
+        else
+            recordingMenu.addItem(7, "Start Recording");
+        recordingMenu.addSeparator();
+        int recordingFormat = getAppProperties().getUserSettings()->getIntValue("recordingFormat", (int) DiskRecorder::Format::wav);
+        recordingMenu.addItem(8, "WAV", !recorder.isRecording(), recordingFormat == (int) DiskRecorder::Format::wav);
+        recordingMenu.addItem(9, "FLAC", !recorder.isRecording(), recordingFormat == (int) DiskRecorder::Format::flac);
+        
+        // Retroactive capture of the last few minutes
+        recordingMenu.addSeparator();
+        int historyMinutes = captureHistory.getMinutesToKeep();
+        recordingMenu.addItem(10, "Save Last " + juce::String(historyMinutes) + " Minutes", historyMinutes > 0);
+        juce::PopupMenu historyLengthMenu;
+        const int historyLengths[] = { 0, 1, 5, 15, 30 };
+        for (int i = 0; i < 5; i++)
+            historyLengthMenu.addItem(11 + i, historyLengths[i] == 0 ? juce::String("Off") : juce::String(historyLengths[i]) + " Minutes",
+                                      true, historyMinutes == historyLengths[i]);
+        recordingMenu.addSubMenu("History Length", historyLengthMenu);
+        recordingMenu.addItem(16, "Compress History (24-bit)", historyMinutes > 0, captureHistory.isCompressing());
+        menu.addSubMenu("Recording", recordingMenu);
+        
+        // Memory budget for the whole chain
+        juce::PopupMenu memoryMenu;
+        const juce::int64 budgetBytes = memoryMonitor.getBudgetBytes();
+        memoryMenu.addItem(-1, "Plugins use " + PluginMemoryMonitor::formatBytes(memoryMonitor.getTotalPluginBytes())
+                               + (budgetBytes > 0 ? " of " + PluginMemoryMonitor::formatBytes(budgetBytes) : juce::String()), false);
+        memoryMenu.addSeparator();
+        const int budgetGigabytes[] = { 0, 1, 2, 4, 8, 16 };
+        for (int i = 0; i < 6; i++)
+            memoryMenu.addItem(17 + i, budgetGigabytes[i] == 0 ? juce::String("No Budget") : juce::String(budgetGigabytes[i]) + " GB Budget",
+                               true, budgetBytes == ((juce::int64) budgetGigabytes[i] << 30));
+        memoryMenu.addSeparator();
+        const auto budgetAction = memoryMonitor.getBudgetAction();
+        memoryMenu.addItem(23, "Warn When Over Budget", budgetBytes > 0, budgetAction == PluginMemoryMonitor::BudgetAction::warn);
+        memoryMenu.addItem(24, "Refuse Plugins Over Budget", budgetBytes > 0, budgetAction == PluginMemoryMonitor::BudgetAction::refuse);
+        memoryMenu.addItem(25, "Hibernate Bypassed Plugins", budgetBytes > 0, budgetAction == PluginMemoryMonitor::BudgetAction::hibernate);
+        menu.addSubMenu("Memory", memoryMenu);
+        menu.addItem(26, "Lock Statistics");
+        menu.addItem(49, "Analyzer");
+        juce::PopupMenu monitorMenu;
+        addMonitorMenu(monitorMenu);
+        menu.addSubMenu("Monitor Path", monitorMenu);
+        
         menu.addSeparator();
         menu.addItem(6, "Exit");
     }
@@ -503,6 +1488,130 @@ void IconMenu::menuInvocationCallback(int id, IconMenu* im)
         }
         else if (id == 6)
             juce::JUCEApplicationBase::quit();
+        else if (id == 7)
+            im->toggleRecording();
+        else if (id == 8)
+            getAppProperties().getUserSettings()->setValue("recordingFormat", (int) DiskRecorder::Format::wav);
+        else if (id == 9)
+            getAppProperties().getUserSettings()->setValue("recordingFormat", (int) DiskRecorder::Format::flac);
+        else if (id == 10)
+            im->saveCaptureHistory();
+        else if (id >= 11 && id <= 15)
+        {
+            const int historyLengths[] = { 0, 1, 5, 15, 30 };
+            getAppProperties().getUserSettings()->setValue("captureHistoryMinutes", historyLengths[id - 11]);
+            im->applyCaptureHistorySettings();
+        }
+        else if (id == 16)
+        {
+            getAppProperties().getUserSettings()->setValue("captureHistoryCompress", !im->captureHistory.isCompressing());
+            im->applyCaptureHistorySettings();
+        }
+        else if (id >= 17 && id <= 22)
+        {
+            const int budgetGigabytes[] = { 0, 1, 2, 4, 8, 16 };
+            getAppProperties().getUserSettings()->setValue("memoryBudgetMb", budgetGigabytes[id - 17] * 1024);
+            im->applyMemoryBudgetSettings();
+            im->loadActivePlugins();
+        }
+        else if (id >= 23 && id <= 25)
+        {
+            getAppProperties().getUserSettings()->setValue("memoryBudgetAction", id - 23);
+            im->applyMemoryBudgetSettings();
+            im->loadActivePlugins();
+        }
+        else if (id == 26)
+        {
+            if (im->lockStatsWindow == nullptr)
+                im->lockStatsWindow.reset(new LockStatsWindow([im]
+                {
+                    // The window asks to be closed from its own close button
+                    juce::MessageManager::callAsync([im] { im->lockStatsWindow = nullptr; });
+                }));
+            else
+                im->lockStatsWindow->toFront(true);
+        }
+        else if (id == 49)
+            im->showAnalyzer();
+        else if (id >= 50 && id <= 65)
+        {
+            const int firstChannel = id == 50 ? -1 : 2 + (id - 51) * 2;
+            getAppProperties().getUserSettings()->setValue("monitorOutputChannel", firstChannel);
+            im->monitorPath.setOutputChannel(firstChannel);
+        }
+        else if (id == 27)
+        {
+            if (im->quickAddPalette == nullptr)
+                im->quickAddPalette.reset(new QuickAddPalette(im->searchIndex,
+                    [im](const juce::PluginDescription& plugin) { im->addPluginToChain(plugin); },
+                    [im] { juce::MessageManager::callAsync([im] { im->quickAddPalette = nullptr; }); }));
+            else
+                im->quickAddPalette->toFront(true);
+        }
+        else if (id >= 200 && id < 300)
+            im->toggleMidiInputDevice(id - 200);
+        else if (id == 28)
+            im->controllerMapper.setLearning(! im->controllerMapper.isLearning());
+        else if (id == 29)
+        {
+            const int port = im->controllerMapper.getOscPort() > 0 ? 0 : 9000;
+            if (im->controllerMapper.setOscPort(port))
+                getAppProperties().getUserSettings()->setValue("oscPort", port);
+        }
+        else if (id == 30)
+        {
+            im->controllerMapper.setMappings({});
+            im->saveControllerMappings();
+        }
+        else if (id >= 300 && id < 400)
+        {
+            auto mappings = im->controllerMapper.getMappings();
+            if (id - 300 < (int) mappings.size())
+            {
+                mappings.erase(mappings.begin() + (id - 300));
+                im->controllerMapper.setMappings(mappings);
+                im->saveControllerMappings();
+            }
+        }
+        else if (id >= 40 && id < 40 + SnapshotMorpher::numSlots)
+        {
+            im->snapshotMorpher.storeSlot(id - 40);
+            if (auto xml = im->snapshotMorpher.createXml())
+                getAppProperties().getUserSettings()->setValue("parameterSnapshots", xml.get());
+        }
+        else if (id == 48)
+            im->snapshotMorpher.stop();
+        else if (id >= 1400 && id < 1400 + SnapshotMorpher::numSlots * 10)
+        {
+            const double morphSeconds[] = { 0.0, 0.5, 2.0, 5.0, 10.0 };
+            if ((id - 1400) % 10 < 5)
+                im->snapshotMorpher.morphToSlot((id - 1400) / 10, morphSeconds[(id - 1400) % 10]);
+        }
+        else if ((id >= 31 && id <= 33) || (id >= 500 && id < 1400) || (id >= 500000 && id < im->INDEX_EDIT))
+            im->handleModulationItem(id);
+        else if (id >= 100000 && id < 500000)
+        {
+            const ControllerSource learned = im->controllerMapper.getLearnedSource();
+            if (learned.isValid() && id - 100000 < (int) im->learnChoices.size())
+            {
+                ControllerMapping mapping;
+                mapping.source = learned;
+                mapping.pluginIdentifier = im->learnChoices[(size_t) (id - 100000)].first;
+                mapping.parameterIndex = im->learnChoices[(size_t) (id - 100000)].second;
+                
+                // One control may drive several parameters, but each parameter follows one control
+                auto mappings = im->controllerMapper.getMappings();
+                mappings.erase(std::remove_if(mappings.begin(), mappings.end(), [&mapping](const ControllerMapping& m)
+                {
+                    return m.pluginIdentifier == mapping.pluginIdentifier && m.parameterIndex == mapping.parameterIndex;
+                }), mappings.end());
+                mappings.push_back(mapping);
+                
+                im->controllerMapper.setMappings(mappings);
+                im->controllerMapper.setLearning(false);
+                im->saveControllerMappings();
+            }
+        }
         else
         {
             // Handle plugin-specific actions
@@ -570,7 +1679,10 @@ void IconMenu::menuInvocationCallback(int id, IconMenu* im)
                         juce::String keyToMove = im->getKey("bypass", im->activePluginList.getType(j));
                         bool valueAbove = !im->getAppProperties().getUserSettings()->getBoolValue(keyToMove, false);
                         im->getAppProperties().getUserSettings()->setValue(keyToMove, valueAbove);
-                        im->loadActivePlugins();
+                        
+                        // The linear engine skips bypassed stages by flag, so no rebuild is needed
+                        if (! im->setBypassInLinearChain(im->activePluginList.getType(j), valueAbove))
+                            im->loadActivePlugins();
                     }
                 }
             }
@@ -610,7 +1722,7 @@ void IconMenu::menuInvocationCallback(int id, IconMenu* im)
                     }
                 }
             }
-            else if (id >= im->INDEX_MOVE_DOWN)
+            else if (id >= im->INDEX_MOVE_DOWN && id < im->INDEX_MIDI)
             {
                 juce::String key = juce::String(id - im->INDEX_MOVE_DOWN);
                 for (int j = 0; j < im->activePluginList.getNumTypes(); j++)
@@ -630,6 +1742,55 @@ void IconMenu::menuInvocationCallback(int id, IconMenu* im)
                     }
                 }
             }
+            else if (id >= im->INDEX_MIDI && id < im->INDEX_SIDECHAIN)
+            {
+                const int midiUid = (id - im->INDEX_MIDI) / 64;
+                for (int j = 0; j < im->activePluginList.getNumTypes(); j++)
+                {
+                    juce::String pluginUid = im->getKey("uid", im->activePluginList.getType(j));
+                    int uid = im->getAppProperties().getUserSettings()->getIntValue(pluginUid, j + 2);
+                    
+                    if (uid != midiUid)
+                        continue;
+                    
+                    const int item = (id - im->INDEX_MIDI) % 64;
+                    if (item == 56)
+                    {
+                        const juce::String monitorKey = im->getKey("monitor", im->activePluginList.getType(j));
+                        getAppProperties().getUserSettings()->setValue(monitorKey, ! getAppProperties().getUserSettings()->getBoolValue(monitorKey, false));
+                        im->buildMonitorPath();
+                    }
+                    else if (item >= 57 && item < 57 + SampleRateBridge::maxFactor)
+                    {
+                        // The plugin is prepared at its rate, so this takes a rebuild
+                        const juce::String rateKey = im->getKey("rate", im->activePluginList.getType(j));
+                        if (item == 57)
+                            getAppProperties().getUserSettings()->removeValue(rateKey);
+                        else
+                            getAppProperties().getUserSettings()->setValue(rateKey, item - 56);
+                        im->loadActivePlugins();
+                    }
+                    else if (item >= 48)
+                        im->snapshotMorpher.morphToSlot(item - 48, 2.0, im->activePluginList.getType(j).createIdentifierString());
+                    else
+                        im->handleMidiRouteItem(im->activePluginList.getType(j), item);
+                }
+            }
+            else if (id >= im->INDEX_SIDECHAIN)
+            {
+                const int sidechainUid = (id - im->INDEX_SIDECHAIN) / 64;
+                for (int j = 0; j < im->activePluginList.getNumTypes(); j++)
+                {
+                    juce::String pluginUid = im->getKey("uid", im->activePluginList.getType(j));
+                    int uid = im->getAppProperties().getUserSettings()->getIntValue(pluginUid, j + 2);
+                    
+                    if (uid == sidechainUid)
+                    {
+                        im->handleSidechainItem(im->activePluginList.getType(j), (id - im->INDEX_SIDECHAIN) % 64);
+                        break;
+                    }
+                }
+            }
         }
     }
     else
@@ -656,6 +1817,54 @@ void IconMenu::menuInvocationCallback(int id, IconMenu* im)
     }
 }
 
+void IconMenu::applyMemoryBudgetSettings()
+{
+    auto* settings = getAppProperties().getUserSettings();
+    memoryMonitor.setBudget((juce::int64) settings->getIntValue("memoryBudgetMb", 0) << 20,
+                            (PluginMemoryMonitor::BudgetAction) juce::jlimit(0, 2, settings->getIntValue("memoryBudgetAction", 0)));
+}
+
+void IconMenu::handleMemoryOverBudget()
+{
+    juce::String message = "The plugins in the chain use " + PluginMemoryMonitor::formatBytes(memoryMonitor.getTotalPluginBytes())
+                         + ", more than the budget of " + PluginMemoryMonitor::formatBytes(memoryMonitor.getBudgetBytes()) + ".";
+    
+    if (memoryMonitor.getBudgetAction() == PluginMemoryMonitor::BudgetAction::hibernate)
+    {
+        hibernateBypassedPlugins();
+        message += "\n\nBypassed plugins have been unloaded until they are switched back on.";
+    }
+    else if (memoryMonitor.getBudgetAction() == PluginMemoryMonitor::BudgetAction::refuse)
+        message += "\n\nNo further plugins will be loaded while the chain is over budget.";
+    
+    juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon, "Memory Budget Exceeded", message);
+}
+
+void IconMenu::hibernateBypassedPlugins()
+{
+    bool anyLoaded = false;
+    
+    // Keep the live state, so a hibernated plugin comes back exactly as it was left
+    for (auto node : graph.getNodes())
+    {
+        if (auto instance = dynamic_cast<juce::AudioPluginInstance*>(node->getProcessor()))
+        {
+            const juce::PluginDescription plugin = instance->getPluginDescription();
+            if (!getAppProperties().getUserSettings()->getBoolValue(getKey("bypass", plugin), false))
+                continue;
+            
+            juce::MemoryBlock state;
+            instance->getStateInformation(state);
+            getAppProperties().getUserSettings()->setValue(getKey("state", plugin), state.toBase64Encoding());
+            anyLoaded = true;
+        }
+    }
+    
+    // The rebuild leaves bypassed plugins out while the chain is over budget
+    if (anyLoaded)
+        loadActivePlugins();
+}
+
 juce::String IconMenu::exec(const char* cmd)
 {
     juce::String key = "cmd_";
@@ -696,6 +1905,8 @@ void IconMenu::changeListenerCallback(juce::ChangeBroadcaster* changed)
             getAppProperties().getUserSettings()->setValue("pluginList", savedPluginList.get());
             getAppProperties().getUserSettings()->saveIfNeeded();
         }
+        
+        searchIndex.update(knownPluginList.getTypes());
     }
     else if (changed == &activePluginList)
     {
@@ -734,6 +1945,67 @@ void IconMenu::showAudioSettings()
     window->setVisible(true);
 }
 
+void IconMenu::toggleRecording()
+{
+    if (recorder.isRecording())
+    {
+        recorder.stop();
+        
+        juce::String message = "Recorded to:\n" + recorder.getInputFile().getFullPathName()
+                             + "\n" + recorder.getOutputFile().getFullPathName();
+        if (recorder.getNumOverruns() > 0)
+            message += "\n\nWarning: " + juce::String(recorder.getNumOverruns()) + " overruns dropped "
+                     + juce::String(recorder.getNumDroppedSamples()) + " samples.";
+        
+        juce::AlertWindow::showMessageBoxAsync(recorder.getNumOverruns() > 0 ? juce::AlertWindow::WarningIcon
+                                                                             : juce::AlertWindow::InfoIcon,
+            "Recording Stopped", message);
+        return;
+    }
+    
+    juce::AudioIODevice* device = deviceManager.getCurrentAudioDevice();
+    if (device == nullptr)
+    {
+        juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
+            "Recording", "No audio device is running.");
+        return;
+    }
+    
+    juce::File directory = getRecordingDirectory();
+    auto format = (DiskRecorder::Format) getAppProperties().getUserSettings()->getIntValue("recordingFormat",
+                                                                                          (int) DiskRecorder::Format::wav);
+    
+    juce::String errorMessage;
+    if (!recorder.start(directory, format, device->getCurrentSampleRate(),
+                        device->getActiveInputChannels().countNumberOfSetBits(),
+                        device->getActiveOutputChannels().countNumberOfSetBits(),
+                        errorMessage))
+    {
+        juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
+            "Recording Failed", errorMessage);
+    }
+}
+
+juce::File IconMenu::getRecordingDirectory()
+{
+    juce::String folder = getAppProperties().getUserSettings()->getValue("recordingFolder");
+    return folder.isNotEmpty() ? juce::File(folder) : DiskRecorder::getDefaultDirectory();
+}
+
+void IconMenu::applyCaptureHistorySettings()
+{
+    captureHistory.setConfiguration(getAppProperties().getUserSettings()->getIntValue("captureHistoryMinutes", 0),
+                                    getAppProperties().getUserSettings()->getBoolValue("captureHistoryCompress", true));
+}
+
+void IconMenu::saveCaptureHistory()
+{
+    captureHistory.dumpToDirectory(getRecordingDirectory(), [](bool succeeded, const juce::String& message) {
+        juce::AlertWindow::showMessageBoxAsync(succeeded ? juce::AlertWindow::InfoIcon : juce::AlertWindow::WarningIcon,
+            "Capture History", message);
+    });
+}
+
 void IconMenu::removePluginsLackingInputOutput()
 {
     for (int i = activePluginList.getNumTypes() - 1; i >= 0; i--)
@@ -769,14 +2041,18 @@ void IconMenu::loadPluginBlacklist()
     {
         juce::StringArray tokens;
         tokens.addTokens(blacklistStr, "|", "");
-        std::unique_lock<std::mutex> lock(blacklistMutex);
+        std::unique_lock<ProfiledMutex> lock(blacklistMutex);
         pluginBlacklist = tokens;
     }
 }
 
 void IconMenu::savePluginBlacklist()
 {
-    juce::String blacklistStr = pluginBlacklist.joinIntoString("|");
+    juce::String blacklistStr;
+    {
+        std::unique_lock<ProfiledMutex> lock(blacklistMutex);
+        blacklistStr = pluginBlacklist.joinIntoString("|");
+    }
     
     getAppProperties().getUserSettings()->setValue("pluginBlacklist", blacklistStr);
     getAppProperties().getUserSettings()->saveIfNeeded();
@@ -787,7 +2063,7 @@ void IconMenu::clearBlacklist()
     juce::String pluginId = "";
     
     {
-        std::unique_lock<std::mutex> lock(blacklistMutex);
+        std::unique_lock<ProfiledMutex> lock(blacklistMutex);
         pluginBlacklist.clear();
     }
     
@@ -802,7 +2078,7 @@ void IconMenu::blacklistPlugin(const juce::PluginDescription& plugin)
     juce::String pluginId = plugin.createIdentifierString();
     
     {
-        std::unique_lock<std::mutex> lock(blacklistMutex);
+        std::unique_lock<ProfiledMutex> lock(blacklistMutex);
         if (pluginBlacklist.contains(pluginId))
             return;
             
@@ -817,7 +2093,7 @@ void IconMenu::blacklistPlugin(const juce::PluginDescription& plugin)
 
 bool IconMenu::isPluginBlacklisted(const juce::String& pluginId) const
 {
-    std::unique_lock<std::mutex> lock(blacklistMutex);
+    std::unique_lock<ProfiledMutex> lock(blacklistMutex);
     return pluginBlacklist.contains(pluginId);
 }
 
@@ -835,7 +2111,8 @@ void IconMenu::safePluginScan(juce::AudioPluginFormat* format, const juce::Strin
     }
     
     // Use safe plugin scanner if available
-    SafePluginScanner scanner;
+    SafePluginScanner scanner(formatManager, knownPluginList, formatName);
+    scanner.setCostModel(costModel);
     
     // Connect scanner to progress UI
     scanner.setProgressListener([splashScreen](float progress, const juce::String& message) {
@@ -864,6 +2141,8 @@ void IconMenu::safePluginScan(juce::AudioPluginFormat* format, const juce::Strin
         message = juce::String(numFound) + " " + formatName + " plugins found";
     }
     
+    saveCostModel();
+    
     juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::InfoIcon,
         "Plugin Scan Complete", message);
 }
@@ -10,6 +10,27 @@
 #define IconMenu_hpp
 
 #include <JuceHeader.h>
+#include "AnalyzerWindow.h"
+#include "CaptureHistory.h"
+#include "ChainAnalyzer.h"
+#include "ControllerMapper.h"
+#include "DeviceReconfigurationCoordinator.h"
+#include "DiskRecorder.h"
+#include "HostAudioCallback.h"
+#include "LinearChainProcessor.h"
+#include "LockStatsWindow.h"
+#include "MidiInputRouter.h"
+#include "ModulationEngine.h"
+#include "MonitorPath.h"
+#include "QuickAddPalette.h"
+#include "PluginCostModel.h"
+#include "PluginMemoryMonitor.h"
+#include "PluginPrefetcher.h"
+#include "PluginSearchIndex.h"
+#include "ProfiledMutex.h"
+#include "SessionFile.h"
+#include "ShutdownWatchdog.h"
+#include "SnapshotMorpher.h"
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -20,14 +41,17 @@ juce::ApplicationProperties& getAppProperties();
 class IconMenu : public juce::SystemTrayIconComponent, private juce::Timer, public juce::ChangeListener
 {
 public:
-    IconMenu();
+    explicit IconMenu(const juce::File& sessionFileToLoad = juce::File());
     ~IconMenu();
+    
+    /** Fades out, saves every plugin's state and the settings, then stops audio; the rest is left to the destructor */
+    void shutDown(const ShutdownWatchdog& watchdog);
     void mouseDown(const juce::MouseEvent&);
     static void menuInvocationCallback(int id, IconMenu*);
     void changeListenerCallback(juce::ChangeBroadcaster* changed) override;
     static juce::String getKey(juce::String type, juce::PluginDescription plugin);
 
-    const int INDEX_EDIT, INDEX_BYPASS, INDEX_DELETE, INDEX_MOVE_UP, INDEX_MOVE_DOWN;
+    const int INDEX_EDIT, INDEX_BYPASS, INDEX_DELETE, INDEX_MOVE_UP, INDEX_MOVE_DOWN, INDEX_MIDI, INDEX_SIDECHAIN;
 private:
     #if JUCE_MAC
     std::string exec(const char* cmd);
@@ -35,12 +59,45 @@ private:
     void timerCallback() override;
     void reloadPlugins();
     void showAudioSettings();
-    void loadActivePlugins();
+    /** Rebuilds the chain from the settings; the listed plugins keep their running instances */
+    void loadActivePlugins(const juce::StringArray& pluginsToKeep = {});
+    bool setBypassInLinearChain(const juce::PluginDescription& plugin, bool shouldBeBypassed);
+    MidiRoute getMidiRoute(const juce::PluginDescription& plugin);
+    void setMidiRoute(const juce::PluginDescription& plugin, const MidiRoute& route);
+    void handleMidiRouteItem(const juce::PluginDescription& plugin, int item);
+    void toggleMidiInputDevice(int index);
+    void addSidechainMenu(juce::PopupMenu& pluginSubMenu, const std::vector<juce::PluginDescription>& plugins, int index, int uid);
+    void handleSidechainItem(const juce::PluginDescription& plugin, int item);
+    void addControllerMenu(juce::PopupMenu& controllerMenu);
+    void saveControllerMappings();
+    void addModulationMenu(juce::PopupMenu& modulationMenu);
+    void handleModulationItem(int id);
+    void saveModulation();
+    void addSnapshotMenu(juce::PopupMenu& snapshotMenu);
+    void showAnalyzer();
+    void buildMonitorPath();
+    void addMonitorMenu(juce::PopupMenu& monitorMenu);
+    void reloadSession();
+    void applySession(const Session& next);
+    void writeSessionChain(const Session& next);
+    void reportSessionErrors(const juce::StringArray& errors);
+    void attachAnalyzer();
+    void saveAudioDeviceState();
+    void addPluginToChain(const juce::PluginDescription& plugin);
+    void insertPluginIntoChain(const juce::PluginDescription& plugin);
+    void saveCostModel();
     void startAudioDevice();
     void loadAllPluginLists();
     void savePluginStates();
     void deletePluginStates();
     void clearBlacklist();
+    void toggleRecording();
+    juce::File getRecordingDirectory();
+    void applyCaptureHistorySettings();
+    void saveCaptureHistory();
+    void applyMemoryBudgetSettings();
+    void handleMemoryOverBudget();
+    void hibernateBypassedPlugins();
     juce::PluginDescription getNextPluginOlderThanTime(int &time);
     void removePluginsLackingInputOutput();
     std::vector<juce::PluginDescription> getTimeSortedList();
@@ -62,18 +119,46 @@ private:
     std::unique_ptr<juce::PluginDirectoryScanner> scanner;
     bool menuIconLeftClicked;
     juce::AudioProcessorGraph graph;
+    LinearChainProcessor linearChain;
+    PluginMemoryMonitor memoryMonitor;
+    std::shared_ptr<PluginCostModel> costModel = std::make_shared<PluginCostModel>();  // shared with scanner threads
+    PluginPrefetcher prefetcher;
+    PluginSearchIndex searchIndex;
     juce::AudioProcessorPlayer player;
+    DiskRecorder recorder;
+    CaptureHistory captureHistory;
+    HostAudioCallback hostCallback;
+    MidiInputRouter midiRouter;
+    ControllerMapper controllerMapper;
+    ModulationEngine modulationEngine;
+    SnapshotMorpher snapshotMorpher;
+    ChainAnalyzer analyzer;
+    MonitorPath monitorPath;
+    juce::String analyzerSourcePlugin;                 // empty for the chain output
+    juce::AudioProcessorGraph::NodeID analyzerTapNode;
+    juce::File sessionFile;
+    Session runningSession;
+    bool sessionApplied = false;
+    bool hasShutDown = false;
+    bool usingLinearChain = false;                     // the graph ignores internal rates
+    SessionFileWatcher sessionWatcher;
+    DeviceReconfigurationCoordinator deviceCoordinator;
     juce::AudioProcessorGraph::Node* inputNode;
     juce::AudioProcessorGraph::Node* outputNode;
     juce::StringArray pluginBlacklist;
-    mutable std::mutex blacklistMutex;
-    std::mutex pluginLoadMutex; // For safely accessing plugin lists
+    mutable ProfiledMutex blacklistMutex { "IconMenu blacklist" };
+    ProfiledMutex pluginLoadMutex { "IconMenu plugin load" }; // For safely accessing plugin lists
     #if JUCE_WINDOWS
     int x, y;
     #endif
 
     class PluginListWindow;
     std::unique_ptr<PluginListWindow> pluginListWindow;
+    std::unique_ptr<LockStatsWindow> lockStatsWindow;
+    std::unique_ptr<AnalyzerWindow> analyzerWindow;
+    std::unique_ptr<QuickAddPalette> quickAddPalette;
+    std::vector<std::pair<juce::String, int>> learnChoices; // plugin identifier and parameter index per learn menu item
+    std::vector<ModulationRoute> modulationChoices;         // the route each modulation target menu item would add
 };
 
 #endif /* IconMenu_hpp */
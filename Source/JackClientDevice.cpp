@@ -0,0 +1,403 @@
+//
+// JackClientDevice.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "JackClientDevice.h"
+
+#if NOVAHOST_JACK_CLIENT
+
+namespace
+{
+    const char* const serverDeviceName = "JACK Server";
+}
+
+//==============================================================================
+JackClientAudioIODevice::JackClientAudioIODevice(const juce::String& clientNameToUse, const juce::String& chainName,
+                                                 int numChannelsPerChain, bool autoConnectPhysicalPorts)
+    : juce::AudioIODevice(serverDeviceName, JackClientAudioIODeviceType::typeName),
+      clientName(clientNameToUse),
+      autoConnect(autoConnectPhysicalPorts)
+{
+    for (int i = 1; i <= juce::jmax(1, numChannelsPerChain); ++i)
+    {
+        inputNames.add(chainName + "_in_" + juce::String(i));
+        outputNames.add(chainName + "_out_" + juce::String(i));
+    }
+}
+
+JackClientAudioIODevice::~JackClientAudioIODevice()
+{
+    close();
+}
+
+juce::Array<double> JackClientAudioIODevice::getAvailableSampleRates()
+{
+    // The server owns the clock - we can only follow whatever it runs at
+    if (client != nullptr)
+        return { (double) jack_get_sample_rate(client) };
+
+    return { sampleRate > 0.0 ? sampleRate : 48000.0 };
+}
+
+juce::Array<int> JackClientAudioIODevice::getAvailableBufferSizes()
+{
+    if (client != nullptr)
+        return { (int) jack_get_buffer_size(client) };
+
+    return { getDefaultBufferSize() };
+}
+
+int JackClientAudioIODevice::getDefaultBufferSize()
+{
+    return bufferSize > 0 ? bufferSize : 256;
+}
+
+juce::String JackClientAudioIODevice::open(const juce::BigInteger& inputChannels, const juce::BigInteger& outputChannels,
+                                           double, int)
+{
+    close();
+    lastError.clear();
+
+    jack_status_t status;
+    client = jack_client_open(clientName.toRawUTF8(), JackNoStartServer, &status);
+
+    if (client == nullptr)
+    {
+        lastError = "Could not connect to a JACK server (status " + juce::String((int) status) + ")";
+        return lastError;
+    }
+
+    activeInputs = inputChannels;
+    activeInputs.setRange(inputNames.size(), activeInputs.getHighestBit() + 1, false);
+    activeOutputs = outputChannels;
+    activeOutputs.setRange(outputNames.size(), activeOutputs.getHighestBit() + 1, false);
+
+    // Ports are registered up front so the real-time callback never has to
+    if (! registerPorts(inputNames, activeInputs, JackPortIsInput, inputPorts)
+        || ! registerPorts(outputNames, activeOutputs, JackPortIsOutput, outputPorts))
+    {
+        close();
+        return lastError;
+    }
+
+    inputBuffers.resize(inputPorts.size(), nullptr);
+    outputBuffers.resize(outputPorts.size(), nullptr);
+
+    sampleRate = (double) jack_get_sample_rate(client);
+    bufferSize = (int) jack_get_buffer_size(client);
+    serverSampleRate.store(sampleRate);
+    serverBufferSize.store(bufferSize);
+    formatChangePending.store(false);
+    muted.store(false);
+    serverShutDown.store(false);
+
+    jack_set_process_callback(client, processCallback, this);
+    jack_set_buffer_size_callback(client, bufferSizeCallback, this);
+    jack_set_sample_rate_callback(client, sampleRateCallback, this);
+    jack_set_xrun_callback(client, xrunCallback, this);
+    jack_on_shutdown(client, shutdownCallback, this);
+
+    if (jack_activate(client) != 0)
+    {
+        lastError = "Could not activate the JACK client";
+        close();
+        return lastError;
+    }
+
+    if (autoConnect)
+        connectToPhysicalPorts();
+
+    juce::Logger::writeToLog("JACK client '" + juce::String(jack_get_client_name(client)) + "' running at "
+                             + juce::String(sampleRate) + " Hz, " + juce::String(bufferSize) + " frames");
+    return {};
+}
+
+void JackClientAudioIODevice::close()
+{
+    stop();
+
+    if (client != nullptr)
+    {
+        jack_deactivate(client);
+        jack_client_close(client);
+        client = nullptr;
+    }
+
+    // No JACK thread can flag anything any more
+    cancelPendingUpdate();
+    formatChangePending.store(false);
+    muted.store(false);
+
+    inputPorts.clear();
+    outputPorts.clear();
+    inputBuffers.clear();
+    outputBuffers.clear();
+}
+
+bool JackClientAudioIODevice::registerPorts(const juce::StringArray& names, const juce::BigInteger& active,
+                                            unsigned long flags, std::vector<jack_port_t*>& ports)
+{
+    for (int i = 0; i < names.size(); ++i)
+    {
+        if (! active[i])
+            continue;
+
+        jack_port_t* port = jack_port_register(client, names[i].toRawUTF8(), JACK_DEFAULT_AUDIO_TYPE, flags, 0);
+        if (port == nullptr)
+        {
+            lastError = "Could not register the JACK port " + names[i];
+            return false;
+        }
+
+        ports.push_back(port);
+    }
+
+    return true;
+}
+
+void JackClientAudioIODevice::start(juce::AudioIODeviceCallback* callback)
+{
+    if (client == nullptr || callback == nullptr)
+        return;
+
+    callback->audioDeviceAboutToStart(this);
+
+    const juce::ScopedLock sl(callbackLock);
+    currentCallback = callback;
+}
+
+void JackClientAudioIODevice::stop()
+{
+    juce::AudioIODeviceCallback* oldCallback = nullptr;
+
+    {
+        const juce::ScopedLock sl(callbackLock);
+        std::swap(oldCallback, currentCallback);
+    }
+
+    if (oldCallback != nullptr)
+        oldCallback->audioDeviceStopped();
+}
+
+int JackClientAudioIODevice::getPortLatency(const std::vector<jack_port_t*>& ports, jack_latency_callback_mode_t mode) const
+{
+    jack_nframes_t maxLatency = 0;
+
+    for (auto* port : ports)
+    {
+        jack_latency_range_t range;
+        jack_port_get_latency_range(port, mode, &range);
+        maxLatency = juce::jmax(maxLatency, range.max);
+    }
+
+    return (int) maxLatency;
+}
+
+int JackClientAudioIODevice::getOutputLatencyInSamples()
+{
+    return getPortLatency(outputPorts, JackPlaybackLatency);
+}
+
+int JackClientAudioIODevice::getInputLatencyInSamples()
+{
+    return getPortLatency(inputPorts, JackCaptureLatency);
+}
+
+void JackClientAudioIODevice::connectToPhysicalPorts()
+{
+    // Pair our chain ports with the physical ports in order, leaving any extras unconnected
+    if (const char** capturePorts = jack_get_ports(client, nullptr, JACK_DEFAULT_AUDIO_TYPE,
+                                                   JackPortIsPhysical | JackPortIsOutput))
+    {
+        for (size_t i = 0; i < inputPorts.size() && capturePorts[i] != nullptr; ++i)
+            jack_connect(client, capturePorts[i], jack_port_name(inputPorts[i]));
+
+        jack_free(capturePorts);
+    }
+
+    if (const char** playbackPorts = jack_get_ports(client, nullptr, JACK_DEFAULT_AUDIO_TYPE,
+                                                    JackPortIsPhysical | JackPortIsInput))
+    {
+        for (size_t i = 0; i < outputPorts.size() && playbackPorts[i] != nullptr; ++i)
+            jack_connect(client, jack_port_name(outputPorts[i]), playbackPorts[i]);
+
+        jack_free(playbackPorts);
+    }
+}
+
+void JackClientAudioIODevice::process(int numFrames) noexcept
+{
+    for (size_t i = 0; i < inputPorts.size(); ++i)
+        inputBuffers[i] = static_cast<const float*>(jack_port_get_buffer(inputPorts[i], (jack_nframes_t) numFrames));
+
+    for (size_t i = 0; i < outputPorts.size(); ++i)
+        outputBuffers[i] = static_cast<float*>(jack_port_get_buffer(outputPorts[i], (jack_nframes_t) numFrames));
+
+    const juce::ScopedTryLock stl(callbackLock);
+
+    if (stl.isLocked() && currentCallback != nullptr && ! muted.load())
+    {
+        currentCallback->audioDeviceIOCallbackWithContext(inputBuffers.data(), (int) inputBuffers.size(),
+                                                          outputBuffers.data(), (int) outputBuffers.size(),
+                                                          numFrames, {});
+    }
+    else
+    {
+        // Starting, stopping or waiting to be re-prepared - keep the server fed with silence
+        for (auto* buffer : outputBuffers)
+            juce::FloatVectorOperations::clear(buffer, numFrames);
+    }
+}
+
+void JackClientAudioIODevice::handleAsyncUpdate()
+{
+    if (serverShutDown.exchange(false))
+    {
+        // The server is gone and the client handle is dead, so only report it - close() runs later
+        lastError = "The JACK server shut down";
+
+        const juce::ScopedLock sl(callbackLock);
+        if (currentCallback != nullptr)
+            currentCallback->audioDeviceError(lastError);
+        return;
+    }
+
+    // The flag is cleared before the new format is read, so a change that arrives while the chain is
+    // being re-prepared is picked up by another pass rather than lost
+    for (;;)
+    {
+        if (! formatChangePending.exchange(false))
+        {
+            // Every JACK callback triggers another update after its stores, so this clears a late mute
+            muted.store(false);
+
+            // A change flagged just before unmuting stays silent until its own pass
+            if (! formatChangePending.load())
+                break;
+
+            muted.store(true);
+            continue;
+        }
+
+        const double newSampleRate = serverSampleRate.load();
+        const int newBufferSize = serverBufferSize.load();
+
+        if (newSampleRate != sampleRate || newBufferSize != bufferSize)
+        {
+            sampleRate = newSampleRate;
+            bufferSize = newBufferSize;
+
+            juce::Logger::writeToLog("JACK server changed to " + juce::String(sampleRate) + " Hz, "
+                                     + juce::String(bufferSize) + " frames");
+        }
+
+        // The process callback outputs silence while muted, so the chain can be re-prepared in place
+        // without tearing down any plugin instances or rebuilding the graph
+        {
+            const juce::ScopedLock sl(callbackLock);
+
+            if (currentCallback != nullptr)
+            {
+                currentCallback->audioDeviceStopped();
+                currentCallback->audioDeviceAboutToStart(this);
+            }
+        }
+    }
+}
+
+int JackClientAudioIODevice::processCallback(jack_nframes_t numFrames, void* arg)
+{
+    static_cast<JackClientAudioIODevice*>(arg)->process((int) numFrames);
+    return 0;
+}
+
+int JackClientAudioIODevice::bufferSizeCallback(jack_nframes_t newBufferSize, void* arg)
+{
+    auto* device = static_cast<JackClientAudioIODevice*>(arg);
+    device->serverBufferSize.store((int) newBufferSize);
+    device->formatChangePending.store(true);
+    device->muted.store(true);
+    device->triggerAsyncUpdate();
+    return 0;
+}
+
+int JackClientAudioIODevice::sampleRateCallback(jack_nframes_t newSampleRate, void* arg)
+{
+    auto* device = static_cast<JackClientAudioIODevice*>(arg);
+    device->serverSampleRate.store((double) newSampleRate);
+    device->formatChangePending.store(true);
+    device->muted.store(true);
+    device->triggerAsyncUpdate();
+    return 0;
+}
+
+int JackClientAudioIODevice::xrunCallback(void* arg)
+{
+    static_cast<JackClientAudioIODevice*>(arg)->xruns++;
+    return 0;
+}
+
+void JackClientAudioIODevice::shutdownCallback(void* arg)
+{
+    auto* device = static_cast<JackClientAudioIODevice*>(arg);
+    device->serverShutDown.store(true);
+    device->triggerAsyncUpdate();
+}
+
+//==============================================================================
+JackClientAudioIODeviceType::JackClientAudioIODeviceType(const juce::String& clientNameToUse, const juce::String& chainNameToUse,
+                                                         int channelsPerChain, bool autoConnectPhysicalPorts)
+    : juce::AudioIODeviceType(typeName),
+      clientName(clientNameToUse),
+      chainName(chainNameToUse),
+      numChannelsPerChain(channelsPerChain),
+      autoConnect(autoConnectPhysicalPorts)
+{
+}
+
+void JackClientAudioIODeviceType::scanForDevices()
+{
+    // Probe for a running server without ever starting one ourselves
+    jack_status_t status;
+    if (jack_client_t* probe = jack_client_open("Nova Host probe", JackNoStartServer, &status))
+    {
+        jack_client_close(probe);
+        serverAvailable = true;
+    }
+    else
+    {
+        serverAvailable = false;
+    }
+}
+
+juce::StringArray JackClientAudioIODeviceType::getDeviceNames(bool) const
+{
+    if (serverAvailable)
+        return { serverDeviceName };
+
+    return {};
+}
+
+int JackClientAudioIODeviceType::getDefaultDeviceIndex(bool) const
+{
+    return serverAvailable ? 0 : -1;
+}
+
+int JackClientAudioIODeviceType::getIndexOfDevice(juce::AudioIODevice* device, bool) const
+{
+    return dynamic_cast<JackClientAudioIODevice*>(device) != nullptr ? 0 : -1;
+}
+
+juce::AudioIODevice* JackClientAudioIODeviceType::createDevice(const juce::String& outputDeviceName,
+                                                               const juce::String& inputDeviceName)
+{
+    if (outputDeviceName == serverDeviceName || inputDeviceName == serverDeviceName)
+        return new JackClientAudioIODevice(clientName, chainName, numChannelsPerChain, autoConnect);
+
+    return nullptr;
+}
+
+#endif
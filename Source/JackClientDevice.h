@@ -0,0 +1,131 @@
+//
+// JackClientDevice.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+#if NOVAHOST_JACK_CLIENT
+
+#include <jack/jack.h>
+#include <atomic>
+#include <vector>
+
+/**
+ * Runs the host as a regular JACK (or PipeWire-JACK) client instead of opening the hardware
+ * Each chain gets its own named input and output ports and is processed directly inside the
+ * JACK process callback; server buffer size and sample rate changes re-prepare the chain in place
+ *
+ * JACK's notification callbacks only flag what happened: the re-prepare and the error report run on
+ * the message thread, and the process callback outputs silence until the chain has caught up.
+ */
+class JackClientAudioIODevice : public juce::AudioIODevice,
+                                private juce::AsyncUpdater
+{
+public:
+    JackClientAudioIODevice(const juce::String& clientName, const juce::String& chainName,
+                            int numChannelsPerChain, bool autoConnectPhysicalPorts);
+    ~JackClientAudioIODevice() override;
+
+    juce::StringArray getOutputChannelNames() override  { return outputNames; }
+    juce::StringArray getInputChannelNames() override   { return inputNames; }
+    juce::Array<double> getAvailableSampleRates() override;
+    juce::Array<int> getAvailableBufferSizes() override;
+    int getDefaultBufferSize() override;
+
+    juce::String open(const juce::BigInteger& inputChannels, const juce::BigInteger& outputChannels,
+                      double sampleRate, int bufferSizeSamples) override;
+    void close() override;
+    bool isOpen() override                                { return client != nullptr; }
+
+    void start(juce::AudioIODeviceCallback* callback) override;
+    void stop() override;
+    bool isPlaying() override                             { return currentCallback != nullptr; }
+
+    juce::String getLastError() override                  { return lastError; }
+    int getCurrentBufferSizeSamples() override            { return bufferSize; }
+    double getCurrentSampleRate() override                { return sampleRate; }
+    int getCurrentBitDepth() override                     { return 32; }
+    juce::BigInteger getActiveOutputChannels() const override { return activeOutputs; }
+    juce::BigInteger getActiveInputChannels() const override  { return activeInputs; }
+    int getOutputLatencyInSamples() override;
+    int getInputLatencyInSamples() override;
+    int getXRunCount() const noexcept override            { return xruns.load(); }
+
+private:
+    static int processCallback(jack_nframes_t numFrames, void* arg);
+    static int bufferSizeCallback(jack_nframes_t newBufferSize, void* arg);
+    static int sampleRateCallback(jack_nframes_t newSampleRate, void* arg);
+    static int xrunCallback(void* arg);
+    static void shutdownCallback(void* arg);
+
+    void process(int numFrames) noexcept;
+    void handleAsyncUpdate() override;
+    bool registerPorts(const juce::StringArray& names, const juce::BigInteger& active,
+                       unsigned long flags, std::vector<jack_port_t*>& ports);
+    void connectToPhysicalPorts();
+    int getPortLatency(const std::vector<jack_port_t*>& ports, jack_latency_callback_mode_t mode) const;
+
+    const juce::String clientName;
+    const bool autoConnect;
+    juce::StringArray inputNames, outputNames;
+
+    jack_client_t* client = nullptr;
+    std::vector<jack_port_t*> inputPorts, outputPorts;
+    std::vector<const float*> inputBuffers;
+    std::vector<float*> outputBuffers;
+
+    juce::BigInteger activeInputs, activeOutputs;
+    double sampleRate = 0.0;
+    int bufferSize = 0;
+    juce::String lastError;
+    std::atomic<int> xruns { 0 };
+
+    // Written by JACK's threads, picked up in handleAsyncUpdate()
+    std::atomic<double> serverSampleRate { 0.0 };
+    std::atomic<int> serverBufferSize { 0 };
+    std::atomic<bool> formatChangePending { false };
+    std::atomic<bool> serverShutDown { false };
+
+    // Set with formatChangePending, cleared only once the chain is prepared for the new format
+    std::atomic<bool> muted { false };
+
+    juce::CriticalSection callbackLock;
+    juce::AudioIODeviceCallback* currentCallback = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(JackClientAudioIODevice)
+};
+
+/**
+ * Device type that exposes the JACK client mode in the audio settings
+ */
+class JackClientAudioIODeviceType : public juce::AudioIODeviceType
+{
+public:
+    static constexpr const char* typeName = "Nova Host JACK Client";
+
+    JackClientAudioIODeviceType(const juce::String& clientName, const juce::String& chainName,
+                                int numChannelsPerChain, bool autoConnectPhysicalPorts);
+
+    void scanForDevices() override;
+    juce::StringArray getDeviceNames(bool wantInputNames = false) const override;
+    int getDefaultDeviceIndex(bool forInput) const override;
+    int getIndexOfDevice(juce::AudioIODevice* device, bool asInput) const override;
+    bool hasSeparateInputsAndOutputs() const override    { return false; }
+    juce::AudioIODevice* createDevice(const juce::String& outputDeviceName,
+                                      const juce::String& inputDeviceName) override;
+
+private:
+    const juce::String clientName, chainName;
+    const int numChannelsPerChain;
+    const bool autoConnect;
+    bool serverAvailable = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(JackClientAudioIODeviceType)
+};
+
+#endif
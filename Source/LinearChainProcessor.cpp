@@ -0,0 +1,364 @@
+//
+// LinearChainProcessor.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "LinearChainProcessor.h"
+#include <future>
+#include <vector>
+
+namespace
+{
+    const size_t maxPrepareThreads = 4;
+}
+
+// VST, VST3 and AU expect to be called on the message thread; LADSPA and LV2 instances are independent
+bool LinearChainProcessor::canPrepareConcurrently(const juce::AudioProcessor* processor)
+{
+    auto* instance = dynamic_cast<const juce::AudioPluginInstance*>(processor);
+    if (instance == nullptr)
+        return false;
+
+    const juce::String format = instance->getPluginDescription().pluginFormatName;
+    return format == "LADSPA" || format == "LV2";
+}
+
+LinearChainProcessor::LinearChainProcessor()
+    : juce::AudioProcessor(BusesProperties()
+                               .withInput("Input", juce::AudioChannelSet::stereo(), true)
+                               .withOutput("Output", juce::AudioChannelSet::stereo(), true))
+{
+}
+
+LinearChainProcessor::~LinearChainProcessor()
+{
+    clearStages();
+}
+
+void LinearChainProcessor::addStage(juce::AudioProcessor* processor, bool bypassed)
+{
+    // Changing the stage list under a running player would race the audio thread
+    jassert(! prepared);
+
+    if (processor == nullptr)
+        return;
+
+    auto* stage = stages.add(new Stage());
+    stage->processor = processor;
+    stage->bypassed.store(bypassed);
+    stage->numInputs = processor->getTotalNumInputChannels();
+    stage->numOutputs = processor->getTotalNumOutputChannels();
+    stage->producesMidi = processor->producesMidi();
+}
+
+void LinearChainProcessor::clearStages()
+{
+    jassert(! prepared);
+    stages.clear();
+}
+
+int LinearChainProcessor::indexOfStage(const juce::AudioProcessor* processor) const noexcept
+{
+    for (int i = 0; i < stages.size(); ++i)
+        if (stages.getUnchecked(i)->processor == processor)
+            return i;
+
+    return -1;
+}
+
+juce::AudioProcessor* LinearChainProcessor::getStageProcessor(int index) const noexcept
+{
+    auto* stage = stages[index];
+    return stage != nullptr ? stage->processor : nullptr;
+}
+
+double LinearChainProcessor::takeStageSecondsPerSample(int index) noexcept
+{
+    auto* stage = stages[index];
+    if (stage == nullptr)
+        return -1.0;
+
+    const juce::int64 samples = stage->processedSamples.exchange(0);
+    const juce::int64 ticks = stage->processTicks.exchange(0);
+    return samples > 0 ? juce::Time::highResolutionTicksToSeconds(ticks) / (double) samples : -1.0;
+}
+
+void LinearChainProcessor::setStageBypassed(int index, bool shouldBeBypassed) noexcept
+{
+    if (auto* stage = stages[index])
+    {
+        stage->bypassed.store(shouldBeBypassed);
+        updateLatency();
+    }
+}
+
+void LinearChainProcessor::setStageMidiRoute(int index, const MidiRoute& route) noexcept
+{
+    if (auto* stage = stages[index])
+        stage->midiRoute.store(route.pack());
+}
+
+void LinearChainProcessor::setStageTap(int index, HostAudioTap* tap) noexcept
+{
+    if (auto* stage = stages[index])
+        stage->outputTap.store(tap);
+}
+
+void LinearChainProcessor::clearStageTaps() noexcept
+{
+    for (auto* stage : stages)
+        stage->outputTap.store(nullptr);
+}
+
+void LinearChainProcessor::setStageRateDivisor(int index, int divisor)
+{
+    jassert(! prepared);
+
+    if (auto* stage = stages[index])
+    {
+        stage->rateDivisor = juce::jlimit(1, SampleRateBridge::maxFactor, divisor);
+        stage->bridge.reset(stage->rateDivisor > 1 ? new SampleRateBridge(stage->rateDivisor) : nullptr);
+    }
+}
+
+int LinearChainProcessor::getStageRateDivisor(int index) const noexcept
+{
+    auto* stage = stages[index];
+    return stage != nullptr ? stage->rateDivisor : 1;
+}
+
+bool LinearChainProcessor::isStageBypassed(int index) const noexcept
+{
+    auto* stage = stages[index];
+    return stage != nullptr && stage->bypassed.load();
+}
+
+//==============================================================================
+bool LinearChainProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+    // Channel count changes are handled per stage, so any non-empty layout works
+    return ! layouts.getMainOutputChannelSet().isDisabled();
+}
+
+void LinearChainProcessor::prepareToPlay(double sampleRate, int maximumExpectedSamplesPerBlock)
+{
+    maxStageChannels = juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels());
+
+    // Stages that allow it are prepared on the pool while the rest are prepared here
+    std::vector<std::future<void>> pendingStages;
+
+    for (auto* stage : stages)
+    {
+        auto* processor = stage->processor;
+
+        // A bridged stage is prepared at its own rate, by the bridge
+        if (stage->bridge != nullptr)
+        {
+            stage->bridge->prepare(*processor, sampleRate, maximumExpectedSamplesPerBlock);
+            continue;
+        }
+
+        processor->setRateAndBufferSizeDetails(sampleRate, maximumExpectedSamplesPerBlock);
+
+        if (stages.size() > 1 && canPrepareConcurrently(processor))
+        {
+            if (preparePool == nullptr)
+                preparePool = std::make_unique<ThreadPool>(maxPrepareThreads);
+
+            pendingStages.push_back(preparePool->addJob([processor, sampleRate, maximumExpectedSamplesPerBlock]
+            {
+                processor->prepareToPlay(sampleRate, maximumExpectedSamplesPerBlock);
+            }));
+        }
+        else
+        {
+            processor->prepareToPlay(sampleRate, maximumExpectedSamplesPerBlock);
+        }
+    }
+
+    for (auto& pending : pendingStages)
+        pending.get();
+
+    for (auto* stage : stages)
+    {
+        // Plugins may only settle their channel configuration once prepared
+        stage->numInputs = stage->processor->getTotalNumInputChannels();
+        stage->numOutputs = stage->processor->getTotalNumOutputChannels();
+        maxStageChannels = juce::jmax(maxStageChannels, stage->numInputs, stage->numOutputs);
+    }
+
+    workBuffer.setSize(juce::jmax(1, maxStageChannels), maximumExpectedSamplesPerBlock);
+    channelPointers.malloc((size_t) juce::jmax(1, maxStageChannels));
+    sliceMidi.ensureSize(MidiRoute::maxBlockBytes);
+    blockMidi.ensureSize(MidiRoute::maxBlockBytes);
+    stageMidi.ensureSize(MidiRoute::maxBlockBytes);
+    carriedMidi.ensureSize(MidiRoute::maxBlockBytes);
+    preparedBlockSize = juce::jmax(1, maximumExpectedSamplesPerBlock);
+    prepared = true;
+
+    updateLatency();
+}
+
+void LinearChainProcessor::releaseResources()
+{
+    for (auto* stage : stages)
+        stage->processor->releaseResources();
+
+    prepared = false;
+}
+
+void LinearChainProcessor::setNonRealtime(bool isNonRealtime) noexcept
+{
+    juce::AudioProcessor::setNonRealtime(isNonRealtime);
+
+    for (auto* stage : stages)
+        stage->processor->setNonRealtime(isNonRealtime);
+}
+
+double LinearChainProcessor::getTailLengthSeconds() const
+{
+    double tail = 0.0;
+    for (auto* stage : stages)
+        tail = juce::jmax(tail, stage->processor->getTailLengthSeconds());
+    return tail;
+}
+
+void LinearChainProcessor::updateLatency()
+{
+    int latency = 0;
+    for (auto* stage : stages)
+        if (! stage->bypassed.load())
+            latency += stage->bridge != nullptr ? stage->bridge->getLatencySamples(*stage->processor)
+                                                : stage->processor->getLatencySamples();
+
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+}
+
+//==============================================================================
+void LinearChainProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    const int numSamples = buffer.getNumSamples();
+
+    if (! prepared)
+    {
+        buffer.clear();
+        return;
+    }
+
+    // Device MIDI from the router joins whatever the player passed in
+    const juce::MidiBuffer* inputMidi = &midiMessages;
+    if (midiRouter != nullptr && ! midiRouter->getCurrentBlock().isEmpty())
+    {
+        blockMidi.clear();
+        const MidiRoute everything;
+        everything.apply(midiMessages, blockMidi);
+        everything.apply(midiRouter->getCurrentBlock(), blockMidi);
+        inputMidi = &blockMidi;
+    }
+
+    if (numSamples <= preparedBlockSize)
+    {
+        processSlice(buffer, 0, numSamples, *inputMidi);
+    }
+    else
+    {
+        // Some devices deliver more than they announced - never hand a plugin more than it was prepared for
+        for (int start = 0; start < numSamples; start += preparedBlockSize)
+        {
+            const int sliceLength = juce::jmin(preparedBlockSize, numSamples - start);
+            sliceMidi.clear();
+            for (const auto metadata : *inputMidi)
+                if (metadata.samplePosition >= start && metadata.samplePosition < start + sliceLength)
+                    MidiRoute::addIfRoom(sliceMidi, metadata.data, metadata.numBytes, metadata.samplePosition - start);
+            processSlice(buffer, start, sliceLength, sliceMidi);
+        }
+    }
+
+    // The chain's MIDI output goes nowhere
+    midiMessages.clear();
+}
+
+void LinearChainProcessor::processSlice(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                                        const juce::MidiBuffer& inputMidi) noexcept
+{
+    const int hostChannels = buffer.getNumChannels();
+    const bool useWorkBuffer = maxStageChannels > hostChannels;
+
+    // Normally every stage runs directly on the device buffer; the work buffer only comes into
+    // play when some stage wants more channels than the device provides
+    if (useWorkBuffer)
+    {
+        for (int ch = 0; ch < hostChannels; ++ch)
+            workBuffer.copyFrom(ch, 0, buffer, ch, startSample, numSamples);
+        for (int ch = hostChannels; ch < maxStageChannels; ++ch)
+            workBuffer.clear(ch, 0, numSamples);
+        for (int ch = 0; ch < maxStageChannels; ++ch)
+            channelPointers[ch] = workBuffer.getWritePointer(ch);
+    }
+    else
+    {
+        for (int ch = 0; ch < maxStageChannels; ++ch)
+            channelPointers[ch] = buffer.getWritePointer(ch, startSample);
+    }
+
+    const int availableChannels = maxStageChannels;
+    int activeChannels = getTotalNumInputChannels();
+    carriedMidi.clear();
+
+    for (auto* stage : stages)
+    {
+        if (stage->bypassed.load(std::memory_order_relaxed))
+            continue;
+
+        const int stageChannels = juce::jmin(availableChannels, juce::jmax(stage->numInputs, stage->numOutputs));
+
+        // Inputs the previous stage did not produce must not carry its stale scratch data
+        for (int ch = activeChannels; ch < juce::jmin(stage->numInputs, stageChannels); ++ch)
+            juce::FloatVectorOperations::clear(channelPointers[ch], numSamples);
+
+        juce::AudioBuffer<float> view(channelPointers.get(), stageChannels, numSamples);
+
+        stageMidi.clear();
+        MidiRoute::unpack(stage->midiRoute.load(std::memory_order_relaxed)).apply(inputMidi, stageMidi);
+        const MidiRoute everything;
+        everything.apply(carriedMidi, stageMidi);
+
+        const juce::ScopedLock sl(stage->processor->getCallbackLock());
+
+        if (stage->processor->isSuspended())
+        {
+            view.clear();
+        }
+        else
+        {
+            const juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+            if (stage->bridge != nullptr)
+                stage->bridge->process(*stage->processor, view, stageMidi);
+            else
+                stage->processor->processBlock(view, stageMidi);
+            stage->processTicks.fetch_add(juce::Time::getHighResolutionTicks() - startTicks, std::memory_order_relaxed);
+            stage->processedSamples.fetch_add(numSamples, std::memory_order_relaxed);
+        }
+
+        activeChannels = stage->numOutputs;
+
+        if (auto* tap = stage->outputTap.load(std::memory_order_relaxed))
+            tap->tapOutput(channelPointers.get(), juce::jmin(stageChannels, stage->numOutputs), numSamples);
+
+        // What a MIDI-producing stage left in its buffer is its output, for the next stage
+        if (stage->producesMidi)
+            carriedMidi.swapWith(stageMidi);
+        else
+            carriedMidi.clear();
+    }
+
+    for (int ch = juce::jmax(0, activeChannels); ch < juce::jmin(getTotalNumOutputChannels(), availableChannels); ++ch)
+        juce::FloatVectorOperations::clear(channelPointers[ch], numSamples);
+
+    if (useWorkBuffer)
+        for (int ch = 0; ch < hostChannels; ++ch)
+            buffer.copyFrom(ch, startSample, workBuffer, ch, 0, numSamples);
+}
@@ -0,0 +1,133 @@
+//
+// LinearChainProcessor.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "HostAudioCallback.h"
+#include "MidiInputRouter.h"
+#include "SampleRateBridge.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <memory>
+
+/**
+ * Runs a strictly serial chain of processors in place on a single buffer
+ * This is what the host plays when the topology is a plain chain: there are no per-node buffer
+ * copies or connection bookkeeping, and bypassed stages are skipped by flag instead of rewiring
+ *
+ * The processors are not owned - the AudioProcessorGraph still holds the nodes so editor windows
+ * and lookups keep working. Stages may only be added or cleared while this processor is not
+ * attached to a player.
+ *
+ * When the device changes, stages of formats that can be set up off the message thread are
+ * prepared in parallel, so re-preparing a long chain does not take the sum of every plugin.
+ *
+ * A stage can run at a fraction of the device rate behind a SampleRateBridge, which makes
+ * plugins that oversample internally or scale with the rate cheaper at high device rates.
+ */
+class LinearChainProcessor : public juce::AudioProcessor
+{
+public:
+    LinearChainProcessor();
+    ~LinearChainProcessor() override;
+
+    /** Appends a stage to the end of the chain */
+    void addStage(juce::AudioProcessor* processor, bool bypassed);
+    void clearStages();
+
+    int getNumStages() const noexcept                       { return stages.size(); }
+
+    /** Index of the stage running the given processor, or -1 */
+    int indexOfStage(const juce::AudioProcessor* processor) const noexcept;
+    juce::AudioProcessor* getStageProcessor(int index) const noexcept;
+
+    /** CPU time the stage took per sample since the last call, or -1 if it processed nothing */
+    double takeStageSecondsPerSample(int index) noexcept;
+    int getPreparedBlockSize() const noexcept               { return preparedBlockSize; }
+
+    /** Runs the stage at the sample rate divided by divisor, 1 for the device rate; only while not prepared */
+    void setStageRateDivisor(int index, int divisor);
+    int getStageRateDivisor(int index) const noexcept;
+
+    /** Bypass can be toggled at any time, including while audio is running */
+    void setStageBypassed(int index, bool shouldBeBypassed) noexcept;
+    bool isStageBypassed(int index) const noexcept;
+
+    /** Which device MIDI the stage receives; can be changed while audio is running */
+    void setStageMidiRoute(int index, const MidiRoute& route) noexcept;
+
+    /** Hands the stage's output to a tap after every block it processes; nullptr removes it */
+    void setStageTap(int index, HostAudioTap* tap) noexcept;
+    void clearStageTaps() noexcept;
+
+    /** Adds the router's device MIDI to every block; only while not attached to a player */
+    void setMidiInput(const MidiInputRouter* router) noexcept  { midiRouter = router; }
+
+    /** Whether a plugin may be set up or queried off the message thread, alongside other plugins */
+    static bool canPrepareConcurrently(const juce::AudioProcessor* processor);
+
+    //==============================================================================
+    const juce::String getName() const override             { return "Linear Chain"; }
+    void prepareToPlay(double sampleRate, int maximumExpectedSamplesPerBlock) override;
+    void releaseResources() override;
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override;
+    void setNonRealtime(bool isNonRealtime) noexcept override;
+
+    double getTailLengthSeconds() const override;
+    bool acceptsMidi() const override                       { return true; }
+    bool producesMidi() const override                      { return true; }
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
+
+    juce::AudioProcessorEditor* createEditor() override     { return nullptr; }
+    bool hasEditor() const override                         { return false; }
+
+    int getNumPrograms() override                           { return 1; }
+    int getCurrentProgram() override                        { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override         { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+
+    void getStateInformation(juce::MemoryBlock&) override {}
+    void setStateInformation(const void*, int) override {}
+
+private:
+    struct Stage
+    {
+        juce::AudioProcessor* processor = nullptr;
+        std::atomic<bool> bypassed { false };
+        int numInputs = 0, numOutputs = 0;
+        bool producesMidi = false;
+        std::atomic<juce::int64> processTicks { 0 }, processedSamples { 0 };
+        std::atomic<juce::uint64> midiRoute { MidiRoute().pack() };
+        std::atomic<HostAudioTap*> outputTap { nullptr };
+        int rateDivisor = 1;
+        std::unique_ptr<SampleRateBridge> bridge;   // only while rateDivisor > 1
+    };
+
+    void processSlice(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                      const juce::MidiBuffer& inputMidi) noexcept;
+    void updateLatency();
+
+    juce::OwnedArray<Stage> stages;
+
+    // Used only when a stage needs more channels than the device buffer provides
+    juce::AudioBuffer<float> workBuffer;
+    juce::HeapBlock<float*> channelPointers;
+    juce::MidiBuffer sliceMidi;
+
+    // Each stage gets the routed input plus whatever MIDI the previous stage produced
+    const MidiInputRouter* midiRouter = nullptr;
+    juce::MidiBuffer blockMidi, stageMidi, carriedMidi;
+    int maxStageChannels = 0;
+    int preparedBlockSize = 0;
+    bool prepared = false;
+
+    std::unique_ptr<ThreadPool> preparePool; // created the first time a stage can use it
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LinearChainProcessor)
+};
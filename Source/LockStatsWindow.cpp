@@ -0,0 +1,114 @@
+//
+// LockStatsWindow.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "LockStatsWindow.h"
+#include "ProfiledMutex.h"
+
+class LockStatsWindow::Content : public juce::Component,
+                                 private juce::Timer
+{
+public:
+    Content()
+    {
+        report.setMultiLine(true);
+        report.setReadOnly(true);
+        report.setScrollbarsShown(true);
+        report.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 13.0f, juce::Font::plain));
+        addAndMakeVisible(report);
+
+        auto& profiler = LockProfiler::getInstance();
+
+        profilingToggle.setButtonText("Profile Locks");
+        profilingToggle.setToggleState(profiler.isEnabled(), juce::dontSendNotification);
+        profilingToggle.onClick = [this] { LockProfiler::getInstance().setEnabled(profilingToggle.getToggleState()); };
+        addAndMakeVisible(profilingToggle);
+
+        orderToggle.setButtonText("Check Lock Order");
+        orderToggle.setToggleState(profiler.isCheckingLockOrder(), juce::dontSendNotification);
+        orderToggle.onClick = [this] { LockProfiler::getInstance().setLockOrderChecking(orderToggle.getToggleState()); };
+        addAndMakeVisible(orderToggle);
+
+        resetButton.setButtonText("Reset");
+        resetButton.onClick = [this] { LockProfiler::getInstance().reset(); refresh(); };
+        addAndMakeVisible(resetButton);
+
+        traceButton.setButtonText("Save Trace...");
+        traceButton.onClick = [this] { saveTrace(); };
+        addAndMakeVisible(traceButton);
+
+        setSize(760, 360);
+        refresh();
+        startTimer(1000);
+    }
+
+    void resized() override
+    {
+        auto area = getLocalBounds().reduced(8);
+        auto buttons = area.removeFromBottom(28);
+
+        profilingToggle.setBounds(buttons.removeFromLeft(130));
+        orderToggle.setBounds(buttons.removeFromLeft(150));
+        traceButton.setBounds(buttons.removeFromRight(110));
+        buttons.removeFromRight(8);
+        resetButton.setBounds(buttons.removeFromRight(80));
+
+        area.removeFromBottom(8);
+        report.setBounds(area);
+    }
+
+private:
+    void timerCallback() override   { refresh(); }
+
+    void refresh()
+    {
+        report.setText(LockProfiler::getInstance().createReport(), false);
+    }
+
+    void saveTrace()
+    {
+        chooser = std::make_unique<juce::FileChooser>("Save Lock Trace",
+                                                      juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+                                                          .getChildFile("NovaHost-locks.json"),
+                                                      "*.json");
+
+        chooser->launchAsync(juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::warnAboutOverwriting,
+                             [](const juce::FileChooser& fileChooser)
+                             {
+                                 const juce::File file = fileChooser.getResult();
+                                 if (file != juce::File() && ! LockProfiler::getInstance().writeTrace(file))
+                                     juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon, "Lock Trace",
+                                                                            "Cannot write " + file.getFullPathName());
+                             });
+    }
+
+    juce::TextEditor report;
+    juce::ToggleButton profilingToggle, orderToggle;
+    juce::TextButton resetButton, traceButton;
+    std::unique_ptr<juce::FileChooser> chooser;
+};
+
+LockStatsWindow::LockStatsWindow(std::function<void()> onCloseRequested)
+    : juce::DocumentWindow("Lock Statistics", juce::Colours::white, juce::DocumentWindow::closeButton),
+      onClose(std::move(onCloseRequested))
+{
+    setContentOwned(new Content(), true);
+    setUsingNativeTitleBar(true);
+    setResizable(true, false);
+    centreWithSize(getWidth(), getHeight());
+    setVisible(true);
+}
+
+LockStatsWindow::~LockStatsWindow()
+{
+    clearContentComponent();
+}
+
+void LockStatsWindow::closeButtonPressed()
+{
+    if (onClose != nullptr)
+        onClose();
+}
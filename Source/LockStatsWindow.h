@@ -0,0 +1,32 @@
+//
+// LockStatsWindow.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <functional>
+
+/**
+ * Shows the LockProfiler report, refreshed every second, with controls for
+ * lock-order checking, resetting the counters and saving a trace
+ */
+class LockStatsWindow : public juce::DocumentWindow
+{
+public:
+    /** onCloseRequested is where the owner deletes the window */
+    explicit LockStatsWindow(std::function<void()> onCloseRequested);
+    ~LockStatsWindow() override;
+
+    void closeButtonPressed() override;
+
+private:
+    class Content;
+
+    std::function<void()> onClose;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LockStatsWindow)
+};
@@ -0,0 +1,190 @@
+//
+// MidiInputRouter.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "MidiInputRouter.h"
+
+namespace
+{
+    // MidiBuffer stores each event as a 32-bit sample position and a 16-bit size before the data
+    const int eventHeaderBytes = (int) (sizeof(juce::int32) + sizeof(juce::uint16));
+
+    int getMessageType(juce::uint8 status) noexcept
+    {
+        switch (status & 0xf0)
+        {
+            case 0x80:
+            case 0x90:  return MidiRoute::notes;
+            case 0xa0:
+            case 0xd0:  return MidiRoute::pressure;
+            case 0xb0:  return MidiRoute::controllers;
+            case 0xc0:  return MidiRoute::programChanges;
+            case 0xe0:  return MidiRoute::pitchBend;
+            default:    return MidiRoute::other;
+        }
+    }
+
+    bool isChannelMessage(juce::uint8 status) noexcept
+    {
+        return status >= 0x80 && status < 0xf0;
+    }
+}
+
+//==============================================================================
+bool MidiRoute::accepts(const juce::uint8* data, int numBytes) const noexcept
+{
+    if (! enabled || numBytes <= 0)
+        return false;
+
+    const juce::uint8 status = data[0];
+    if ((types & getMessageType(status)) == 0)
+        return false;
+
+    return ! isChannelMessage(status) || (channelMask & (1 << (status & 0x0f))) != 0;
+}
+
+void MidiRoute::apply(const juce::MidiBuffer& source, juce::MidiBuffer& destination) const noexcept
+{
+    if (! enabled)
+        return;
+
+    for (const auto metadata : source)
+    {
+        if (! accepts(metadata.data, metadata.numBytes))
+            continue;
+
+        if (outputChannel > 0 && isChannelMessage(metadata.data[0]) && metadata.numBytes <= 3)
+        {
+            juce::uint8 remapped[3] = { (juce::uint8) ((metadata.data[0] & 0xf0) | ((outputChannel - 1) & 0x0f)), 0, 0 };
+            for (int i = 1; i < metadata.numBytes; i++)
+                remapped[i] = metadata.data[i];
+
+            addIfRoom(destination, remapped, metadata.numBytes, metadata.samplePosition);
+        }
+        else
+        {
+            addIfRoom(destination, metadata.data, metadata.numBytes, metadata.samplePosition);
+        }
+    }
+}
+
+bool MidiRoute::addIfRoom(juce::MidiBuffer& buffer, const juce::uint8* data, int numBytes, int samplePosition) noexcept
+{
+    if (buffer.data.size() + eventHeaderBytes + numBytes > maxBlockBytes)
+        return false;
+
+    buffer.addEvent(data, numBytes, samplePosition);
+    return true;
+}
+
+juce::uint64 MidiRoute::pack() const noexcept
+{
+    return (juce::uint64) (enabled ? 1 : 0)
+         | ((juce::uint64) (channelMask & 0xffff) << 1)
+         | ((juce::uint64) (outputChannel & 0x1f) << 17)
+         | ((juce::uint64) (types & allTypes) << 22);
+}
+
+MidiRoute MidiRoute::unpack(juce::uint64 packed) noexcept
+{
+    MidiRoute route;
+    route.enabled = (packed & 1) != 0;
+    route.channelMask = (int) ((packed >> 1) & 0xffff);
+    route.outputChannel = juce::jlimit(0, 16, (int) ((packed >> 17) & 0x1f));
+    route.types = (int) ((packed >> 22) & allTypes);
+    return route;
+}
+
+//==============================================================================
+MidiInputRouter::MidiInputRouter()
+{
+    block.ensureSize(MidiRoute::maxBlockBytes);
+}
+
+void MidiInputRouter::handleIncomingMidiMessage(juce::MidiInput*, const juce::MidiMessage& message)
+{
+    const int size = message.getRawDataSize();
+    if (size <= 0 || size > 3)
+    {
+        numDropped++;
+        return;
+    }
+
+    // Device timestamps share the millisecond counter's time base; fall back to the arrival time
+    const double time = message.getTimeStamp() > 0.0 ? message.getTimeStamp()
+                                                     : juce::Time::getMillisecondCounterHiRes() * 0.001;
+
+    const juce::SpinLock::ScopedLockType lock(writerLock);
+    const auto scope = fifo.write(1);
+
+    if (scope.blockSize1 + scope.blockSize2 == 0)
+    {
+        numDropped++;
+        return;
+    }
+
+    Event& event = events[(size_t) (scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)];
+    event.time = time;
+    event.size = (juce::uint8) size;
+    std::memcpy(event.data, message.getRawData(), (size_t) size);
+}
+
+void MidiInputRouter::tapAboutToStart(double newSampleRate, int, int)
+{
+    sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+    block.ensureSize(MidiRoute::maxBlockBytes);
+}
+
+void MidiInputRouter::tapInput(const float* const*, int, int numSamples) noexcept
+{
+    block.clear();
+
+    const int numReady = fifo.getNumReady();
+    if (numReady == 0 || numSamples <= 0)
+        return;
+
+    // Everything that arrived during the previous block, at the same offsets one block later
+    const double now = juce::Time::getMillisecondCounterHiRes() * 0.001;
+    const auto scope = fifo.read(numReady);
+
+    auto addRange = [&](int start, int count)
+    {
+        for (int i = start; i < start + count; i++)
+        {
+            const Event& event = events[(size_t) i];
+            const int position = juce::jlimit(0, numSamples - 1,
+                                              numSamples - 1 - juce::roundToInt((now - event.time) * sampleRate));
+
+            if (! MidiRoute::addIfRoom(block, event.data, event.size, position))
+                numDropped++;
+        }
+    };
+
+    addRange(scope.startIndex1, scope.blockSize1);
+    addRange(scope.startIndex2, scope.blockSize2);
+}
+
+//==============================================================================
+MidiRouteProcessor::MidiRouteProcessor(const MidiInputRouter* router, const MidiRoute& route)
+    : juce::AudioProcessor(BusesProperties()),
+      midiRouter(router),
+      packedRoute(route.pack())
+{
+    filtered.ensureSize(MidiRoute::maxBlockBytes);
+}
+
+void MidiRouteProcessor::processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer& midiMessages)
+{
+    const MidiRoute route = MidiRoute::unpack(packedRoute.load(std::memory_order_relaxed));
+
+    filtered.clear();
+    route.apply(midiMessages, filtered);
+    if (midiRouter != nullptr)
+        route.apply(midiRouter->getCurrentBlock(), filtered);
+
+    // Swapping keeps both allocations alive, so neither side grows again once warmed up
+    midiMessages.swapWith(filtered);
+}
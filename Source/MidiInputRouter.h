@@ -0,0 +1,145 @@
+//
+// MidiInputRouter.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "HostAudioCallback.h"
+#include <array>
+#include <atomic>
+
+/**
+ * Which MIDI a chain plugin receives: a channel filter, a message type filter and an
+ * optional channel to move everything onto. Packs into 64 bits so the audio thread can
+ * read it atomically while the menu changes it.
+ */
+struct MidiRoute
+{
+    enum MessageType
+    {
+        notes          = 1 << 0,
+        controllers    = 1 << 1,
+        pitchBend      = 1 << 2,
+        programChanges = 1 << 3,
+        pressure       = 1 << 4,
+        other          = 1 << 5,
+        allTypes       = (1 << 6) - 1
+    };
+
+    /** Bytes preallocated for each MIDI buffer the routing fills on the audio thread */
+    static constexpr int maxBlockBytes = 8192;
+
+    bool enabled = true;
+    int channelMask = 0xffff;   // bit n lets MIDI channel n + 1 through
+    int outputChannel = 0;      // 1-16 moves every channel message there, 0 keeps the channel
+    int types = allTypes;
+
+    bool accepts(const juce::uint8* data, int numBytes) const noexcept;
+
+    /**
+     * Adds the accepted events of source to destination, remapped
+     * Stops short of growing destination past maxBlockBytes, so it never allocates once prepared
+     */
+    void apply(const juce::MidiBuffer& source, juce::MidiBuffer& destination) const noexcept;
+
+    juce::uint64 pack() const noexcept;
+    static MidiRoute unpack(juce::uint64 packed) noexcept;
+
+    /** Adds an event unless the buffer is full; returns false if it was dropped */
+    static bool addIfRoom(juce::MidiBuffer& buffer, const juce::uint8* data, int numBytes, int samplePosition) noexcept;
+};
+
+//==============================================================================
+/**
+ * Collects MIDI from the enabled input devices and hands it to the chain one block at a time
+ *
+ * The MIDI threads push short messages into a fixed-size FIFO; the audio thread drains it at
+ * the start of every device callback and places each event at the sample matching its arrival
+ * time, one block late, so the spacing between events survives. Nothing on the audio side
+ * locks or allocates. System exclusive messages do not fit the FIFO slots and are dropped.
+ */
+class MidiInputRouter : public juce::MidiInputCallback,
+                        public HostAudioTap
+{
+public:
+    MidiInputRouter();
+
+    /** The MIDI received for the block being processed; audio thread only */
+    const juce::MidiBuffer& getCurrentBlock() const noexcept   { return block; }
+
+    /** Messages that did not fit: system exclusive, or more than the FIFO or a block holds */
+    int getNumDropped() const noexcept                          { return numDropped.load(); }
+
+    //==============================================================================
+    void handleIncomingMidiMessage(juce::MidiInput* source, const juce::MidiMessage& message) override;
+
+    void tapAboutToStart(double sampleRate, int numInputChannels, int numOutputChannels) override;
+    void tapInput(const float* const* data, int numChannels, int numSamples) noexcept override;
+    void tapOutput(const float* const*, int, int) noexcept override {}
+
+private:
+    struct Event
+    {
+        double time = 0.0;
+        juce::uint8 data[3] = {};
+        juce::uint8 size = 0;
+    };
+
+    static constexpr int fifoSize = 1024;
+
+    // Several devices may call in on different threads; the FIFO itself takes one writer
+    juce::SpinLock writerLock;
+    juce::AbstractFifo fifo { fifoSize };
+    std::array<Event, fifoSize> events;
+
+    juce::MidiBuffer block;
+    double sampleRate = 44100.0;
+    std::atomic<int> numDropped { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiInputRouter)
+};
+
+//==============================================================================
+/**
+ * Graph node that feeds one plugin: the graph's MIDI input plus the router's block, through a route
+ */
+class MidiRouteProcessor : public juce::AudioProcessor
+{
+public:
+    MidiRouteProcessor(const MidiInputRouter* router, const MidiRoute& route);
+
+    void setRoute(const MidiRoute& route) noexcept          { packedRoute.store(route.pack()); }
+
+    const juce::String getName() const override             { return "MIDI Route"; }
+    void prepareToPlay(double, int) override                { filtered.ensureSize(MidiRoute::maxBlockBytes); }
+    void releaseResources() override {}
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override;
+
+    double getTailLengthSeconds() const override            { return 0.0; }
+    bool acceptsMidi() const override                       { return true; }
+    bool producesMidi() const override                      { return true; }
+    bool isMidiEffect() const override                      { return true; }
+
+    juce::AudioProcessorEditor* createEditor() override     { return nullptr; }
+    bool hasEditor() const override                         { return false; }
+
+    int getNumPrograms() override                           { return 1; }
+    int getCurrentProgram() override                        { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override         { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+
+    void getStateInformation(juce::MemoryBlock&) override {}
+    void setStateInformation(const void*, int) override {}
+
+private:
+    const MidiInputRouter* midiRouter;
+    std::atomic<juce::uint64> packedRoute;
+    juce::MidiBuffer filtered;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiRouteProcessor)
+};
@@ -0,0 +1,340 @@
+//
+// ModulationEngine.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "ModulationEngine.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const float sendThreshold = 1.0e-4f;
+    const int budgetCheckInterval = 8;
+
+    const char* const typeNames[] = { "lfo", "envelope", "steps" };
+    const char* const shapeNames[] = { "sine", "triangle", "saw", "square" };
+    const char* const shapeLabels[] = { "Sine", "Triangle", "Saw", "Square" };
+
+    float lfoValue(ModulationSource::Shape shape, double phase) noexcept
+    {
+        switch (shape)
+        {
+            case ModulationSource::Shape::triangle: return (float) (phase < 0.5 ? 4.0 * phase - 1.0 : 3.0 - 4.0 * phase);
+            case ModulationSource::Shape::saw:      return (float) (2.0 * phase - 1.0);
+            case ModulationSource::Shape::square:   return phase < 0.5 ? 1.0f : -1.0f;
+            case ModulationSource::Shape::sine:
+            default:                                return (float) std::sin(juce::MathConstants<double>::twoPi * phase);
+        }
+    }
+
+    int indexOfName(const char* const* names, int numNames, const juce::String& name)
+    {
+        for (int i = 0; i < numNames; i++)
+            if (name == names[i])
+                return i;
+        return 0;
+    }
+}
+
+//==============================================================================
+juce::String ModulationSource::getDescription() const
+{
+    switch (type)
+    {
+        case Type::envelopeFollower:    return "Envelope Follower";
+        case Type::stepSequencer:       return "Step Sequencer (" + juce::String(rate, 2) + " steps/s)";
+        case Type::lfo:
+        default:                        return juce::String(shapeLabels[(int) shape]) + " LFO (" + juce::String(rate, 2) + " Hz)";
+    }
+}
+
+//==============================================================================
+ModulationEngine::ModulationEngine(juce::AudioProcessorGraph& graphToUse)
+    : graph(graphToUse)
+{
+    currentProgram.swap(std::make_unique<Program>());
+}
+
+ModulationEngine::~ModulationEngine()
+{
+}
+
+void ModulationEngine::setConfiguration(const std::vector<ModulationSource>& newSources,
+                                        const std::vector<ModulationRoute>& newRoutes)
+{
+    // Sources are matched by position, so an edited source carries on from where it was
+    configure(newSources, newRoutes, sourceSlots);
+}
+
+void ModulationEngine::removeSource(int index)
+{
+    if (! juce::isPositiveAndBelow(index, (int) sources.size()))
+        return;
+
+    auto newSources = sources;
+    auto newRoutes = routes;
+    auto newSlots = sourceSlots;
+
+    newSources.erase(newSources.begin() + index);
+    newSlots.erase(newSlots.begin() + index);
+
+    // Routes keep pointing at the same sources after one is removed
+    newRoutes.erase(std::remove_if(newRoutes.begin(), newRoutes.end(), [index](const ModulationRoute& r) { return r.source == index; }),
+                    newRoutes.end());
+    for (auto& route : newRoutes)
+        if (route.source > index)
+            route.source--;
+
+    configure(newSources, newRoutes, newSlots);
+}
+
+void ModulationEngine::configure(const std::vector<ModulationSource>& newSources,
+                                 const std::vector<ModulationRoute>& newRoutes,
+                                 std::vector<int> newSlots)
+{
+    sources = newSources;
+    if ((int) sources.size() > maxSources)
+        sources.resize(maxSources);
+    routes = newRoutes;
+
+    // New sources take slots nobody uses; those were cleared when they were last given up
+    newSlots.resize(juce::jmin(newSlots.size(), sources.size()));
+    for (int slot = 0; slot < maxSources && newSlots.size() < sources.size(); slot++)
+        if (std::find(newSlots.begin(), newSlots.end(), slot) == newSlots.end())
+            newSlots.push_back(slot);
+
+    auto program = std::make_unique<Program>();
+    program->sources = sources;
+    program->slots = newSlots;
+
+    // One row per parameter, however many routes reach it
+    std::vector<std::pair<int, float>> routeRows;
+    for (const auto& route : routes)
+    {
+        juce::AudioProcessorParameter* parameter = nullptr;
+
+        for (auto node : graph.getNodes())
+        {
+            auto instance = dynamic_cast<juce::AudioPluginInstance*>(node->getProcessor());
+            if (instance != nullptr && instance->getPluginDescription().createIdentifierString() == route.pluginIdentifier)
+            {
+                parameter = instance->getParameters()[route.parameterIndex];
+                break;
+            }
+        }
+
+        if (parameter == nullptr || ! juce::isPositiveAndBelow(route.source, (int) sources.size()))
+        {
+            routeRows.push_back({ -1, 0.0f });
+            continue;
+        }
+
+        auto found = std::find(program->parameters.begin(), program->parameters.end(), parameter);
+        if (found == program->parameters.end())
+        {
+            program->parameters.push_back(parameter);
+            found = program->parameters.end() - 1;
+        }
+
+        routeRows.push_back({ (int) (found - program->parameters.begin()), route.base });
+    }
+
+    const int numTargets = (int) program->parameters.size();
+    const int numSources = (int) sources.size();
+    program->numTargets = numTargets;
+    program->matrix.calloc((size_t) juce::jmax(1, numTargets * numSources));
+    program->base.calloc((size_t) juce::jmax(1, numTargets));
+    program->values.calloc((size_t) juce::jmax(1, numTargets));
+    program->lastSent.calloc((size_t) juce::jmax(1, numTargets));
+
+    for (size_t i = 0; i < routes.size(); i++)
+    {
+        const int row = routeRows[i].first;
+        if (row < 0)
+            continue;
+
+        program->matrix[routes[i].source * numTargets + row] += routes[i].depth;
+        program->base[row] = routeRows[i].second;
+    }
+
+    for (int row = 0; row < numTargets; row++)
+        program->lastSent[row] = program->parameters[(size_t) row]->getValue();
+
+    currentProgram.swap(std::move(program));
+
+    // No reader can still use the slots that were given up, so they start from scratch next time
+    for (const int slot : sourceSlots)
+    {
+        if (std::find(newSlots.begin(), newSlots.end(), slot) == newSlots.end())
+        {
+            phases[(size_t) slot] = 0.0;
+            envelopes[(size_t) slot] = 0.0f;
+        }
+    }
+
+    sourceSlots = std::move(newSlots);
+}
+
+void ModulationEngine::detachParameters()
+{
+    currentProgram.swap(std::make_unique<Program>());
+}
+
+//==============================================================================
+std::unique_ptr<juce::XmlElement> ModulationEngine::createXml() const
+{
+    auto xml = std::make_unique<juce::XmlElement>("MODULATION");
+
+    for (const auto& source : sources)
+    {
+        auto* sourceXml = xml->createNewChildElement("SOURCE");
+        sourceXml->setAttribute("type", typeNames[(int) source.type]);
+        sourceXml->setAttribute("shape", shapeNames[(int) source.shape]);
+        sourceXml->setAttribute("rate", source.rate);
+        sourceXml->setAttribute("attack", source.attack);
+        sourceXml->setAttribute("release", source.release);
+
+        juce::StringArray steps;
+        for (const float step : source.steps)
+            steps.add(juce::String(step, 3));
+        sourceXml->setAttribute("steps", steps.joinIntoString(" "));
+    }
+
+    for (const auto& route : routes)
+    {
+        auto* routeXml = xml->createNewChildElement("ROUTE");
+        routeXml->setAttribute("source", route.source);
+        routeXml->setAttribute("plugin", route.pluginIdentifier);
+        routeXml->setAttribute("parameter", route.parameterIndex);
+        routeXml->setAttribute("depth", route.depth);
+        routeXml->setAttribute("base", route.base);
+    }
+
+    return xml;
+}
+
+void ModulationEngine::restoreFromXml(const juce::XmlElement& xml)
+{
+    std::vector<ModulationSource> restoredSources;
+    std::vector<ModulationRoute> restoredRoutes;
+
+    for (auto* sourceXml : xml.getChildWithTagNameIterator("SOURCE"))
+    {
+        ModulationSource source;
+        source.type = (ModulationSource::Type) indexOfName(typeNames, 3, sourceXml->getStringAttribute("type"));
+        source.shape = (ModulationSource::Shape) indexOfName(shapeNames, 4, sourceXml->getStringAttribute("shape"));
+        source.rate = (float) sourceXml->getDoubleAttribute("rate", 1.0);
+        source.attack = (float) sourceXml->getDoubleAttribute("attack", 0.01);
+        source.release = (float) sourceXml->getDoubleAttribute("release", 0.2);
+
+        const juce::StringArray steps = juce::StringArray::fromTokens(sourceXml->getStringAttribute("steps"), false);
+        for (int i = 0; i < juce::jmin(steps.size(), ModulationSource::numSteps); i++)
+            source.steps[(size_t) i] = juce::jlimit(0.0f, 1.0f, steps[i].getFloatValue());
+
+        restoredSources.push_back(source);
+    }
+
+    for (auto* routeXml : xml.getChildWithTagNameIterator("ROUTE"))
+    {
+        ModulationRoute route;
+        route.source = routeXml->getIntAttribute("source");
+        route.pluginIdentifier = routeXml->getStringAttribute("plugin");
+        route.parameterIndex = routeXml->getIntAttribute("parameter", -1);
+        route.depth = (float) routeXml->getDoubleAttribute("depth", 0.5);
+        route.base = (float) routeXml->getDoubleAttribute("base", 0.5);
+        restoredRoutes.push_back(route);
+    }
+
+    setConfiguration(restoredSources, restoredRoutes);
+}
+
+//==============================================================================
+void ModulationEngine::tapAboutToStart(double newSampleRate, int, int)
+{
+    sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+}
+
+float ModulationEngine::advanceSource(int slot, const ModulationSource& source, double seconds, float inputPeak) noexcept
+{
+    const auto index = (size_t) slot;
+
+    switch (source.type)
+    {
+        case ModulationSource::Type::envelopeFollower:
+        {
+            const float time = inputPeak > envelopes[index] ? source.attack : source.release;
+            const float coefficient = time > 0.0f ? (float) (1.0 - std::exp(-seconds / time)) : 1.0f;
+            envelopes[index] += (inputPeak - envelopes[index]) * coefficient;
+            return envelopes[index];
+        }
+
+        case ModulationSource::Type::stepSequencer:
+            phases[index] = std::fmod(phases[index] + source.rate * seconds, (double) ModulationSource::numSteps);
+            return source.steps[(size_t) juce::jlimit(0, ModulationSource::numSteps - 1, (int) phases[index])];
+
+        case ModulationSource::Type::lfo:
+        default:
+            phases[index] = std::fmod(phases[index] + source.rate * seconds, 1.0);
+            return lfoValue(source.shape, phases[index]);
+    }
+}
+
+void ModulationEngine::tapInput(const float* const* data, int numChannels, int numSamples) noexcept
+{
+    const juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+
+    const RcuPointer<Program>::ScopedReader reader(currentProgram);
+    Program* program = reader.get();
+
+    if (program != nullptr && ! program->sources.empty() && numSamples > 0)
+    {
+        // The envelope followers all listen to the loudest input channel
+        float inputPeak = 0.0f;
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            if (data[channel] == nullptr)
+                continue;
+            const auto range = juce::FloatVectorOperations::findMinAndMax(data[channel], numSamples);
+            inputPeak = juce::jmax(inputPeak, -range.getStart(), range.getEnd());
+        }
+
+        const double seconds = numSamples / sampleRate;
+        const int numTargets = program->numTargets;
+
+        // values = base + matrix * sources, one vectorised pass per source
+        juce::FloatVectorOperations::copy(program->values, program->base, numTargets);
+        for (int i = 0; i < (int) program->sources.size(); i++)
+        {
+            const float sourceValue = advanceSource(program->slots[(size_t) i], program->sources[(size_t) i], seconds, inputPeak);
+            if (numTargets > 0)
+                juce::FloatVectorOperations::addWithMultiply(program->values.get(), program->matrix + i * numTargets, sourceValue, numTargets);
+        }
+        juce::FloatVectorOperations::clip(program->values, program->values, 0.0f, 1.0f, numTargets);
+
+        // Send what moved, starting where the last over-budget block stopped
+        const double budgetSeconds = budgetFraction.load(std::memory_order_relaxed) * seconds;
+        const juce::int64 budgetTicks = juce::Time::secondsToHighResolutionTicks(budgetSeconds);
+
+        for (int n = 0; n < numTargets; n++)
+        {
+            const int row = (program->nextTarget + n) % numTargets;
+
+            if (std::abs(program->values[row] - program->lastSent[row]) > sendThreshold)
+            {
+                program->parameters[(size_t) row]->setValue(program->values[row]);
+                program->lastSent[row] = program->values[row];
+            }
+
+            if ((n + 1) % budgetCheckInterval == 0 && n + 1 < numTargets
+                && juce::Time::getHighResolutionTicks() - startTicks > budgetTicks)
+            {
+                program->nextTarget = (row + 1) % numTargets;
+                numOverBudgetBlocks.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,138 @@
+//
+// ModulationEngine.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "HostAudioCallback.h"
+#include "RcuPointer.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/** Something that moves over time: an LFO, an envelope follower on the device input, or a step sequencer */
+struct ModulationSource
+{
+    enum class Type
+    {
+        lfo,
+        envelopeFollower,
+        stepSequencer
+    };
+
+    enum class Shape
+    {
+        sine,
+        triangle,
+        saw,
+        square
+    };
+
+    static constexpr int numSteps = 8;
+
+    Type type = Type::lfo;
+    Shape shape = Shape::sine;
+    float rate = 1.0f;          // cycles per second for LFOs, steps per second for sequencers
+    float attack = 0.01f;       // seconds, envelope followers only
+    float release = 0.2f;
+    std::array<float, numSteps> steps {{ 0.0f, 0.25f, 0.5f, 0.75f, 1.0f, 0.75f, 0.5f, 0.25f }};
+
+    juce::String getDescription() const;
+};
+
+/** Adds depth times a source to a parameter's base value; LFOs swing -1 to 1, the others 0 to 1 */
+struct ModulationRoute
+{
+    int source = 0;
+    juce::String pluginIdentifier;
+    int parameterIndex = -1;
+    float depth = 0.5f;
+    float base = 0.5f;
+};
+
+//==============================================================================
+/**
+ * Modulates plugin parameters from LFOs, envelope followers and step sequencers, once per block
+ *
+ * The sources and routes are compiled into a program: a dense matrix with one column of depths
+ * per source and one row per parameter. Each block the audio thread advances the sources, runs
+ * the matrix as one vectorised multiply-add per source and sends the parameters that moved. The
+ * sends are capped by a CPU budget per block; whatever does not fit is sent first next block,
+ * so an expensive plugin delays modulation rather than the audio. Edits build a new program and
+ * swap it in the way the controller mappings do.
+ */
+class ModulationEngine : public HostAudioTap
+{
+public:
+    static constexpr int maxSources = 16;
+
+    explicit ModulationEngine(juce::AudioProcessorGraph& graph);
+    ~ModulationEngine() override;
+
+    //==============================================================================
+    /** Message thread only; resolves the routes against the plugins in the graph */
+    void setConfiguration(const std::vector<ModulationSource>& newSources, const std::vector<ModulationRoute>& newRoutes);
+    const std::vector<ModulationSource>& getSources() const noexcept    { return sources; }
+    const std::vector<ModulationRoute>& getRoutes() const noexcept      { return routes; }
+
+    /** Removes a source and its routes; the sources after it keep their phases and envelopes */
+    void removeSource(int index);
+
+    /** Drops every parameter handle; call before the graph's plugins are deleted */
+    void detachParameters();
+    void attachParameters()                                             { setConfiguration(sources, routes); }
+
+    /** Share of each block the parameter sends may take */
+    void setBudget(double fractionOfBlock) noexcept                     { budgetFraction.store(fractionOfBlock); }
+
+    /** Blocks in which some parameters had to wait for the next one */
+    int getNumOverBudgetBlocks() const noexcept                         { return numOverBudgetBlocks.load(); }
+
+    std::unique_ptr<juce::XmlElement> createXml() const;
+    void restoreFromXml(const juce::XmlElement& xml);
+
+    //==============================================================================
+    void tapAboutToStart(double sampleRate, int numInputChannels, int numOutputChannels) override;
+    void tapInput(const float* const* data, int numChannels, int numSamples) noexcept override;
+    void tapOutput(const float* const*, int, int) noexcept override {}
+
+private:
+    struct Program
+    {
+        std::vector<ModulationSource> sources;
+        std::vector<int> slots;     // where each source keeps its phase and envelope
+        std::vector<juce::AudioProcessorParameter*> parameters;
+        int numTargets = 0;
+
+        // One column of numTargets depths per source, then the working rows; only the audio thread writes
+        juce::HeapBlock<float> matrix, base, values, lastSent;
+        int nextTarget = 0;
+    };
+
+    void configure(const std::vector<ModulationSource>& newSources, const std::vector<ModulationRoute>& newRoutes,
+                   std::vector<int> newSlots);
+    float advanceSource(int slot, const ModulationSource& source, double seconds, float inputPeak) noexcept;
+
+    juce::AudioProcessorGraph& graph;
+    std::vector<ModulationSource> sources;
+    std::vector<ModulationRoute> routes;
+    std::vector<int> sourceSlots;
+
+    RcuPointer<Program> currentProgram;
+
+    // Source state lives in slots that survive program swaps, so editing a route does not restart
+    // the LFOs and removing a source does not hand its state to the next one
+    std::array<double, maxSources> phases {};
+    std::array<float, maxSources> envelopes {};
+
+    double sampleRate = 44100.0;
+    std::atomic<double> budgetFraction { 0.02 };
+    std::atomic<int> numOverBudgetBlocks { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulationEngine)
+};
@@ -0,0 +1,214 @@
+//
+// MonitorPath.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "MonitorPath.h"
+
+namespace
+{
+    const int parameterFollowHz = 20;
+}
+
+MonitorPath::MonitorPath()
+{
+}
+
+MonitorPath::~MonitorPath()
+{
+    stopTimer();
+}
+
+int MonitorPath::getNumPlugins() const noexcept
+{
+    auto* chain = currentChain.getForWriter();
+    return chain != nullptr ? (int) chain->instances.size() : 0;
+}
+
+juce::StringArray MonitorPath::build(juce::AudioProcessorGraph& graph, juce::AudioPluginFormatManager& formatManager,
+                                     const juce::StringArray& pluginIdentifiers)
+{
+    juce::StringArray leftOut;
+    auto newChain = std::make_unique<SubChain>();
+
+    double currentSampleRate;
+    int currentBlockSize;
+    {
+        std::lock_guard<ProfiledMutex> lock(prepareMutex);
+        currentSampleRate = sampleRate;
+        currentBlockSize = blockSize;
+    }
+
+    for (const auto& identifier : pluginIdentifiers)
+    {
+        juce::AudioPluginInstance* source = nullptr;
+        for (auto node : graph.getNodes())
+        {
+            auto instance = dynamic_cast<juce::AudioPluginInstance*>(node->getProcessor());
+            if (instance != nullptr && instance->getPluginDescription().createIdentifierString() == identifier)
+                source = instance;
+        }
+
+        if (source == nullptr)
+            continue;
+
+        const juce::String name = source->getPluginDescription().name;
+        if (source->getLatencySamples() > 0)
+        {
+            leftOut.add(name + " adds " + juce::String(source->getLatencySamples()) + " samples of latency");
+            continue;
+        }
+
+        juce::String error;
+        std::unique_ptr<juce::AudioPluginInstance> copy = formatManager.createPluginInstance(source->getPluginDescription(),
+                                                                                             currentSampleRate, currentBlockSize, error);
+        if (copy == nullptr)
+        {
+            leftOut.add(name + ": " + error);
+            continue;
+        }
+
+        // Starts out exactly as the chain's instance is now
+        juce::MemoryBlock state;
+        source->getStateInformation(state);
+        copy->setStateInformation(state.getData(), (int) state.getSize());
+
+        // Some plugins only report their latency once prepared
+        copy->prepareToPlay(currentSampleRate, currentBlockSize);
+        if (copy->getLatencySamples() > 0)
+        {
+            leftOut.add(name + " adds " + juce::String(copy->getLatencySamples()) + " samples of latency");
+            continue;
+        }
+
+        const auto& sourceParameters = source->getParameters();
+        const auto& copyParameters = copy->getParameters();
+        for (int i = 0; i < juce::jmin(sourceParameters.size(), copyParameters.size()); i++)
+            newChain->followedParameters.push_back({ sourceParameters[i], copyParameters[i] });
+
+        newChain->chain.addStage(copy.get(), false);
+        newChain->instances.push_back(std::move(copy));
+    }
+
+    {
+        std::lock_guard<ProfiledMutex> lock(prepareMutex);
+        newChain->chain.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        newChain->chain.prepareToPlay(sampleRate, blockSize);
+        swapChain(std::move(newChain));
+    }
+
+    if (getNumPlugins() > 0)
+        startTimerHz(parameterFollowHz);
+    else
+        stopTimer();
+
+    return leftOut;
+}
+
+void MonitorPath::clear()
+{
+    stopTimer();
+
+    std::lock_guard<ProfiledMutex> lock(prepareMutex);
+    swapChain(nullptr);
+}
+
+void MonitorPath::swapChain(std::unique_ptr<SubChain> newChain)
+{
+    std::unique_ptr<SubChain> oldChain = currentChain.swap(std::move(newChain));
+
+    if (oldChain != nullptr)
+        oldChain->chain.releaseResources();
+}
+
+void MonitorPath::timerCallback()
+{
+    // Only this thread swaps the sub-chain, so it cannot go away in here
+    auto* chain = currentChain.getForWriter();
+    if (chain == nullptr)
+        return;
+
+    for (const auto& [source, copy] : chain->followedParameters)
+    {
+        const float value = source->getValue();
+        if (copy->getValue() != value)
+            copy->setValue(value);
+    }
+}
+
+//==============================================================================
+void MonitorPath::pathAboutToStart(double newSampleRate, int newBlockSize, int, int)
+{
+    std::lock_guard<ProfiledMutex> lock(prepareMutex);
+    sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+    blockSize = juce::jmax(1, newBlockSize);
+
+    savedInput.setSize(2, blockSize);
+    midi.ensureSize(MidiRoute::maxBlockBytes);
+
+    // Swaps happen under the same lock, so the sub-chain stays put while it is prepared
+    if (auto* chain = currentChain.getForWriter())
+    {
+        chain->chain.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        chain->chain.prepareToPlay(sampleRate, blockSize);
+    }
+}
+
+void MonitorPath::pathInput(const float* const* input, int numInputChannels,
+                            float* const* output, int numOutputChannels, int numSamples) noexcept
+{
+    inputSaved = false;
+    if (outputChannel.load(std::memory_order_relaxed) < 0 || numInputChannels <= 0 || numSamples > savedInput.getNumSamples())
+        return;
+
+    // Only drivers that alias input and output need the input kept aside; everywhere else it is read in place
+    bool aliased = false;
+    for (int in = 0; in < juce::jmin(2, numInputChannels); in++)
+        for (int out = 0; out < numOutputChannels; out++)
+            aliased = aliased || (input[in] != nullptr && (const float*) output[out] == input[in]);
+
+    if (! aliased)
+        return;
+
+    for (int channel = 0; channel < 2; channel++)
+    {
+        const float* source = input[juce::jmin(channel, numInputChannels - 1)];
+        if (source != nullptr)
+            savedInput.copyFrom(channel, 0, source, numSamples);
+        else
+            savedInput.clear(channel, 0, numSamples);
+    }
+    inputSaved = true;
+}
+
+void MonitorPath::pathOutput(const float* const* input, int numInputChannels,
+                             float* const* output, int numOutputChannels, int numSamples) noexcept
+{
+    const int first = outputChannel.load(std::memory_order_relaxed);
+    if (first < 0 || first + 1 >= numOutputChannels || output[first] == nullptr || output[first + 1] == nullptr)
+        return;
+
+    // The monitor pair starts out as the chain input and the sub-chain works on it in place
+    float* monitor[2] = { output[first], output[first + 1] };
+    for (int channel = 0; channel < 2; channel++)
+    {
+        const float* source = inputSaved ? savedInput.getReadPointer(channel)
+                                         : (numInputChannels > 0 ? input[juce::jmin(channel, numInputChannels - 1)] : nullptr);
+        if (source != nullptr)
+            juce::FloatVectorOperations::copy(monitor[channel], source, numSamples);
+        else
+            juce::FloatVectorOperations::clear(monitor[channel], numSamples);
+    }
+
+    const RcuPointer<SubChain>::ScopedReader reader(currentChain);
+    SubChain* chain = reader.get();
+
+    if (chain != nullptr && ! chain->instances.empty())
+    {
+        juce::AudioBuffer<float> buffer(monitor, 2, numSamples);
+        midi.clear();
+        chain->chain.processBlock(buffer, midi);
+    }
+}
@@ -0,0 +1,84 @@
+//
+// MonitorPath.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "HostAudioCallback.h"
+#include "LinearChainProcessor.h"
+#include "ProfiledMutex.h"
+#include "RcuPointer.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * A latency-free monitor feed next to the full chain
+ *
+ * The chain input goes to a pair of monitor outputs through a sub-chain of its own: second
+ * instances of the plugins flagged for monitoring that report no latency, or nothing at all
+ * for a dry feed. It runs in the device callback right after the chain, straight on the
+ * device's input and output buffers. The second instances follow the parameters of the chain's
+ * plugins a few times a second. The sub-chain is swapped in the way the controller mappings are.
+ */
+class MonitorPath : public HostAudioPath,
+                    private juce::Timer
+{
+public:
+    MonitorPath();
+    ~MonitorPath() override;
+
+    /** First device output channel of the monitor pair, or -1 to turn the feed off */
+    void setOutputChannel(int firstChannel) noexcept    { outputChannel.store(firstChannel); }
+    int getOutputChannel() const noexcept                { return outputChannel.load(); }
+
+    /**
+     * Rebuilds the sub-chain from the graph's instances of the given plugins, in that order
+     * @returns the plugins left out of the monitor path, and why
+     */
+    juce::StringArray build(juce::AudioProcessorGraph& graph, juce::AudioPluginFormatManager& formatManager,
+                            const juce::StringArray& pluginIdentifiers);
+
+    /** Drops the sub-chain; call before the graph's plugins are deleted, since their parameters are followed */
+    void clear();
+
+    int getNumPlugins() const noexcept;
+
+    //==============================================================================
+    void pathAboutToStart(double sampleRate, int blockSize, int numInputChannels, int numOutputChannels) override;
+    void pathInput(const float* const* input, int numInputChannels,
+                   float* const* output, int numOutputChannels, int numSamples) noexcept override;
+    void pathOutput(const float* const* input, int numInputChannels,
+                    float* const* output, int numOutputChannels, int numSamples) noexcept override;
+
+private:
+    struct SubChain
+    {
+        // The chain refers to the instances, so it has to go first
+        std::vector<std::unique_ptr<juce::AudioPluginInstance>> instances;
+        LinearChainProcessor chain;
+        std::vector<std::pair<juce::AudioProcessorParameter*, juce::AudioProcessorParameter*>> followedParameters;   // chain's, monitor's
+    };
+
+    void swapChain(std::unique_ptr<SubChain> newChain);
+    void timerCallback() override;
+
+    RcuPointer<SubChain> currentChain;
+    std::atomic<int> outputChannel { -1 };
+
+    // Preparing happens on the device thread when it starts and on the message thread when rebuilding
+    ProfiledMutex prepareMutex { "MonitorPath prepare" };
+    double sampleRate = 44100.0;
+    int blockSize = 512;
+
+    // Audio thread only
+    juce::AudioBuffer<float> savedInput;
+    bool inputSaved = false;
+    juce::MidiBuffer midi;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MonitorPath)
+};
@@ -0,0 +1,211 @@
+//
+// PluginCostModel.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "PluginCostModel.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const int measuredBlockSizes[] = { 64, 256, 1024 };
+    const int numWarmUpBlocks = 4;
+    const int numTimedBlocks = 16;
+
+    // How much a new figure moves the stored one: scans are a fresh look, live samples a running average
+    const double scanWeight = 0.5;
+    const double liveWeight = 0.2;
+
+    const int liveSampleIntervalMs = 2000;
+}
+
+PluginCostModel::PluginCostModel()
+{
+}
+
+PluginCostModel::~PluginCostModel()
+{
+    stopTimer();
+}
+
+std::vector<PluginCostModel::Measurement> PluginCostModel::measure(juce::AudioPluginInstance& instance, double sampleRate)
+{
+    std::vector<Measurement> measurements;
+    juce::Random random;
+    juce::MidiBuffer midi;
+
+    for (const int blockSize : measuredBlockSizes)
+    {
+        instance.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        instance.prepareToPlay(sampleRate, blockSize);
+
+        const int numChannels = juce::jmax(1, instance.getTotalNumInputChannels(), instance.getTotalNumOutputChannels());
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        std::vector<double> blockSeconds;
+
+        for (int block = 0; block < numWarmUpBlocks + numTimedBlocks; block++)
+        {
+            for (int channel = 0; channel < numChannels; channel++)
+                for (int i = 0; i < blockSize; i++)
+                    buffer.setSample(channel, i, random.nextFloat() * 0.5f - 0.25f);
+
+            midi.clear();
+            const juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+            instance.processBlock(buffer, midi);
+            const juce::int64 elapsedTicks = juce::Time::getHighResolutionTicks() - startTicks;
+
+            if (block >= numWarmUpBlocks)
+                blockSeconds.push_back(juce::Time::highResolutionTicksToSeconds(elapsedTicks));
+        }
+
+        instance.releaseResources();
+
+        // The median, so one preempted block does not make the plugin look expensive
+        std::nth_element(blockSeconds.begin(), blockSeconds.begin() + (std::ptrdiff_t) (blockSeconds.size() / 2), blockSeconds.end());
+        measurements.push_back({ blockSize, blockSeconds[blockSeconds.size() / 2] / (double) blockSize });
+    }
+
+    return measurements;
+}
+
+void PluginCostModel::addMeasurements(const juce::PluginDescription& plugin, const std::vector<Measurement>& measurements)
+{
+    const juce::String identifier = plugin.createIdentifierString();
+
+    for (const auto& measurement : measurements)
+        blend(identifier, measurement.blockSize, measurement.secondsPerSample, scanWeight);
+}
+
+void PluginCostModel::blend(const juce::String& identifier, int blockSize, double secondsPerSample, double weight)
+{
+    if (blockSize <= 0 || ! std::isfinite(secondsPerSample) || secondsPerSample < 0.0)
+        return;
+
+    std::lock_guard<ProfiledMutex> lock(costMutex);
+    auto& byBlockSize = costs[identifier];
+    auto found = byBlockSize.find(blockSize);
+
+    if (found == byBlockSize.end())
+        byBlockSize[blockSize] = secondsPerSample;
+    else
+        found->second += (secondsPerSample - found->second) * weight;
+}
+
+void PluginCostModel::setChainToWatch(LinearChainProcessor* chain)
+{
+    watchedChain = chain;
+
+    if (watchedChain != nullptr)
+        startTimer(liveSampleIntervalMs);
+    else
+        stopTimer();
+}
+
+void PluginCostModel::timerCallback()
+{
+    const int blockSize = watchedChain->getPreparedBlockSize();
+    if (blockSize <= 0)
+        return;
+
+    for (int i = 0; i < watchedChain->getNumStages(); i++)
+    {
+        auto* instance = dynamic_cast<juce::AudioPluginInstance*>(watchedChain->getStageProcessor(i));
+        const double secondsPerSample = watchedChain->takeStageSecondsPerSample(i);
+
+        if (instance != nullptr && secondsPerSample >= 0.0)
+            blend(instance->getPluginDescription().createIdentifierString(), blockSize, secondsPerSample, liveWeight);
+    }
+}
+
+double PluginCostModel::predictSecondsPerBlock(const juce::PluginDescription& plugin, int blockSize) const
+{
+    std::lock_guard<ProfiledMutex> lock(costMutex);
+
+    auto found = costs.find(plugin.createIdentifierString());
+    if (found == costs.end() || found->second.empty() || blockSize <= 0)
+        return -1.0;
+
+    const auto& byBlockSize = found->second;
+    auto above = byBlockSize.lower_bound(blockSize);
+
+    if (above == byBlockSize.end())
+        return std::prev(above)->second * blockSize;
+
+    if (above->first == blockSize || above == byBlockSize.begin())
+        return above->second * blockSize;
+
+    // Between two measured sizes: interpolate on log2 of the block size
+    const auto below = std::prev(above);
+    const double position = (std::log2((double) blockSize) - std::log2((double) below->first))
+                          / (std::log2((double) above->first) - std::log2((double) below->first));
+    return (below->second + (above->second - below->second) * position) * blockSize;
+}
+
+PluginCostModel::Prediction PluginCostModel::predictLoadWith(const juce::Array<juce::PluginDescription>& chain,
+                                                             const juce::PluginDescription& candidate,
+                                                             double sampleRate, int blockSize, double measuredLoad) const
+{
+    Prediction prediction;
+    if (sampleRate <= 0.0 || blockSize <= 0)
+        return prediction;
+
+    const double deadline = blockSize / sampleRate;
+
+    if (measuredLoad >= 0.0)
+    {
+        prediction.currentLoad = measuredLoad;
+    }
+    else
+    {
+        // No device running: plugins that were never measured count as free
+        for (const auto& plugin : chain)
+            prediction.currentLoad += juce::jmax(0.0, predictSecondsPerBlock(plugin, blockSize)) / deadline;
+    }
+
+    const double candidateSeconds = predictSecondsPerBlock(candidate, blockSize);
+    prediction.candidateMeasured = candidateSeconds >= 0.0;
+    prediction.predictedLoad = prediction.currentLoad + juce::jmax(0.0, candidateSeconds) / deadline;
+    return prediction;
+}
+
+std::unique_ptr<juce::XmlElement> PluginCostModel::createXml() const
+{
+    auto xml = std::make_unique<juce::XmlElement>("PLUGINCOSTS");
+    std::lock_guard<ProfiledMutex> lock(costMutex);
+
+    for (const auto& plugin : costs)
+    {
+        auto* pluginXml = xml->createNewChildElement("PLUGIN");
+        pluginXml->setAttribute("id", plugin.first);
+
+        for (const auto& cost : plugin.second)
+        {
+            auto* costXml = pluginXml->createNewChildElement("COST");
+            costXml->setAttribute("blockSize", cost.first);
+            costXml->setAttribute("secondsPerSample", cost.second);
+        }
+    }
+
+    return xml;
+}
+
+void PluginCostModel::restoreFromXml(const juce::XmlElement& xml)
+{
+    std::lock_guard<ProfiledMutex> lock(costMutex);
+    costs.clear();
+
+    for (auto* pluginXml : xml.getChildWithTagNameIterator("PLUGIN"))
+    {
+        auto& byBlockSize = costs[pluginXml->getStringAttribute("id")];
+
+        for (auto* costXml : pluginXml->getChildWithTagNameIterator("COST"))
+        {
+            const int blockSize = costXml->getIntAttribute("blockSize");
+            if (blockSize > 0)
+                byBlockSize[blockSize] = costXml->getDoubleAttribute("secondsPerSample");
+        }
+    }
+}
@@ -0,0 +1,79 @@
+//
+// PluginCostModel.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "LinearChainProcessor.h"
+#include "ProfiledMutex.h"
+#include <map>
+#include <memory>
+#include <vector>
+
+/**
+ * Remembers how much CPU time each plugin needs per sample, at the block sizes it was seen at
+ *
+ * Costs come from two places: deep scans run every new plugin on noise at a few block sizes,
+ * and the linear chain reports what its stages actually took while playing. Both are blended
+ * into one figure per block size. Costs at other block sizes are interpolated on a log scale,
+ * since per-sample overhead shrinks as blocks grow.
+ *
+ * From these the host predicts what adding a plugin does to the audio callback load, starting
+ * from the load the device manager measured when a device is running.
+ */
+class PluginCostModel : private juce::Timer
+{
+public:
+    struct Measurement
+    {
+        int blockSize = 0;
+        double secondsPerSample = 0.0;
+    };
+
+    struct Prediction
+    {
+        double currentLoad = 0.0;       // fraction of the callback deadline
+        double predictedLoad = 0.0;     // with the candidate added
+        bool candidateMeasured = false;
+    };
+
+    PluginCostModel();
+    ~PluginCostModel() override;
+
+    /** Prepares the instance at a few block sizes and times it on noise; releases it again afterwards */
+    static std::vector<Measurement> measure(juce::AudioPluginInstance& instance, double sampleRate);
+
+    /** Thread safe */
+    void addMeasurements(const juce::PluginDescription& plugin, const std::vector<Measurement>& measurements);
+
+    /** Samples the chain's stage timings every few seconds while it plays; message thread only */
+    void setChainToWatch(LinearChainProcessor* chain);
+
+    /** CPU seconds the plugin needs for one block of this size, or -1 if it was never measured */
+    double predictSecondsPerBlock(const juce::PluginDescription& plugin, int blockSize) const;
+
+    /**
+     * @param chain         the plugins currently processing, bypassed ones left out
+     * @param measuredLoad  the device manager's CPU usage, or negative to estimate from the chain
+     */
+    Prediction predictLoadWith(const juce::Array<juce::PluginDescription>& chain, const juce::PluginDescription& candidate,
+                               double sampleRate, int blockSize, double measuredLoad) const;
+
+    std::unique_ptr<juce::XmlElement> createXml() const;
+    void restoreFromXml(const juce::XmlElement& xml);
+
+private:
+    void timerCallback() override;
+    void blend(const juce::String& identifier, int blockSize, double secondsPerSample, double weight);
+
+    mutable ProfiledMutex costMutex { "PluginCostModel" };
+    std::map<juce::String, std::map<int, double>> costs; // identifier -> block size -> seconds per sample
+
+    LinearChainProcessor* watchedChain = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginCostModel)
+};
@@ -0,0 +1,205 @@
+//
+// PluginMemoryMonitor.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "PluginMemoryMonitor.h"
+
+#if JUCE_LINUX
+ #include <malloc.h>
+ #include <unistd.h>
+#elif JUCE_MAC
+ #include <mach/mach.h>
+#elif JUCE_WINDOWS
+ #include <windows.h>
+ #include <psapi.h>
+#endif
+
+namespace
+{
+    const int samplingIntervalMs = 5000;
+}
+
+MemoryUsage MemoryUsage::sampleProcess()
+{
+    MemoryUsage usage;
+
+   #if JUCE_LINUX
+    // statm is cheap; smaps_rollup (Linux 4.14+) sums PSS without listing every mapping
+    const juce::StringArray statm = juce::StringArray::fromTokens(juce::File("/proc/self/statm").loadFileAsString(), false);
+    if (statm.size() > 1)
+        usage.residentBytes = statm[1].getLargeIntValue() * (juce::int64) sysconf(_SC_PAGESIZE);
+
+    const juce::StringArray rollup = juce::StringArray::fromLines(juce::File("/proc/self/smaps_rollup").loadFileAsString());
+    for (const auto& line : rollup)
+        if (line.startsWith("Pss:"))
+            usage.proportionalBytes = line.fromFirstOccurrenceOf(":", false, false).getLargeIntValue() * 1024;
+
+    // Nested: __GLIBC_PREREQ is not defined at all on other C libraries
+    #if defined(__GLIBC__)
+     #if __GLIBC_PREREQ(2, 33)
+    const struct mallinfo2 info = mallinfo2();
+    usage.heapBytes = (juce::int64) (info.uordblks + info.hblkhd);
+     #endif
+    #endif
+   #elif JUCE_MAC
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t) &info, &count) == KERN_SUCCESS)
+        usage.residentBytes = (juce::int64) info.resident_size;
+   #elif JUCE_WINDOWS
+    PROCESS_MEMORY_COUNTERS counters;
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        usage.residentBytes = (juce::int64) counters.WorkingSetSize;
+   #endif
+
+    return usage;
+}
+
+//==============================================================================
+PluginMemoryMonitor::PluginMemoryMonitor()
+{
+    startTimer(samplingIntervalMs);
+}
+
+PluginMemoryMonitor::~PluginMemoryMonitor()
+{
+    stopTimer();
+}
+
+void PluginMemoryMonitor::setBudget(juce::int64 bytes, BudgetAction action)
+{
+    budgetBytes = juce::jmax((juce::int64) 0, bytes);
+    budgetAction = action;
+    wasOverBudget = false;
+}
+
+void PluginMemoryMonitor::beginChain()
+{
+    for (auto& entry : footprints)
+    {
+        entry.second.loaded = false;
+        entry.second.hibernated = false;
+    }
+
+    lateGrowthBytes = 0;
+    chainBuiltBytes = -1;
+}
+
+void PluginMemoryMonitor::recordInstance(const juce::PluginDescription& plugin, const MemoryUsage& before)
+{
+    const MemoryUsage after = MemoryUsage::sampleProcess();
+    juce::int64 bytes = 0;
+
+    if (before.getFootprintBytes() >= 0 && after.getFootprintBytes() >= 0)
+        bytes = after.getFootprintBytes() - before.getFootprintBytes();
+
+    // Heap growth catches allocations that have not been touched yet and so are not resident
+    if (before.heapBytes >= 0 && after.heapBytes >= 0)
+        bytes = juce::jmax(bytes, after.heapBytes - before.heapBytes);
+
+    Footprint& footprint = footprints[plugin.createIdentifierString()];
+    footprint.bytes = juce::jmax((juce::int64) 0, bytes);
+    footprint.loaded = true;
+    footprint.hibernated = false;
+}
+
+void PluginMemoryMonitor::keepInstance(const juce::PluginDescription& plugin)
+{
+    Footprint& footprint = footprints[plugin.createIdentifierString()];
+    footprint.loaded = true;
+    footprint.hibernated = false;
+}
+
+void PluginMemoryMonitor::removeInstance(const juce::PluginDescription& plugin)
+{
+    auto found = footprints.find(plugin.createIdentifierString());
+    if (found != footprints.end())
+        found->second.loaded = false;
+}
+
+void PluginMemoryMonitor::recordHibernated(const juce::PluginDescription& plugin)
+{
+    Footprint& footprint = footprints[plugin.createIdentifierString()];
+    footprint.loaded = false;
+    footprint.hibernated = true;
+}
+
+void PluginMemoryMonitor::endChain()
+{
+    chainBuiltBytes = MemoryUsage::sampleProcess().getFootprintBytes();
+    lateGrowthBytes = 0;
+}
+
+juce::int64 PluginMemoryMonitor::getFootprint(const juce::PluginDescription& plugin) const
+{
+    auto found = footprints.find(plugin.createIdentifierString());
+    return found != footprints.end() && found->second.loaded ? found->second.bytes : -1;
+}
+
+bool PluginMemoryMonitor::isHibernated(const juce::PluginDescription& plugin) const
+{
+    auto found = footprints.find(plugin.createIdentifierString());
+    return found != footprints.end() && found->second.hibernated;
+}
+
+juce::int64 PluginMemoryMonitor::getExpectedBytes(const juce::PluginDescription& plugin) const
+{
+    auto found = footprints.find(plugin.createIdentifierString());
+    return found != footprints.end() ? found->second.bytes : 0;
+}
+
+juce::int64 PluginMemoryMonitor::getTotalPluginBytes() const
+{
+    juce::int64 total = lateGrowthBytes;
+
+    for (const auto& entry : footprints)
+        if (entry.second.loaded)
+            total += entry.second.bytes;
+
+    return total;
+}
+
+bool PluginMemoryMonitor::isOverBudget() const
+{
+    return budgetBytes > 0 && getTotalPluginBytes() > budgetBytes;
+}
+
+bool PluginMemoryMonitor::wouldExceedBudget(const juce::PluginDescription& plugin) const
+{
+    if (budgetBytes <= 0)
+        return false;
+
+    // Never measured: let it load once, the chain build checks again afterwards
+    return getTotalPluginBytes() + getExpectedBytes(plugin) > budgetBytes;
+}
+
+juce::String PluginMemoryMonitor::formatBytes(juce::int64 bytes)
+{
+    if (bytes < 0)
+        return "?";
+
+    if (bytes >= ((juce::int64) 1 << 30))
+        return juce::String((double) bytes / (double) ((juce::int64) 1 << 30), 2) + " GB";
+
+    return juce::String((double) bytes / (double) (1 << 20), 1) + " MB";
+}
+
+void PluginMemoryMonitor::timerCallback()
+{
+    if (chainBuiltBytes < 0)
+        return;
+
+    // Only growth counts; memory the chain gives back is not credited to anyone
+    const juce::int64 now = MemoryUsage::sampleProcess().getFootprintBytes();
+    if (now >= 0)
+        lateGrowthBytes = juce::jmax((juce::int64) 0, now - chainBuiltBytes);
+
+    const bool overBudget = isOverBudget();
+    if (overBudget && ! wasOverBudget && onOverBudget != nullptr)
+        onOverBudget();
+
+    wasOverBudget = overBudget;
+}
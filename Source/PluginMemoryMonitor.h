@@ -0,0 +1,116 @@
+//
+// PluginMemoryMonitor.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <functional>
+#include <map>
+
+/**
+ * Process memory figures; any of them is -1 where the platform cannot tell
+ */
+struct MemoryUsage
+{
+    juce::int64 residentBytes = -1;     // RSS
+    juce::int64 proportionalBytes = -1; // PSS - shared pages split between the processes using them (Linux)
+    juce::int64 heapBytes = -1;         // bytes handed out by malloc (glibc)
+
+    static MemoryUsage sampleProcess();
+
+    /** The best single figure available: PSS, else RSS */
+    juce::int64 getFootprintBytes() const noexcept  { return proportionalBytes >= 0 ? proportionalBytes : residentBytes; }
+};
+
+/**
+ * Attributes process memory to plugin instances and enforces a budget on the total
+ *
+ * Each instance is charged the larger of the footprint and heap growth measured around its
+ * instantiation, which catches both mapped binaries and what the constructor allocates.
+ * Memory that appears later - sample libraries loaded lazily, buffers grown while playing -
+ * cannot be pinned on one instance, so periodic sampling charges it to the chain as a whole.
+ * All methods are for the message thread.
+ */
+class PluginMemoryMonitor : private juce::Timer
+{
+public:
+    enum class BudgetAction
+    {
+        warn = 0,       // only tell the user
+        refuse,         // also stop loading plugins that do not fit
+        hibernate       // also unload bypassed plugins until they are switched back on
+    };
+
+    PluginMemoryMonitor();
+    ~PluginMemoryMonitor() override;
+
+    /** A budget of 0 means unlimited */
+    void setBudget(juce::int64 bytes, BudgetAction action);
+    juce::int64 getBudgetBytes() const noexcept             { return budgetBytes; }
+    BudgetAction getBudgetAction() const noexcept           { return budgetAction; }
+
+    /** Forgets the instances of the previous chain; footprints stay known for predictions */
+    void beginChain();
+
+    /** Charges an instance with the memory that appeared since the given sample */
+    void recordInstance(const juce::PluginDescription& plugin, const MemoryUsage& before);
+
+    /** Charges an instance carried over from the previous chain with what it was last measured at */
+    void keepInstance(const juce::PluginDescription& plugin);
+
+    /** Uncharges an instance that was measured but then not kept */
+    void removeInstance(const juce::PluginDescription& plugin);
+
+    /** Marks a plugin as left unloaded to save memory */
+    void recordHibernated(const juce::PluginDescription& plugin);
+
+    /** Finishes a chain build; later growth is measured relative to this point */
+    void endChain();
+
+    /** Bytes charged to a plugin of the current chain, or -1 if it is not loaded */
+    juce::int64 getFootprint(const juce::PluginDescription& plugin) const;
+
+    bool isHibernated(const juce::PluginDescription& plugin) const;
+
+    /** The plugin's last measured footprint, or 0 if it has never been loaded */
+    juce::int64 getExpectedBytes(const juce::PluginDescription& plugin) const;
+
+    /** Growth since the chain was built that no single instance can be charged with */
+    juce::int64 getLateGrowthBytes() const noexcept         { return lateGrowthBytes; }
+
+    /** Instance footprints plus whatever the chain has grown by since it was built */
+    juce::int64 getTotalPluginBytes() const;
+
+    bool isOverBudget() const;
+
+    /** Whether loading the plugin would break the budget, judging by its last measured footprint */
+    bool wouldExceedBudget(const juce::PluginDescription& plugin) const;
+
+    /** Called from the periodic check when the total first goes over budget */
+    std::function<void()> onOverBudget;
+
+    static juce::String formatBytes(juce::int64 bytes);
+
+private:
+    void timerCallback() override;
+
+    struct Footprint
+    {
+        juce::int64 bytes = 0;
+        bool loaded = false;
+        bool hibernated = false;
+    };
+
+    std::map<juce::String, Footprint> footprints; // by plugin identifier
+    juce::int64 chainBuiltBytes = -1;
+    juce::int64 lateGrowthBytes = 0;
+    juce::int64 budgetBytes = 0;
+    BudgetAction budgetAction = BudgetAction::warn;
+    bool wasOverBudget = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginMemoryMonitor)
+};
@@ -0,0 +1,120 @@
+//
+// PluginPrefetcher.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "PluginPrefetcher.h"
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <fcntl.h>
+ #include <unistd.h>
+#endif
+
+namespace
+{
+    // Disk-bound work: a few requests in flight are enough to keep an SSD busy
+    const size_t numPrefetchThreads = 4;
+
+    // Bundles can carry gigabytes of samples; only the first part of a bundle is warmed
+    const juce::int64 maxBytesPerPlugin = (juce::int64) 256 << 20;
+}
+
+PluginPrefetcher::PluginPrefetcher()
+    : pool(numPrefetchThreads)
+{
+}
+
+PluginPrefetcher::~PluginPrefetcher()
+{
+    cancel();
+}
+
+void PluginPrefetcher::prefetch(const juce::Array<juce::PluginDescription>& plugins)
+{
+    cancelled = false;
+
+    for (const auto& plugin : plugins)
+    {
+        // LV2 and AU identifiers are not paths; those formats locate their files themselves
+        const juce::File location(plugin.fileOrIdentifier);
+        if (! juce::File::isAbsolutePath(plugin.fileOrIdentifier) || ! location.exists())
+            continue;
+
+        pool.addJob([this, location]
+        {
+            if (cancelled)
+                return;
+
+            if (! location.isDirectory())
+            {
+                prefetchFile(location);
+                return;
+            }
+
+            // A bundle: the binary and its resources, walked in directory order
+            juce::int64 bytesQueued = 0;
+            for (const auto& entry : juce::RangedDirectoryIterator(location, true, "*", juce::File::findFiles))
+            {
+                if (cancelled || bytesQueued >= maxBytesPerPlugin)
+                    break;
+
+                bytesQueued += entry.getFileSize();
+                prefetchFile(entry.getFile());
+            }
+        });
+    }
+}
+
+void PluginPrefetcher::cancel()
+{
+    cancelled = true;
+}
+
+void PluginPrefetcher::prefetchFile(const juce::File& file)
+{
+    const juce::int64 size = file.getSize();
+    if (size <= 0)
+        return;
+
+   #if JUCE_LINUX
+    // Asynchronous: the kernel queues the reads and returns at once
+    const int fd = open(file.getFullPathName().toRawUTF8(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+
+    const bool issued = posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED) == 0;
+    close(fd);
+   #elif JUCE_MAC
+    const int fd = open(file.getFullPathName().toRawUTF8(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+
+    // F_RDADVISE takes an int count, so large files are advised in pieces
+    bool issued = true;
+    for (juce::int64 offset = 0; offset < size && ! cancelled; offset += (1 << 30))
+    {
+        radvisory advice;
+        advice.ra_offset = (off_t) offset;
+        advice.ra_count = (int) juce::jmin((juce::int64) 1 << 30, size - offset);
+        issued = fcntl(fd, F_RDADVISE, &advice) != -1 && issued;
+    }
+    close(fd);
+   #else
+    // No read-ahead hint to give, so read the file once and let the cache keep it
+    juce::FileInputStream stream(file);
+    if (stream.failedToOpen())
+        return;
+
+    juce::HeapBlock<char> scratch(1 << 20);
+    while (! cancelled && stream.read(scratch, 1 << 20) > 0) {}
+    const bool issued = ! cancelled;
+   #endif
+
+    if (issued)
+    {
+        numFiles++;
+        numBytes += size;
+    }
+}
@@ -0,0 +1,49 @@
+//
+// PluginPrefetcher.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "ThreadPool.h"
+#include <atomic>
+
+/**
+ * Warms the OS page cache with the files of the plugins in the saved chain
+ *
+ * On a cold start loadActivePlugins() spends most of its time page-faulting plugin
+ * binaries and bundle resources in one plugin at a time. The prefetcher is started
+ * as soon as the active plugin list is known and asks the kernel to read every file
+ * ahead in parallel, so that disk I/O overlaps device start-up and the list loading.
+ * Nothing is loaded or executed; plugin code only runs once the chain is built.
+ */
+class PluginPrefetcher
+{
+public:
+    PluginPrefetcher();
+    ~PluginPrefetcher();
+
+    /** Queues the files of these plugins; returns immediately */
+    void prefetch(const juce::Array<juce::PluginDescription>& plugins);
+
+    /** Drops whatever has not started yet */
+    void cancel();
+
+    int getNumFilesPrefetched() const noexcept      { return numFiles.load(); }
+    juce::int64 getBytesPrefetched() const noexcept { return numBytes.load(); }
+
+private:
+    void prefetchFile(const juce::File& file);
+
+    std::atomic<bool> cancelled { false };
+    std::atomic<int> numFiles { 0 };
+    std::atomic<juce::int64> numBytes { 0 };
+
+    // Declared last so that it is joined before the counters its jobs use go away
+    ThreadPool pool;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginPrefetcher)
+};
@@ -0,0 +1,266 @@
+//
+// PluginSearchIndex.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "PluginSearchIndex.h"
+#include <algorithm>
+#include <map>
+
+namespace
+{
+    bool isWordStart(const std::string& text, size_t position)
+    {
+        if (position == 0)
+            return true;
+
+        const char previous = text[position - 1];
+        return previous == ' ' || previous == '-' || previous == '_' || previous == '.' || previous == '(' || previous == '/';
+    }
+
+    std::vector<std::string> splitWords(const juce::String& query)
+    {
+        std::vector<std::string> words;
+        for (const auto& word : juce::StringArray::fromTokens(query.toLowerCase(), " \t", ""))
+            if (word.isNotEmpty())
+                words.push_back(word.toStdString());
+        return words;
+    }
+}
+
+PluginSearchIndex::PluginSearchIndex()
+    : juce::Thread("Plugin search index"),
+      snapshot(std::make_shared<const Snapshot>())
+{
+    startThread(juce::Thread::Priority::low);
+}
+
+PluginSearchIndex::~PluginSearchIndex()
+{
+    stopThread(2000);
+}
+
+void PluginSearchIndex::update(const juce::Array<juce::PluginDescription>& plugins)
+{
+    {
+        std::lock_guard<ProfiledMutex> lock(pendingMutex);
+        pending = std::make_unique<juce::Array<juce::PluginDescription>>(plugins);
+    }
+
+    notify();
+}
+
+int PluginSearchIndex::getNumIndexed() const
+{
+    return (int) getSnapshot()->size();
+}
+
+std::shared_ptr<const PluginSearchIndex::Snapshot> PluginSearchIndex::getSnapshot() const
+{
+    std::lock_guard<ProfiledMutex> lock(snapshotMutex);
+    return snapshot;
+}
+
+void PluginSearchIndex::run()
+{
+    while (! threadShouldExit())
+    {
+        std::unique_ptr<juce::Array<juce::PluginDescription>> plugins;
+        {
+            std::lock_guard<ProfiledMutex> lock(pendingMutex);
+            plugins = std::move(pending);
+        }
+
+        if (plugins == nullptr)
+        {
+            wait(-1);
+            continue;
+        }
+
+        // Plugins already in the index keep their entry unless their searchable text changed
+        const auto previous = getSnapshot();
+        std::map<juce::String, const Entry*> previousById;
+        for (const auto& entry : *previous)
+            previousById[entry.identifier] = &entry;
+
+        auto next = std::make_shared<Snapshot>();
+        next->reserve((size_t) plugins->size());
+
+        for (const auto& plugin : *plugins)
+        {
+            auto found = previousById.find(plugin.createIdentifierString());
+            if (found != previousById.end()
+                && found->second->description.name == plugin.name
+                && found->second->description.manufacturerName == plugin.manufacturerName
+                && found->second->description.category == plugin.category)
+            {
+                next->push_back(*found->second);
+                next->back().description = plugin;
+            }
+            else
+            {
+                next->push_back(createEntry(plugin));
+            }
+        }
+
+        std::sort(next->begin(), next->end(), [](const Entry& a, const Entry& b)
+        {
+            return a.description.name.compareNatural(b.description.name) < 0;
+        });
+
+        std::lock_guard<ProfiledMutex> lock(snapshotMutex);
+        snapshot = std::move(next);
+    }
+}
+
+PluginSearchIndex::Entry PluginSearchIndex::createEntry(const juce::PluginDescription& plugin)
+{
+    Entry entry;
+    entry.description = plugin;
+    entry.identifier = plugin.createIdentifierString();
+
+    // The name comes first so that matches inside it can be recognised by position
+    const std::string name = plugin.name.toLowerCase().toStdString();
+    entry.nameLength = name.size();
+    entry.text = name + " " + plugin.manufacturerName.toLowerCase().toStdString()
+               + " " + plugin.category.toLowerCase().toStdString()
+               + " " + plugin.pluginFormatName.toLowerCase().toStdString();
+    entry.characters = getCharacterMask(entry.text);
+    return entry;
+}
+
+juce::uint64 PluginSearchIndex::getCharacterMask(const std::string& text)
+{
+    juce::uint64 mask = 0;
+
+    for (const char c : text)
+    {
+        if (c >= 'a' && c <= 'z')
+            mask |= (juce::uint64) 1 << (c - 'a');
+        else if (c >= '0' && c <= '9')
+            mask |= (juce::uint64) 1 << (26 + c - '0');
+    }
+
+    return mask;
+}
+
+int PluginSearchIndex::scoreWord(const Entry& entry, const std::string& word)
+{
+    const std::string& text = entry.text;
+
+    // Substring matches outrank everything else, more so at a word start or inside the name
+    const size_t position = text.find(word);
+    if (position != std::string::npos)
+    {
+        int score = 100 - (int) juce::jmin(position, (size_t) 50);
+        if (isWordStart(text, position))
+            score += 40;
+        if (position + word.size() <= entry.nameLength)
+            score += 60;
+        if (position == 0)
+            score += 40;
+        return score;
+    }
+
+    // Otherwise the letters in order, favouring word starts and runs
+    int score = 0;
+    size_t next = 0, previousMatch = std::string::npos;
+
+    for (const char c : word)
+    {
+        next = text.find(c, next);
+        if (next == std::string::npos)
+            return -1;
+
+        score += isWordStart(text, next) ? 8 : 1;
+        if (previousMatch != std::string::npos && next == previousMatch + 1)
+            score += 5;
+        if (next < entry.nameLength)
+            score += 2;
+
+        previousMatch = next++;
+    }
+
+    return score;
+}
+
+PluginSearchIndex::Results PluginSearchIndex::search(const juce::String& query, int maxResults)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    const juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+    const auto current = getSnapshot();
+    const juce::String trimmed = query.trim().toLowerCase();
+    const std::vector<std::string> words = splitWords(trimmed);
+
+    Results results;
+    std::vector<std::pair<int, int>> scored; // (score, entry index)
+
+    if (words.empty())
+    {
+        for (int i = 0; i < juce::jmin(maxResults, (int) current->size()); i++)
+            results.plugins.add((*current)[(size_t) i].description);
+
+        results.numMatches = (int) current->size();
+        lastMatches.clear();
+        lastQuery.clear();
+    }
+    else
+    {
+        juce::uint64 required = 0;
+        for (const auto& word : words)
+            required |= getCharacterMask(word);
+
+        // Anything matching the extended query also matched the shorter one
+        const bool narrowing = current == lastSnapshot && lastQuery.isNotEmpty() && trimmed.startsWith(lastQuery);
+        const size_t numCandidates = narrowing ? lastMatches.size() : current->size();
+
+        std::vector<int> matches;
+        for (size_t i = 0; i < numCandidates; i++)
+        {
+            const int index = narrowing ? lastMatches[i] : (int) i;
+            const Entry& entry = (*current)[(size_t) index];
+
+            if ((entry.characters & required) != required)
+                continue;
+
+            int total = 0;
+            for (const auto& word : words)
+            {
+                const int score = scoreWord(entry, word);
+                if (score < 0)
+                {
+                    total = -1;
+                    break;
+                }
+                total += score;
+            }
+
+            if (total < 0)
+                continue;
+
+            matches.push_back(index);
+            scored.push_back({ total, index });
+        }
+
+        const size_t numShown = juce::jmin((size_t) juce::jmax(0, maxResults), scored.size());
+        std::partial_sort(scored.begin(), scored.begin() + (std::ptrdiff_t) numShown, scored.end(),
+                          [](const std::pair<int, int>& a, const std::pair<int, int>& b)
+                          {
+                              return a.first != b.first ? a.first > b.first : a.second < b.second;
+                          });
+
+        for (size_t i = 0; i < numShown; i++)
+            results.plugins.add((*current)[(size_t) scored[i].second].description);
+
+        results.numMatches = (int) matches.size();
+        lastMatches = std::move(matches);
+        lastQuery = trimmed;
+    }
+
+    lastSnapshot = current;
+    results.milliseconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+    return results;
+}
@@ -0,0 +1,81 @@
+//
+// PluginSearchIndex.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "ProfiledMutex.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Fuzzy search over the known plugin list
+ *
+ * Each plugin is indexed by name, manufacturer, category and format. Every word of the
+ * query has to appear in that text, either as a substring or as a subsequence
+ * ("fabq" finds "FabFilter Pro-Q"); substring and name matches rank first.
+ *
+ * The index is rebuilt on a background thread whenever update() is given a new list,
+ * reusing the entries of plugins that were already indexed. Searching happens on the
+ * message thread against the latest complete index. A query that extends the previous
+ * one only rechecks the previous matches, so typing stays well under a millisecond per
+ * keystroke with ten thousand plugins.
+ */
+class PluginSearchIndex : private juce::Thread
+{
+public:
+    struct Results
+    {
+        juce::Array<juce::PluginDescription> plugins;  // best first, at most maxResults
+        int numMatches = 0;
+        double milliseconds = 0.0;
+    };
+
+    PluginSearchIndex();
+    ~PluginSearchIndex() override;
+
+    /** Queues a re-index of this list; may be called from any thread */
+    void update(const juce::Array<juce::PluginDescription>& plugins);
+
+    /** Message thread only. An empty query lists the plugins by name */
+    Results search(const juce::String& query, int maxResults = 50);
+
+    int getNumIndexed() const;
+
+private:
+    struct Entry
+    {
+        juce::PluginDescription description;
+        juce::String identifier;
+        std::string text;           // lower-case name, manufacturer, category and format
+        size_t nameLength = 0;
+        juce::uint64 characters = 0; // one bit per letter and digit present in text
+    };
+
+    using Snapshot = std::vector<Entry>;
+
+    void run() override;
+    std::shared_ptr<const Snapshot> getSnapshot() const;
+
+    static Entry createEntry(const juce::PluginDescription& plugin);
+    static juce::uint64 getCharacterMask(const std::string& text);
+    static int scoreWord(const Entry& entry, const std::string& word);
+
+    mutable ProfiledMutex snapshotMutex { "PluginSearchIndex snapshot" };
+    std::shared_ptr<const Snapshot> snapshot;
+
+    ProfiledMutex pendingMutex { "PluginSearchIndex pending" };
+    std::unique_ptr<juce::Array<juce::PluginDescription>> pending;
+
+    // Narrowing state for the next keystroke, message thread only
+    std::shared_ptr<const Snapshot> lastSnapshot;
+    juce::String lastQuery;
+    std::vector<int> lastMatches;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginSearchIndex)
+};
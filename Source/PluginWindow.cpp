@@ -9,15 +9,15 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "PluginWindow.h"
 #include "GPUAccelerationManager.h"
+#include "ProfiledMutex.h"
 
 // Replace raw pointer array with a safer container using weak references
 static std::vector<std::weak_ptr<PluginWindow>> activePluginWindowsWeak;
-static std::mutex activeWindowsMutex;
+static ProfiledMutex activeWindowsMutex("PluginWindow active windows");
 
-// Helper to purge expired window references
+// Helper to purge expired window references - the caller must hold activeWindowsMutex
 static void purgeExpiredWindowReferences()
 {
-    std::lock_guard<std::mutex> lock(activeWindowsMutex);
     activePluginWindowsWeak.erase(
         std::remove_if(activePluginWindowsWeak.begin(), activePluginWindowsWeak.end(),
             [](const std::weak_ptr<PluginWindow>& weak) { return weak.expired(); }),
@@ -154,7 +154,7 @@ void PluginWindow::positionPluginWindow()
             
         // Try to avoid having windows stack directly on top of each other
         {
-            std::lock_guard<std::mutex> lock(activeWindowsMutex);
+            std::lock_guard<ProfiledMutex> lock(activeWindowsMutex);
             purgeExpiredWindowReferences();
             for (const auto& weakWindow : activePluginWindowsWeak)
             {
@@ -245,7 +245,7 @@ void PluginWindow::timerCallback()
 
 void PluginWindow::closeCurrentlyOpenWindowsFor(const uint32 nodeId)
 {
-    std::lock_guard<std::mutex> lock(activeWindowsMutex);
+    std::lock_guard<ProfiledMutex> lock(activeWindowsMutex);
     purgeExpiredWindowReferences();
     
     std::vector<std::shared_ptr<PluginWindow>> windowsToClose;
@@ -285,7 +285,7 @@ void PluginWindow::closeAllCurrentlyOpenWindows()
     std::vector<std::shared_ptr<PluginWindow>> windowsToClose;
     
     {
-        std::lock_guard<std::mutex> lock(activeWindowsMutex);
+        std::lock_guard<ProfiledMutex> lock(activeWindowsMutex);
         purgeExpiredWindowReferences();
         
         // First gather all active windows
@@ -319,7 +319,7 @@ void PluginWindow::closeAllCurrentlyOpenWindows()
 
 bool PluginWindow::containsActiveWindows()
 {
-    std::lock_guard<std::mutex> lock(activeWindowsMutex);
+    std::lock_guard<ProfiledMutex> lock(activeWindowsMutex);
     purgeExpiredWindowReferences();
     return !activePluginWindowsWeak.empty();
 }
@@ -409,7 +409,7 @@ PluginWindow* PluginWindow::getWindowFor(juce::AudioProcessorGraph::Node* const
     jassert(node != nullptr);
 
     {
-        std::lock_guard<std::mutex> lock(activeWindowsMutex);
+        std::lock_guard<ProfiledMutex> lock(activeWindowsMutex);
         purgeExpiredWindowReferences();
         for (const auto& weakWindow : activePluginWindowsWeak)
         {
@@ -461,7 +461,7 @@ PluginWindow* PluginWindow::getWindowFor(juce::AudioProcessorGraph::Node* const
         auto newWindow = createPluginWindow(ui, node, type);
         
         // Store a weak reference to the window
-        std::lock_guard<std::mutex> lock(activeWindowsMutex);
+        std::lock_guard<ProfiledMutex> lock(activeWindowsMutex);
         activePluginWindowsWeak.push_back(newWindow);
         
         return newWindow.get();
@@ -494,7 +494,7 @@ void PluginWindow::closeButtonPressed()
     owner->properties.set(getOpenProp(type), false);
     
     // Use proper removal from active windows instead of direct deletion
-    std::lock_guard<std::mutex> lock(activeWindowsMutex);
+    std::lock_guard<ProfiledMutex> lock(activeWindowsMutex);
     
     // Find and remove this window from the activePluginWindowsWeak list
     activePluginWindowsWeak.erase(
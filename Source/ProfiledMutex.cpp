@@ -0,0 +1,282 @@
+//
+// ProfiledMutex.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "ProfiledMutex.h"
+#include <algorithm>
+
+namespace
+{
+    const double traceThresholdSeconds = 0.001;
+    const size_t maxTraceEvents = 10000;
+
+    // The locks this thread holds right now, innermost last
+    thread_local std::vector<LockProfiler::LockStats*> heldLocks;
+
+    void updateMaximum(std::atomic<juce::int64>& maximum, juce::int64 value) noexcept
+    {
+        juce::int64 current = maximum.load();
+        while (value > current && ! maximum.compare_exchange_weak(current, value)) {}
+    }
+
+    double ticksToMillis(juce::int64 ticks)
+    {
+        return juce::Time::highResolutionTicksToSeconds(ticks) * 1000.0;
+    }
+}
+
+LockProfiler& LockProfiler::getInstance()
+{
+    static LockProfiler instance;
+    return instance;
+}
+
+LockProfiler::LockStats& LockProfiler::registerLock(const juce::String& name)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    for (auto& stats : locks)
+        if (stats.name == name)
+            return stats;
+
+    locks.emplace_back();
+    locks.back().name = name;
+    locks.back().id = (int) locks.size() - 1;
+    return locks.back();
+}
+
+void LockProfiler::reset()
+{
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (auto& stats : locks)
+        {
+            stats.acquisitions = 0;
+            stats.contentions = 0;
+            stats.waitTicks = 0;
+            stats.holdTicks = 0;
+            stats.maxWaitTicks = 0;
+            stats.maxHoldTicks = 0;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(orderMutex);
+        observedOrders.clear();
+        orderViolations.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(traceMutex);
+    traceEvents.clear();
+}
+
+juce::String LockProfiler::createReport()
+{
+    std::vector<LockStats*> sorted;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (auto& stats : locks)
+            sorted.push_back(&stats);
+    }
+
+    std::sort(sorted.begin(), sorted.end(), [](const LockStats* a, const LockStats* b) { return a->waitTicks.load() > b->waitTicks.load(); });
+
+    juce::String report;
+    report << juce::String("Lock").paddedRight(' ', 28) << juce::String("Acquired").paddedLeft(' ', 10)
+           << juce::String("Contended").paddedLeft(' ', 11) << juce::String("Wait ms").paddedLeft(' ', 11)
+           << juce::String("Max wait").paddedLeft(' ', 10) << juce::String("Hold ms").paddedLeft(' ', 11)
+           << juce::String("Max hold").paddedLeft(' ', 10) << juce::newLine;
+
+    for (const auto* stats : sorted)
+    {
+        report << stats->name.paddedRight(' ', 28)
+               << juce::String((juce::int64) stats->acquisitions.load()).paddedLeft(' ', 10)
+               << juce::String((juce::int64) stats->contentions.load()).paddedLeft(' ', 11)
+               << juce::String(ticksToMillis(stats->waitTicks.load()), 2).paddedLeft(' ', 11)
+               << juce::String(ticksToMillis(stats->maxWaitTicks.load()), 2).paddedLeft(' ', 10)
+               << juce::String(ticksToMillis(stats->holdTicks.load()), 2).paddedLeft(' ', 11)
+               << juce::String(ticksToMillis(stats->maxHoldTicks.load()), 2).paddedLeft(' ', 10) << juce::newLine;
+    }
+
+    std::lock_guard<std::mutex> lock(orderMutex);
+    if (! orderViolations.isEmpty())
+        report << juce::newLine << "Lock order problems:" << juce::newLine << orderViolations.joinIntoString(juce::newLine) << juce::newLine;
+
+    return report;
+}
+
+bool LockProfiler::writeTrace(const juce::File& file)
+{
+    juce::Array<juce::var> events;
+    {
+        std::lock_guard<std::mutex> lock(traceMutex);
+        for (const auto& event : traceEvents)
+        {
+            auto* object = new juce::DynamicObject();
+            object->setProperty("name", "wait " + event.lockName);
+            object->setProperty("cat", "lock");
+            object->setProperty("ph", "X");
+            object->setProperty("ts", juce::Time::highResolutionTicksToSeconds(event.startTicks) * 1.0e6);
+            object->setProperty("dur", juce::Time::highResolutionTicksToSeconds(event.waitTicks) * 1.0e6);
+            object->setProperty("pid", 1);
+            object->setProperty("tid", (juce::int64) event.threadId);
+
+            auto* args = new juce::DynamicObject();
+            args->setProperty("thread", event.threadName);
+            object->setProperty("args", juce::var(args));
+            events.add(juce::var(object));
+        }
+    }
+
+    return file.replaceWithText(juce::JSON::toString(juce::var(events)));
+}
+
+int LockProfiler::getNumOrderViolations()
+{
+    std::lock_guard<std::mutex> lock(orderMutex);
+    return orderViolations.size();
+}
+
+void LockProfiler::reportProblem(const juce::String& message)
+{
+    juce::Logger::writeToLog("Lock profiler: " + message);
+
+    std::lock_guard<std::mutex> lock(orderMutex);
+    if (! orderViolations.contains(message))
+        orderViolations.add(message);
+}
+
+void LockProfiler::aboutToLock(LockStats& stats)
+{
+    // Taking a lock this thread already holds never returns - say so before hanging
+    if (std::find(heldLocks.begin(), heldLocks.end(), &stats) != heldLocks.end())
+    {
+        reportProblem(stats.name + " locked again by the thread that holds it");
+        jassertfalse;
+    }
+
+    if (! checkLockOrder.load() || heldLocks.empty())
+        return;
+
+    juce::StringArray problems;
+    {
+        std::lock_guard<std::mutex> lock(orderMutex);
+        for (const auto* held : heldLocks)
+        {
+            if (held == &stats)
+                continue;
+
+            if (observedOrders.count({ stats.id, held->id }) > 0)
+                problems.add(stats.name + " taken while holding " + held->name + ", but elsewhere the other way round");
+
+            observedOrders.insert({ held->id, stats.id });
+        }
+    }
+
+    for (const auto& problem : problems)
+        reportProblem(problem);
+}
+
+void LockProfiler::locked(LockStats& stats, juce::int64 waitStartTicks, juce::int64 waitTicks)
+{
+    heldLocks.push_back(&stats);
+    stats.acquisitions++;
+
+    if (waitTicks <= 0)
+        return;
+
+    stats.contentions++;
+    stats.waitTicks += waitTicks;
+    updateMaximum(stats.maxWaitTicks, waitTicks);
+
+    if (juce::Time::highResolutionTicksToSeconds(waitTicks) < traceThresholdSeconds)
+        return;
+
+    auto* thread = juce::Thread::getCurrentThread();
+    const juce::String threadName = thread != nullptr ? thread->getThreadName()
+                                  : juce::MessageManager::existsAndIsCurrentThread() ? juce::String("Message thread")
+                                                                                     : juce::String("Unnamed thread");
+
+    std::lock_guard<std::mutex> lock(traceMutex);
+    if (traceEvents.size() >= maxTraceEvents)
+        traceEvents.pop_front();
+
+    traceEvents.push_back({ stats.name, threadName, waitStartTicks, waitTicks,
+                            (juce::uint64) (juce::pointer_sized_uint) juce::Thread::getCurrentThreadId() });
+}
+
+void LockProfiler::unlocked(LockStats& stats, juce::int64 holdTicks)
+{
+    auto held = std::find(heldLocks.rbegin(), heldLocks.rend(), &stats);
+    if (held != heldLocks.rend())
+        heldLocks.erase(std::next(held).base());
+
+    stats.holdTicks += holdTicks;
+    updateMaximum(stats.maxHoldTicks, holdTicks);
+}
+
+//==============================================================================
+ProfiledMutex::ProfiledMutex(const juce::String& name)
+    : stats(LockProfiler::getInstance().registerLock(name))
+{
+}
+
+void ProfiledMutex::lock()
+{
+    auto& profiler = LockProfiler::getInstance();
+
+    if (! profiler.isEnabled())
+    {
+        mutex.lock();
+        acquiredTicks = 0;
+        return;
+    }
+
+    profiler.aboutToLock(stats);
+
+    // Uncontended locks cost one extra timestamp; only real waits are timed
+    juce::int64 waitStart = 0, waitTicks = 0;
+    if (! mutex.try_lock())
+    {
+        waitStart = juce::Time::getHighResolutionTicks();
+        mutex.lock();
+        waitTicks = juce::Time::getHighResolutionTicks() - waitStart;
+    }
+
+    acquiredTicks = juce::Time::getHighResolutionTicks();
+    profiler.locked(stats, waitStart, waitTicks);
+}
+
+bool ProfiledMutex::try_lock()
+{
+    if (! mutex.try_lock())
+        return false;
+
+    auto& profiler = LockProfiler::getInstance();
+    if (profiler.isEnabled())
+    {
+        acquiredTicks = juce::Time::getHighResolutionTicks();
+        profiler.locked(stats, 0, 0);
+    }
+    else
+    {
+        acquiredTicks = 0;
+    }
+
+    return true;
+}
+
+void ProfiledMutex::unlock()
+{
+    // A lock taken while profiling was off has nothing to report
+    if (acquiredTicks != 0)
+    {
+        LockProfiler::getInstance().unlocked(stats, juce::Time::getHighResolutionTicks() - acquiredTicks);
+        acquiredTicks = 0;
+    }
+
+    mutex.unlock();
+}
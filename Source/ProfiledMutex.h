@@ -0,0 +1,118 @@
+//
+// ProfiledMutex.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+/**
+ * Collects contention, wait and hold times for every ProfiledMutex, grouped by lock name
+ *
+ * Waits longer than a millisecond are also kept as trace events, which can be saved in the
+ * Chrome trace format and opened in chrome://tracing or Perfetto. The optional lock-order
+ * checker remembers which locks have been taken while holding which others and reports any
+ * pair taken in both orders, i.e. a potential deadlock, before it actually happens.
+ */
+class LockProfiler
+{
+public:
+    struct LockStats
+    {
+        juce::String name;
+        int id = 0;
+        std::atomic<juce::uint64> acquisitions { 0 };
+        std::atomic<juce::uint64> contentions { 0 };
+        std::atomic<juce::int64> waitTicks { 0 };
+        std::atomic<juce::int64> holdTicks { 0 };
+        std::atomic<juce::int64> maxWaitTicks { 0 };
+        std::atomic<juce::int64> maxHoldTicks { 0 };
+    };
+
+    static LockProfiler& getInstance();
+
+    /** Returns the statistics shared by every lock with this name; the reference stays valid */
+    LockStats& registerLock(const juce::String& name);
+
+    void setEnabled(bool shouldBeEnabled) noexcept          { enabled.store(shouldBeEnabled); }
+    bool isEnabled() const noexcept                         { return enabled.load(); }
+
+    void setLockOrderChecking(bool shouldCheck) noexcept    { checkLockOrder.store(shouldCheck); }
+    bool isCheckingLockOrder() const noexcept               { return checkLockOrder.load(); }
+
+    /** Clears all counters, trace events and reported order violations */
+    void reset();
+
+    /** A table of every lock, worst total wait first */
+    juce::String createReport();
+
+    /** Writes the recorded long waits as a Chrome trace */
+    bool writeTrace(const juce::File& file);
+
+    int getNumOrderViolations();
+
+    //==============================================================================
+    // Called by ProfiledMutex
+    void aboutToLock(LockStats& stats);
+    void locked(LockStats& stats, juce::int64 waitStartTicks, juce::int64 waitTicks);
+    void unlocked(LockStats& stats, juce::int64 holdTicks);
+
+private:
+    LockProfiler() = default;
+
+    struct TraceEvent
+    {
+        juce::String lockName, threadName;
+        juce::int64 startTicks, waitTicks;
+        juce::uint64 threadId;
+    };
+
+    void reportProblem(const juce::String& message);
+
+    std::atomic<bool> enabled { true };
+    std::atomic<bool> checkLockOrder { false };
+
+    // The profiler's own locks are plain mutexes, otherwise it would profile itself
+    std::mutex registryMutex;
+    std::deque<LockStats> locks;
+
+    std::mutex orderMutex;
+    std::set<std::pair<int, int>> observedOrders; // (held, then acquired)
+    juce::StringArray orderViolations;
+
+    std::mutex traceMutex;
+    std::deque<TraceEvent> traceEvents;
+
+    JUCE_DECLARE_NON_COPYABLE(LockProfiler)
+};
+
+/**
+ * A std::mutex that reports to the LockProfiler
+ * Works with std::lock_guard and std::unique_lock; condition variables need
+ * std::condition_variable_any. Not for the audio thread.
+ */
+class ProfiledMutex
+{
+public:
+    explicit ProfiledMutex(const juce::String& name);
+
+    void lock();
+    bool try_lock();
+    void unlock();
+
+private:
+    std::mutex mutex;
+    LockProfiler::LockStats& stats;
+    juce::int64 acquiredTicks = 0; // only touched by the owning thread
+
+    JUCE_DECLARE_NON_COPYABLE(ProfiledMutex)
+};
@@ -0,0 +1,166 @@
+//
+// QuickAddPalette.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "QuickAddPalette.h"
+#include "PluginSearchIndex.h"
+
+class QuickAddPalette::Content : public juce::Component,
+                                 private juce::ListBoxModel,
+                                 private juce::KeyListener
+{
+public:
+    Content(PluginSearchIndex& searchIndex,
+            std::function<void(const juce::PluginDescription&)> onPluginChosen,
+            std::function<void()> onCloseRequested)
+        : index(searchIndex), onChosen(std::move(onPluginChosen)), onClose(std::move(onCloseRequested))
+    {
+        searchBox.setTextToShowWhenEmpty("Search plugins by name, manufacturer, category or format",
+                                         juce::Colours::grey);
+        searchBox.setFont(juce::Font(16.0f));
+        searchBox.onTextChange = [this] { refresh(); };
+        searchBox.onReturnKey = [this] { chooseRow(list.getSelectedRow()); };
+        searchBox.onEscapeKey = [this] { if (onClose != nullptr) onClose(); };
+        searchBox.addKeyListener(this);
+        addAndMakeVisible(searchBox);
+
+        list.setModel(this);
+        list.setRowHeight(24);
+        addAndMakeVisible(list);
+
+        status.setFont(juce::Font(12.0f));
+        status.setColour(juce::Label::textColourId, juce::Colours::grey);
+        addAndMakeVisible(status);
+
+        setSize(520, 380);
+        refresh();
+    }
+
+    ~Content() override
+    {
+        searchBox.removeKeyListener(this);
+    }
+
+    void resized() override
+    {
+        auto area = getLocalBounds().reduced(8);
+        searchBox.setBounds(area.removeFromTop(30));
+        area.removeFromTop(6);
+        status.setBounds(area.removeFromBottom(18));
+        list.setBounds(area);
+    }
+
+    void visibilityChanged() override
+    {
+        if (isShowing())
+            searchBox.grabKeyboardFocus();
+    }
+
+private:
+    void refresh()
+    {
+        const PluginSearchIndex::Results found = index.search(searchBox.getText());
+        results = found.plugins;
+
+        list.updateContent();
+        list.selectRow(0);
+        list.repaint();
+
+        status.setText(juce::String(found.numMatches) + " of " + juce::String(index.getNumIndexed()) + " plugins, "
+                           + juce::String(found.milliseconds, 2) + " ms",
+                       juce::dontSendNotification);
+    }
+
+    void chooseRow(int row)
+    {
+        if (! juce::isPositiveAndBelow(row, results.size()))
+            return;
+
+        if (onChosen != nullptr)
+            onChosen(results.getReference(row));
+
+        if (onClose != nullptr)
+            onClose();
+    }
+
+    //==============================================================================
+    int getNumRows() override   { return results.size(); }
+
+    void paintListBoxItem(int row, juce::Graphics& g, int width, int height, bool rowIsSelected) override
+    {
+        if (! juce::isPositiveAndBelow(row, results.size()))
+            return;
+
+        if (rowIsSelected)
+            g.fillAll(juce::Colours::lightblue);
+
+        const auto& plugin = results.getReference(row);
+        auto area = juce::Rectangle<int>(0, 0, width, height).reduced(6, 0);
+
+        g.setColour(juce::Colours::grey);
+        g.setFont(12.0f);
+        const juce::String details = plugin.category.isNotEmpty() ? plugin.category + ", " + plugin.pluginFormatName
+                                                                  : plugin.pluginFormatName;
+        g.drawText(details, area.removeFromRight(150), juce::Justification::centredRight, true);
+
+        g.setColour(juce::Colours::black);
+        g.setFont(14.0f);
+        g.drawText(plugin.name + "  -  " + plugin.manufacturerName, area, juce::Justification::centredLeft, true);
+    }
+
+    void listBoxItemDoubleClicked(int row, const juce::MouseEvent&) override   { chooseRow(row); }
+    void returnKeyPressed(int row) override                                    { chooseRow(row); }
+
+    //==============================================================================
+    // Arrow keys move through the results while the search box keeps the focus
+    bool keyPressed(const juce::KeyPress& key, juce::Component*) override
+    {
+        const int row = list.getSelectedRow();
+
+        if (key == juce::KeyPress::downKey)
+            list.selectRow(juce::jmin(row + 1, results.size() - 1));
+        else if (key == juce::KeyPress::upKey)
+            list.selectRow(juce::jmax(row - 1, 0));
+        else
+            return false;
+
+        return true;
+    }
+
+    PluginSearchIndex& index;
+    std::function<void(const juce::PluginDescription&)> onChosen;
+    std::function<void()> onClose;
+
+    juce::TextEditor searchBox;
+    juce::ListBox list;
+    juce::Label status;
+    juce::Array<juce::PluginDescription> results;
+};
+
+QuickAddPalette::QuickAddPalette(PluginSearchIndex& index,
+                                 std::function<void(const juce::PluginDescription&)> onPluginChosen,
+                                 std::function<void()> onCloseRequested)
+    : juce::DocumentWindow("Quick Add Plugin", juce::Colours::white, juce::DocumentWindow::closeButton),
+      onClose(onCloseRequested)
+{
+    setContentOwned(new Content(index, std::move(onPluginChosen), std::move(onCloseRequested)), true);
+    setUsingNativeTitleBar(true);
+    setResizable(true, false);
+    centreWithSize(getWidth(), getHeight());
+    setVisible(true);
+    toFront(true);
+}
+
+QuickAddPalette::~QuickAddPalette()
+{
+    clearContentComponent();
+}
+
+void QuickAddPalette::closeButtonPressed()
+{
+    if (onClose != nullptr)
+        onClose();
+}
@@ -0,0 +1,37 @@
+//
+// QuickAddPalette.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <functional>
+
+class PluginSearchIndex;
+
+/**
+ * A search box over the known plugins: type a few letters of a name, manufacturer,
+ * category or format, pick a result with the arrow keys and press return to add it
+ * to the end of the chain. Escape closes the palette.
+ */
+class QuickAddPalette : public juce::DocumentWindow
+{
+public:
+    /** onCloseRequested is where the owner deletes the window */
+    QuickAddPalette(PluginSearchIndex& index,
+                    std::function<void(const juce::PluginDescription&)> onPluginChosen,
+                    std::function<void()> onCloseRequested);
+    ~QuickAddPalette() override;
+
+    void closeButtonPressed() override;
+
+private:
+    class Content;
+
+    std::function<void()> onClose;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(QuickAddPalette)
+};
@@ -0,0 +1,71 @@
+//
+// RcuPointer.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+#include <memory>
+
+/**
+ * Owns an object that real-time threads read while another thread replaces it
+ *
+ * Readers pin the current object with a ScopedReader for one block or one message, without
+ * locking. swap() publishes a replacement, waits until no reader can still hold the old
+ * object and hands it back, so it is never freed under a reader. Only one thread may swap.
+ */
+template <typename ObjectType>
+class RcuPointer
+{
+public:
+    RcuPointer() = default;
+    ~RcuPointer()                                   { swap(nullptr); }
+
+    /** Keeps the current object alive for as long as the reader exists */
+    class ScopedReader
+    {
+    public:
+        explicit ScopedReader(const RcuPointer& pointerToRead) noexcept
+            : owner(pointerToRead)
+        {
+            owner.numReaders.fetch_add(1);
+            object = owner.current.load();
+        }
+
+        ~ScopedReader() noexcept                    { owner.numReaders.fetch_sub(1); }
+
+        ObjectType* get() const noexcept            { return object; }
+        ObjectType* operator->() const noexcept     { return object; }
+
+    private:
+        const RcuPointer& owner;
+        ObjectType* object = nullptr;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedReader)
+    };
+
+    /** Publishes the replacement and returns the previous object once no reader holds it */
+    std::unique_ptr<ObjectType> swap(std::unique_ptr<ObjectType> replacement)
+    {
+        std::unique_ptr<ObjectType> previous(current.exchange(replacement.release()));
+
+        // Readers only hold an object for one block or one message
+        while (numReaders.load() > 0)
+            juce::Thread::yield();
+
+        return previous;
+    }
+
+    /** The current object, without pinning it; only on the thread that swaps */
+    ObjectType* getForWriter() const noexcept       { return current.load(); }
+
+private:
+    std::atomic<ObjectType*> current { nullptr };
+    mutable std::atomic<int> numReaders { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(RcuPointer)
+};
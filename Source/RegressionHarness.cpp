@@ -0,0 +1,327 @@
+//
+// RegressionHarness.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "RegressionHarness.h"
+#include "ChainBuilder.h"
+#include "LinearChainProcessor.h"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    const double defaultSampleRate = 48000.0;
+    const int defaultBlockSize = 256;
+    const double defaultTolerance = 0.25;
+
+    // Timings this small are dominated by timer noise, so allow a little absolute slack too
+    const double timingSlackMicros = 1.0;
+
+    const char* const percentileNames[] = { "p50", "p90", "p99" };
+    const int percentiles[] = { 50, 90, 99 };
+
+    struct RenderResult
+    {
+        juce::String hash;
+        double timings[3] = { 0.0, 0.0, 0.0 };
+    };
+
+    bool loadPluginDescription(juce::AudioPluginFormatManager& formatManager, const juce::String& pathOrIdentifier,
+                               juce::PluginDescription& description)
+    {
+        for (auto* format : formatManager.getFormats())
+        {
+            if (! format->fileMightContainThisPluginType(pathOrIdentifier))
+                continue;
+
+            juce::OwnedArray<juce::PluginDescription> types;
+            format->findAllTypesForFile(types, pathOrIdentifier);
+
+            if (! types.isEmpty())
+            {
+                description = *types.getFirst();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool loadInput(const juce::var& testCase, const juce::File& baseDirectory, juce::AudioBuffer<float>& input,
+                   double& sampleRate, juce::String& error)
+    {
+        const juce::String inputPath = testCase["input"].toString();
+
+        if (inputPath.isNotEmpty())
+        {
+            juce::AudioFormatManager audioFormats;
+            audioFormats.registerBasicFormats();
+
+            const juce::File inputFile = baseDirectory.getChildFile(inputPath);
+            std::unique_ptr<juce::AudioFormatReader> reader(audioFormats.createReaderFor(inputFile));
+
+            if (reader == nullptr)
+            {
+                error = "Cannot read input " + inputFile.getFullPathName();
+                return false;
+            }
+
+            input.setSize((int) reader->numChannels, (int) reader->lengthInSamples);
+            reader->read(&input, 0, (int) reader->lengthInSamples, 0, true, true);
+
+            if (sampleRate <= 0.0)
+                sampleRate = reader->sampleRate;
+
+            return true;
+        }
+
+        // No file - seeded noise is just as reproducible and needs nothing on disk
+        if (sampleRate <= 0.0)
+            sampleRate = defaultSampleRate;
+
+        const double seconds = testCase.getProperty("noiseSeconds", 5.0);
+        const int numChannels = testCase.getProperty("channels", 2);
+        juce::Random random((juce::int64) (int) testCase.getProperty("seed", 1));
+
+        input.setSize(numChannels, (int) (seconds * sampleRate));
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < input.getNumSamples(); ++i)
+                input.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+        return true;
+    }
+
+    RenderResult render(juce::AudioProcessor& processor, const juce::AudioBuffer<float>& input,
+                        double sampleRate, int blockSize)
+    {
+        const int numChannels = input.getNumChannels();
+
+        processor.setNonRealtime(true);
+        processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> block(numChannels, blockSize);
+        juce::MidiBuffer midi;
+        juce::MemoryOutputStream rendered((size_t) input.getNumSamples() * (size_t) numChannels * sizeof(float));
+        std::vector<double> micros;
+
+        for (int position = 0; position < input.getNumSamples(); position += blockSize)
+        {
+            const int numSamples = juce::jmin(blockSize, input.getNumSamples() - position);
+            block.setSize(numChannels, numSamples, false, false, true);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                block.copyFrom(ch, 0, input, ch, position, numSamples);
+
+            midi.clear();
+
+            const juce::int64 start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(block, midi);
+            const juce::int64 end = juce::Time::getHighResolutionTicks();
+            micros.push_back(juce::Time::highResolutionTicksToSeconds(end - start) * 1.0e6);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                rendered.write(block.getReadPointer(ch), (size_t) numSamples * sizeof(float));
+        }
+
+        processor.releaseResources();
+
+        RenderResult result;
+        result.hash = juce::SHA256(rendered.getData(), rendered.getDataSize()).toHexString();
+
+        if (! micros.empty())
+        {
+            std::sort(micros.begin(), micros.end());
+            for (int i = 0; i < 3; ++i)
+                result.timings[i] = micros[juce::jmin(micros.size() - 1, (micros.size() * (size_t) percentiles[i]) / 100)];
+        }
+
+        return result;
+    }
+
+    juce::var runCase(juce::var& testCase, const juce::File& baseDirectory, double specSampleRate,
+                      int blockSize, double specTolerance, bool updateGolden, bool& passed)
+    {
+        auto* report = new juce::DynamicObject();
+        juce::var reportVar(report);
+        juce::StringArray errors;
+
+        const juce::String name = testCase["name"].toString();
+        report->setProperty("name", name);
+        std::cout << "Case " << name << std::endl;
+
+        // Resolve the chain
+        juce::AudioPluginFormatManager formatManager;
+        formatManager.addDefaultFormats();
+
+        std::vector<ChainEntry> entries;
+        if (auto* plugins = testCase["plugins"].getArray())
+        {
+            for (const auto& plugin : *plugins)
+            {
+                ChainEntry entry;
+                const juce::String path = plugin["plugin"].toString();
+                const juce::File pluginFile = baseDirectory.getChildFile(path);
+                const juce::String identifier = pluginFile.exists() ? pluginFile.getFullPathName() : path;
+
+                if (! loadPluginDescription(formatManager, identifier, entry.plugin))
+                {
+                    errors.add("Cannot load plugin " + path);
+                    continue;
+                }
+
+                entry.state = plugin["state"].toString();
+                entry.bypass = plugin["bypass"];
+                entries.push_back(entry);
+            }
+        }
+
+        double sampleRate = specSampleRate;
+        juce::AudioBuffer<float> input;
+        juce::String inputError;
+        if (! loadInput(testCase, baseDirectory, input, sampleRate, inputError))
+            errors.add(inputError);
+
+        const juce::String engine = testCase.getProperty("engine", "both").toString();
+        const double tolerance = testCase.getProperty("tolerance", specTolerance);
+        // When recording new golden values the old ones are irrelevant
+        const juce::String expectedHash = updateGolden ? juce::String() : testCase["expectedHash"].toString();
+        auto* engineReports = new juce::DynamicObject();
+        report->setProperty("engines", juce::var(engineReports));
+
+        if (! testCase["baseline"].isObject() && updateGolden)
+            testCase.getDynamicObject()->setProperty("baseline", juce::var(new juce::DynamicObject()));
+
+        juce::StringArray hashes;
+
+        if (errors.isEmpty())
+        {
+            for (const juce::String engineName : { "linear", "graph" })
+            {
+                if (engine != "both" && engine != engineName)
+                    continue;
+
+                // Fresh instances per engine so no plugin carries state from the previous render
+                juce::AudioProcessorGraph graph;
+                LinearChainProcessor linearChain;
+                ChainBuilder builder(formatManager);
+                const ChainBuilder::Result chain = builder.build(entries, graph, linearChain, sampleRate, blockSize);
+                errors.addArray(chain.errors);
+
+                juce::AudioProcessor& processor = engineName == "linear" ? static_cast<juce::AudioProcessor&>(linearChain)
+                                                                         : graph;
+                const RenderResult result = render(processor, input, sampleRate, blockSize);
+                linearChain.clearStages();
+                hashes.add(result.hash);
+
+                auto* engineReport = new juce::DynamicObject();
+                engineReports->setProperty(engineName, juce::var(engineReport));
+                engineReport->setProperty("hash", result.hash);
+                engineReport->setProperty("hashMatches", expectedHash.isEmpty() || result.hash == expectedHash);
+
+                if (expectedHash.isNotEmpty() && result.hash != expectedHash)
+                    errors.add(engineName + " output hash " + result.hash + " differs from golden " + expectedHash);
+
+                const juce::var baseline = updateGolden ? juce::var() : testCase["baseline"][juce::Identifier(engineName)];
+
+                for (int i = 0; i < 3; ++i)
+                {
+                    const double measured = result.timings[i];
+                    engineReport->setProperty(percentileNames[i], measured);
+
+                    if (baseline.hasProperty(percentileNames[i]))
+                    {
+                        const double limit = (double) baseline[percentileNames[i]] * (1.0 + tolerance) + timingSlackMicros;
+                        engineReport->setProperty(juce::String(percentileNames[i]) + "Baseline", baseline[percentileNames[i]]);
+
+                        if (measured > limit)
+                            errors.add(engineName + " " + percentileNames[i] + " " + juce::String(measured, 2)
+                                       + " us exceeds baseline limit " + juce::String(limit, 2) + " us");
+                    }
+                }
+
+                if (updateGolden)
+                {
+                    auto* newBaseline = new juce::DynamicObject();
+                    for (int i = 0; i < 3; ++i)
+                        newBaseline->setProperty(percentileNames[i], result.timings[i]);
+                    testCase["baseline"].getDynamicObject()->setProperty(engineName, juce::var(newBaseline));
+                }
+            }
+        }
+
+        // A case without a golden hash would pass whatever it rendered
+        if (! updateGolden && expectedHash.isEmpty())
+            errors.add("no golden hash - record one with -update-golden");
+
+        // Both engines must produce the very same samples, golden hash or not
+        if (hashes.size() == 2 && hashes[0] != hashes[1])
+            errors.add("linear and graph engines produced different output");
+
+        if (updateGolden && ! hashes.isEmpty() && errors.isEmpty())
+            testCase.getDynamicObject()->setProperty("expectedHash", hashes[0]);
+
+        passed = errors.isEmpty();
+        report->setProperty("passed", passed);
+        report->setProperty("errors", juce::var(errors));
+
+        for (const auto& error : errors)
+            std::cout << "  FAIL " << error << std::endl;
+        std::cout << (passed ? "  passed" : "  failed") << std::endl;
+
+        return reportVar;
+    }
+}
+
+int RegressionHarness::run(const juce::File& specFile, const juce::File& reportFile, bool updateGolden)
+{
+    juce::var spec = juce::JSON::parse(specFile);
+
+    if (! spec.isObject())
+    {
+        std::cerr << "Cannot parse regression spec " << specFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    const double sampleRate = spec.getProperty("sampleRate", 0.0);
+    const int blockSize = spec.getProperty("blockSize", defaultBlockSize);
+    const double tolerance = spec.getProperty("tolerance", defaultTolerance);
+
+    auto* report = new juce::DynamicObject();
+    juce::var reportVar(report);
+    juce::Array<juce::var> caseReports;
+    bool allPassed = true;
+
+    report->setProperty("spec", specFile.getFullPathName());
+    report->setProperty("time", juce::Time::getCurrentTime().toISO8601(true));
+    report->setProperty("blockSize", blockSize);
+
+    if (auto* cases = spec["cases"].getArray())
+    {
+        for (auto& testCase : *cases)
+        {
+            bool passed = false;
+            caseReports.add(runCase(testCase, specFile.getParentDirectory(), sampleRate, blockSize,
+                                    tolerance, updateGolden, passed));
+            allPassed = allPassed && passed;
+        }
+    }
+
+    report->setProperty("passed", allPassed);
+    report->setProperty("cases", caseReports);
+
+    if (! reportFile.replaceWithText(juce::JSON::toString(reportVar)))
+        std::cerr << "Cannot write report " << reportFile.getFullPathName() << std::endl;
+
+    if (updateGolden && ! specFile.replaceWithText(juce::JSON::toString(spec)))
+        std::cerr << "Cannot update golden values in " << specFile.getFullPathName() << std::endl;
+
+    std::cout << (allPassed ? "All regression cases passed" : "Regression cases failed")
+              << " - report written to " << reportFile.getFullPathName() << std::endl;
+
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,29 @@
+//
+// RegressionHarness.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/**
+ * Renders reference chains offline and checks them against golden values
+ *
+ * Each case in the JSON spec names a chain of plugin files, an input file (or a seeded noise
+ * length) and the expected output hash and timing baseline. Chains are built with the same
+ * ChainBuilder as the tray host and rendered without an audio device, through the linear
+ * engine, the graph or both. The output must be bit-identical to the golden hash, which every
+ * case needs, and the per-block timing percentiles must stay within tolerance of the baseline
+ * where the case has one.
+ *
+ * Run with -regression=spec.json [-report=report.json] [-update-golden]
+ */
+class RegressionHarness
+{
+public:
+    /** Runs every case, writes the JSON report and returns 0 only if all of them passed */
+    static int run(const juce::File& specFile, const juce::File& reportFile, bool updateGolden);
+};
@@ -11,9 +11,12 @@
 #define SAFEPLUGINSCANNER_H_INCLUDED
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "PluginCostModel.h"
+#include "ProfiledMutex.h"
 #include "ThreadPool.h"
 
 #include <atomic>
+#include <functional>
 #include <future>
 #include <memory>
 #include <chrono>
@@ -54,10 +57,23 @@ public:
     // Use shared_ptr instead of raw pointer for better safety
     void setProgressListener(std::shared_ptr<PluginScanProgressListener> listener)
     {
-        std::lock_guard<std::mutex> lock(progressListenerMutex);
+        std::lock_guard<ProfiledMutex> lock(progressListenerMutex);
         progressListener = listener;
     }
     
+    // For callers that only need a callback
+    void setProgressListener(std::function<void(float, const juce::String&)> callback)
+    {
+        struct CallbackListener : public PluginScanProgressListener
+        {
+            explicit CallbackListener(std::function<void(float, const juce::String&)> f) : function(std::move(f)) {}
+            void onScanProgressUpdate(float progressPercent, const juce::String& statusMessage) override { function(progressPercent, statusMessage); }
+            std::function<void(float, const juce::String&)> function;
+        };
+        
+        setProgressListener(std::make_shared<CallbackListener>(std::move(callback)));
+    }
+    
     // Check if scan timed out
     bool didScanTimeout() const { return scanTimedOut; }
     
@@ -67,11 +83,28 @@ public:
     // Get the number of valid plugins found
     int getNumPluginsFound() const { return numFound; }
     
+    // Number of files and bundles found in the search path that might be plugins
+    int getNumCandidates() const { return numCandidates.load(); }
+    
+    // Number of searches and test loads that were abandoned because they took too long
+    int getNumTimeouts() const { return numTimeouts.load(); }
+    
+    // Replace the default search path, e.g. to scan a synthetic benchmark tree
+    void setSearchPath(const juce::FileSearchPath& newSearchPath) { searchPath = newSearchPath; }
+    
+    // Headless scans never show dialogs, consult the blacklist or post to the message thread
+    void setHeadless(bool shouldBeHeadless) { headless = shouldBeHeadless; }
+    
+    // Plugins that load are also timed at a few block sizes and recorded here
+    void setCostModel(std::weak_ptr<PluginCostModel> modelToUse) { costModel = std::move(modelToUse); }
+    
     void run() override
     {
         scanTimedOut = false;
         scanCancelled.store(false);
         numFound = 0;
+        numCandidates.store(0);
+        numTimeouts.store(0);
         
         // Find the requested format
         juce::AudioPluginFormat* format = nullptr;
@@ -86,6 +119,9 @@ public:
         
         if (format == nullptr)
         {
+            if (headless)
+                return;
+            
             juce::AlertWindow::showMessageBox(juce::AlertWindow::WarningIcon,
                                    "Plugin Scan Error", 
                                    formatName + " format not available.");
@@ -97,7 +133,13 @@ public:
         
         try
         {
-            int totalPaths = searchPath.getNumPaths();
+            // Walk the search path for candidate files and bundles, then search each one
+            juce::Array<juce::File> candidates;
+            for (int i = 0; i < searchPath.getNumPaths(); ++i)
+                findCandidates(format, searchPath[i], candidates);
+            
+            numCandidates.store(candidates.size());
+            int totalPaths = candidates.size();
             
             // Create a thread pool for parallel scanning
             // Use a reasonable number of threads - one per CPU core but no more than 8
@@ -106,10 +148,10 @@ public:
             
             // Progress tracking
             std::atomic<int> completedPaths(0);
-            std::mutex resultsMutex; // Protects access to the results array
+            ProfiledMutex resultsMutex("Scanner results"); // Protects access to the results array
             
             // Initial status update
-            juce::String statusMsg = "Scanning " + juce::String(totalPaths) + " paths with " +
+            juce::String statusMsg = "Scanning " + juce::String(totalPaths) + " candidates with " +
                                     juce::String(numThreads) + " parallel threads";
             setStatusMessage(statusMsg);
             updateProgressListener(0.0f, statusMsg);
@@ -127,15 +169,7 @@ public:
                     break;
                 }
                 
-                const juce::File& path = searchPath[i];
-                
-                // Skip scanning of empty or non-existent directories
-                if (!path.exists() || !path.isDirectory() || path.getNumberOfChildFiles(juce::File::findFilesAndDirectories) == 0) 
-                {
-                    // Count this as completed
-                    completedPaths++;
-                    continue;
-                }
+                const juce::File path = candidates.getReference(i);
                 
                 // Submit task to thread pool
                 auto future = scanPool.addJob(
@@ -155,16 +189,12 @@ public:
                                                 " of " + juce::String(totalPaths) + 
                                                 " paths: " + path.getFileName();
                         
-                        juce::MessageManager::callAsync([this, progress, statusUpdate]() {
-                            setStatusMessage(statusUpdate);
-                            setProgress(progress);
-                            updateProgressListener(progress, statusUpdate);
-                        });
+                        postProgress(progress, statusUpdate);
                         
                         // Transfer local results to main result array
                         if (pathResults.size() > 0)
                         {
-                            std::lock_guard<std::mutex> lock(resultsMutex);
+                            std::lock_guard<ProfiledMutex> lock(resultsMutex);
                             for (int j = 0; j < pathResults.size(); ++j)
                             {
                                 // Transfer ownership of each description to the main results array
@@ -198,6 +228,9 @@ public:
         }
         catch (const std::exception& e)
         {
+            if (headless)
+                return;
+            
             // Use Desktop::getInstance() to ensure this runs on the message thread
             const juce::String errorMsg = juce::String("Error: ") + e.what();
             juce::MessageManager::callAsync([errorMsg]() {
@@ -209,6 +242,9 @@ public:
         }
         catch (...)
         {
+            if (headless)
+                return;
+            
             juce::MessageManager::callAsync([]() {
                 juce::AlertWindow::showMessageBox(juce::AlertWindow::WarningIcon,
                                           "Plugin Scan Error",
@@ -229,7 +265,7 @@ public:
         
         std::atomic<int> completedTests(0);
         std::atomic<int> validTests(0);
-        std::mutex pluginListMutex; // Protects access to the plugin list
+        ProfiledMutex pluginListMutex("Scanner plugin list"); // Protects access to the plugin list
         
         // Vector to hold futures for plugin test tasks
         std::vector<std::future<void>> testTasks;
@@ -257,16 +293,12 @@ public:
                                              " of " + juce::String(totalPlugins) + 
                                              " plugins: " + desc->name;
                     
-                    juce::MessageManager::callAsync([this, progress, statusUpdate]() {
-                        setStatusMessage(statusUpdate);
-                        setProgress(progress);
-                        updateProgressListener(progress, statusUpdate);
-                    });
+                    postProgress(progress, statusUpdate);
                     
                     if (isValid)
                     {
                         // Add valid plugin to the list safely
-                        std::lock_guard<std::mutex> lock(pluginListMutex);
+                        std::lock_guard<ProfiledMutex> lock(pluginListMutex);
                         pluginList.addType(*desc);
                         validTests++;
                         numFound++;
@@ -315,32 +347,39 @@ public:
         if (format == nullptr || threadShouldExit())
             return;
             
-        std::promise<void> searchPromise;
-        std::future<void> searchFuture = searchPromise.get_future();
-        std::atomic<bool> exceptionOccurred(false);
-        juce::String exceptionMessage;
+        // The search state is shared with the worker so a search we give up on can still finish safely
+        struct SearchState
+        {
+            std::promise<void> promise;
+            juce::OwnedArray<juce::PluginDescription> results;
+            std::atomic<bool> exceptionOccurred { false };
+            juce::String exceptionMessage;
+        };
         
-        juce::Thread::launch([&, path]()
+        auto state = std::make_shared<SearchState>();
+        std::future<void> searchFuture = state->promise.get_future();
+        
+        juce::Thread::launch([state, format, path]()
         {
             try 
             {
-                format->findAllTypesForFile(results, path);
-                searchPromise.set_value();
+                format->findAllTypesForFile(state->results, path.getFullPathName());
+                state->promise.set_value();
             }
             catch (const std::exception& e)
             {
-                exceptionOccurred.store(true);
-                exceptionMessage = e.what();
+                state->exceptionMessage = e.what();
+                state->exceptionOccurred.store(true);
                 try {
-                    searchPromise.set_exception(std::current_exception());
+                    state->promise.set_exception(std::current_exception());
                 }
                 catch (...) {} // Set exception might throw if promise was already satisfied
             }
             catch (...)
             {
-                exceptionOccurred.store(true);
+                state->exceptionOccurred.store(true);
                 try {
-                    searchPromise.set_exception(std::current_exception());
+                    state->promise.set_exception(std::current_exception());
                 }
                 catch (...) {} // Set exception might throw if promise was already satisfied
             }
@@ -356,22 +395,28 @@ public:
         if (searchFuture.wait_for(std::chrono::milliseconds(maxWaitTimeMs)) == std::future_status::timeout)
         {
             scanTimedOut = true;
+            numTimeouts++;
             setStatusMessage("Warning: Scan timed out for " + path.getFullPathName());
             juce::Thread::sleep(1000); // Give user time to see message
             return;
         }
         
         // Check if search threw an exception
-        if (exceptionOccurred.load())
+        if (state->exceptionOccurred.load())
         {
             setStatusMessage("Warning: Error scanning " + path.getFullPathName() + 
-                            (exceptionMessage.isNotEmpty() ? (" - " + exceptionMessage) : ""));
+                            (state->exceptionMessage.isNotEmpty() ? (" - " + state->exceptionMessage) : ""));
             juce::Thread::sleep(1000);
             return;
         }
         
         try {
             searchFuture.get(); // Will re-throw any exception from the thread
+            
+            // Hand the descriptions over to the caller
+            for (int i = 0; i < state->results.size(); ++i)
+                results.add(state->results.getUnchecked(i));
+            state->results.clearQuick(false);
         }
         catch (const std::exception& e)
         {
@@ -387,45 +432,58 @@ public:
     bool isPluginSafe(const juce::PluginDescription& desc)
     {
         // Skip blacklisted plugins
-        if (isPluginBlacklisted(desc))
+        if (!headless && isPluginBlacklisted(desc))
         {
             setStatusMessage("Skipping blacklisted plugin: " + desc.name);
             juce::Thread::sleep(300); // Shorter pause to speed up scanning
             return false;
         }
             
-        // Try loading the plugin with a timeout
-        std::atomic<bool> loadComplete(false);
-        std::atomic<bool> loadSuccessful(false);
-        juce::String errorMessage;
+        // Try loading the plugin with a timeout. The state is shared with the loader thread
+        // so a plugin that hangs past the timeout cannot touch this stack frame later
+        struct LoadState
+        {
+            std::atomic<bool> complete { false };
+            std::atomic<bool> successful { false };
+            juce::String errorMessage;
+        };
         
-        // Use a shared_ptr for better memory management
-        std::shared_ptr<juce::AudioPluginInstance> instance;
+        auto state = std::make_shared<LoadState>();
+        juce::AudioPluginFormatManager* manager = &formatManager;
+        std::weak_ptr<PluginCostModel> model = costModel;
             
-        juce::Thread::launch([&]()
+        juce::Thread::launch([state, manager, model, desc]()
         {
             try 
             {
-                std::unique_ptr<juce::AudioPluginInstance> pluginInstance = formatManager.createPluginInstance(
-                    desc, 44100.0, 512, errorMessage);
+                std::unique_ptr<juce::AudioPluginInstance> instance = manager->createPluginInstance(
+                    desc, 44100.0, 512, state->errorMessage);
                     
-                if (pluginInstance != nullptr)
+                if (instance != nullptr)
                 {
-                    // Transfer ownership to our shared_ptr
-                    instance = std::shared_ptr<juce::AudioPluginInstance>(pluginInstance.release());
-                    
                     // Test basic functionality
                     instance->prepareToPlay(44100.0, 512);
                     instance->releaseResources();
-                    loadSuccessful.store(true);
+                    state->successful.store(true);
                 }
                 
-                loadComplete.store(true);
+                // The verdict is in; measuring is not part of the load and must not count against its timeout
+                state->complete.store(true);
+                
+                if (instance != nullptr)
+                {
+                    if (auto locked = model.lock())
+                    {
+                        // One at a time, so plugins measured by parallel tests do not skew each other's timings
+                        std::lock_guard<ProfiledMutex> lock(getMeasurementMutex());
+                        locked->addMeasurements(desc, PluginCostModel::measure(*instance, 44100.0));
+                    }
+                }
             }
             catch (...)
             {
                 // Ensure we mark loading as complete even if an exception occurs
-                loadComplete.store(true);
+                state->complete.store(true);
             }
         });
             
@@ -440,29 +498,33 @@ public:
         int elapsed = 0;
         const int checkInterval = 100;
             
-        while (!loadComplete.load() && !threadShouldExit() && !scanCancelled.load())
+        while (!state->complete.load() && !threadShouldExit() && !scanCancelled.load())
         {
             juce::Thread::sleep(checkInterval);
             elapsed += checkInterval;
                 
             if (elapsed > maxWaitTimeMs)
             {
+                numTimeouts++;
                 setStatusMessage("Plugin load timeout: " + desc.name);
                 juce::Thread::sleep(500);
                 return false; // Plugin took too long to load
             }
         }
         
-        // Explicitly clear the instance to ensure proper cleanup
-        instance.reset();
-            
-        return loadSuccessful.load();
+        return state->successful.load();
+    }
+    
+    static ProfiledMutex& getMeasurementMutex()
+    {
+        static ProfiledMutex mutex("Scanner cost measurement");
+        return mutex;
     }
     
     bool isPluginBlacklisted(const juce::PluginDescription& desc)
     {
         // Thread-safe blacklist checking
-        std::lock_guard<std::mutex> lock(blacklistMutex);
+        std::lock_guard<ProfiledMutex> lock(blacklistMutex);
         
         // Get the blacklist from settings
         juce::String blacklistStr = juce::JUCEApplication::getInstance()->getGlobalProperties()->getUserSettings()->getValue("pluginBlacklist", "");
@@ -481,7 +543,7 @@ public:
     void handlePluginLoadFailure(const juce::PluginDescription& desc)
     {
         // Only show the dialog if we're not in the process of exiting
-        if (threadShouldExit() || scanCancelled.load())
+        if (headless || threadShouldExit() || scanCancelled.load())
             return;
             
         // Create a variable to store the result since we can't capture by reference in the lambda
@@ -515,7 +577,7 @@ public:
         if (shouldBlacklist->load() && !threadShouldExit() && !scanCancelled.load())
         {
             // Thread-safe blacklist update
-            std::lock_guard<std::mutex> lock(blacklistMutex);
+            std::lock_guard<ProfiledMutex> lock(blacklistMutex);
             
             juce::String pluginId = desc.pluginFormatName + ":" + desc.fileOrIdentifier;
                 
@@ -538,6 +600,49 @@ public:
     }
 
 private:
+    /**
+     * Collects every file or bundle the format might load, descending into ordinary subfolders
+     * This applies to every scan, not just the benchmark: each search path is walked instead of
+     * handing its root to findAllTypesForFile, and symlinked folders are never followed
+     */
+    void findCandidates(juce::AudioPluginFormat* format, const juce::File& directory, juce::Array<juce::File>& candidates)
+    {
+        if (threadShouldExit())
+            return;
+        
+        if (format->fileMightContainThisPluginType(directory.getFullPathName()))
+        {
+            candidates.add(directory);
+            return;
+        }
+        
+        if (!directory.isDirectory())
+            return;
+        
+        for (const auto& entry : juce::RangedDirectoryIterator(directory, false, "*", juce::File::findFilesAndDirectories))
+        {
+            const juce::File file = entry.getFile();
+            
+            if (format->fileMightContainThisPluginType(file.getFullPathName()))
+                candidates.add(file);
+            else if (entry.isDirectory() && !file.isSymbolicLink()) // Symlinked folders are how scan loops happen
+                findCandidates(format, file, candidates);
+        }
+    }
+    
+    void postProgress(float progress, const juce::String& statusUpdate)
+    {
+        if (headless)
+            return;
+        
+        // Update status safely on the message thread
+        juce::MessageManager::callAsync([this, progress, statusUpdate]() {
+            setStatusMessage(statusUpdate);
+            setProgress(progress);
+            updateProgressListener(progress, statusUpdate);
+        });
+    }
+    
     void updateProgressListener(float progress, const juce::String& message)
     {
         // Use rate limiting to avoid too many UI updates
@@ -550,7 +655,7 @@ private:
         {
             lastProgressUpdateTime = now;
             
-            std::lock_guard<std::mutex> lock(progressListenerMutex);
+            std::lock_guard<ProfiledMutex> lock(progressListenerMutex);
             if (progressListener != nullptr)
             {
                 progressListener->onScanProgressUpdate(progress, message);
@@ -605,9 +710,13 @@ private:
     bool scanTimedOut;
     int numFound;
     std::atomic<bool> scanCancelled;
+    std::atomic<int> numCandidates { 0 };
+    std::atomic<int> numTimeouts { 0 };
+    bool headless = false;
+    std::weak_ptr<PluginCostModel> costModel;   // loader threads can outlive the scan and its owner
     std::shared_ptr<PluginScanProgressListener> progressListener;
-    std::mutex progressListenerMutex;
-    std::mutex blacklistMutex;
+    ProfiledMutex progressListenerMutex { "Scanner progress listener" };
+    ProfiledMutex blacklistMutex { "Scanner blacklist" };
     juce::FileSearchPath searchPath;
     std::chrono::steady_clock::time_point lastProgressUpdateTime;
     
@@ -0,0 +1,182 @@
+//
+// SampleRateBridge.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "SampleRateBridge.h"
+#include "MidiInputRouter.h"
+#include <cmath>
+#include <cstring>
+
+SampleRateBridge::SampleRateBridge(int factorToUse)
+    : factor(juce::jlimit(2, maxFactor, factorToUse))
+{
+    designFilter();
+}
+
+void SampleRateBridge::designFilter()
+{
+    // Blackman-windowed sinc, flat to 90% of the low rate's Nyquist frequency and about 74 dB down
+    // from 110% of it; the little that aliases lands above the passband. The window's transition is
+    // 5.5 / length wide, which is what sets tapsPerPhase
+    const int length = factor * tapsPerPhase;
+    const double cutoff = 0.5 / factor;
+    const double centre = (length - 1) / 2.0;
+    const double pi = juce::MathConstants<double>::pi;
+
+    std::vector<double> taps((size_t) length);
+    double sum = 0.0;
+    for (int k = 0; k < length; k++)
+    {
+        const double x = k - centre;
+        const double sinc = x == 0.0 ? 2.0 * cutoff : std::sin(2.0 * pi * cutoff * x) / (pi * x);
+        const double window = 0.42 - 0.5 * std::cos(2.0 * pi * k / (length - 1)) + 0.08 * std::cos(4.0 * pi * k / (length - 1));
+        taps[(size_t) k] = sinc * window;
+        sum += taps[(size_t) k];
+    }
+
+    // Decimation reads phase p at tap factor - 1 - p + factor * i; interpolation at p + factor * i with the zero-stuffing gain
+    decimationTaps.assign((size_t) factor, std::vector<float>((size_t) tapsPerPhase));
+    interpolationTaps.assign((size_t) factor, std::vector<float>((size_t) tapsPerPhase));
+    for (int p = 0; p < factor; p++)
+    {
+        for (int i = 0; i < tapsPerPhase; i++)
+        {
+            decimationTaps[(size_t) p][(size_t) i] = (float) (taps[(size_t) (factor - 1 - p + factor * i)] / sum);
+            interpolationTaps[(size_t) p][(size_t) i] = (float) (factor * taps[(size_t) (p + factor * i)] / sum);
+        }
+    }
+}
+
+void SampleRateBridge::prepare(juce::AudioProcessor& processor, double sampleRate, int maximumBlockSize)
+{
+    maxLowSamples = (maximumBlockSize + factor - 1) / factor + 1;
+
+    processor.setRateAndBufferSizeDetails(sampleRate / factor, maxLowSamples);
+    processor.prepareToPlay(sampleRate / factor, maxLowSamples);
+
+    const int numChannels = juce::jmax(1, processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels());
+    const int history = tapsPerPhase - 1;
+
+    channels.assign((size_t) numChannels, Channel());
+    for (auto& channel : channels)
+    {
+        channel.staging.assign((size_t) (maximumBlockSize + factor), 0.0f);
+        channel.phases.assign((size_t) factor, std::vector<float>((size_t) (history + maxLowSamples), 0.0f));
+        channel.low.assign((size_t) maxLowSamples, 0.0f);
+        channel.lowHistory.assign((size_t) (history + maxLowSamples), 0.0f);
+        channel.upPhases.assign((size_t) factor, std::vector<float>((size_t) maxLowSamples, 0.0f));
+        channel.pending.assign((size_t) (maximumBlockSize + 2 * factor), 0.0f);
+    }
+
+    lowPointers.malloc((size_t) numChannels);
+    lowMidi.ensureSize(MidiRoute::maxBlockBytes);
+
+    // Starting factor - 1 samples ahead means a whole block of output is always ready
+    numCarried = 0;
+    numPending = factor - 1;
+}
+
+int SampleRateBridge::getLatencySamples(const juce::AudioProcessor& processor) const noexcept
+{
+    // Each filter delays by (length - 1) / 2; the head start on the output makes up for the carried input
+    return factor * tapsPerPhase - 1 + processor.getLatencySamples() * factor;
+}
+
+void SampleRateBridge::process(juce::AudioProcessor& processor, juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi) noexcept
+{
+    const int numSamples = buffer.getNumSamples();
+    const int numChannels = juce::jmin(buffer.getNumChannels(), (int) channels.size());
+    const int numGroups = (numCarried + numSamples) / factor;
+    const int numLeftOver = (numCarried + numSamples) % factor;
+    const int history = tapsPerPhase - 1;
+
+    if (numGroups > maxLowSamples || numSamples + numCarried > (int) channels[0].staging.size())
+    {
+        buffer.clear();
+        return;
+    }
+
+    for (int ch = 0; ch < numChannels; ch++)
+    {
+        auto& channel = channels[(size_t) ch];
+        std::memcpy(channel.staging.data() + numCarried, buffer.getReadPointer(ch), sizeof(float) * (size_t) numSamples);
+
+        // Split into phases, then low[m] = sum over phases and taps of tap * phase[m - i]
+        for (int p = 0; p < factor; p++)
+        {
+            float* phase = channel.phases[(size_t) p].data() + history;
+            for (int g = 0; g < numGroups; g++)
+                phase[g] = channel.staging[(size_t) (g * factor + p)];
+        }
+
+        juce::FloatVectorOperations::clear(channel.low.data(), numGroups);
+        for (int p = 0; p < factor; p++)
+        {
+            const float* phase = channel.phases[(size_t) p].data();
+            for (int i = 0; i < tapsPerPhase; i++)
+                juce::FloatVectorOperations::addWithMultiply(channel.low.data(), phase + history - i,
+                                                             decimationTaps[(size_t) p][(size_t) i], numGroups);
+        }
+
+        for (auto& phase : channel.phases)
+            std::memmove(phase.data(), phase.data() + numGroups, sizeof(float) * (size_t) history);
+        std::memmove(channel.staging.data(), channel.staging.data() + numGroups * factor, sizeof(float) * (size_t) numLeftOver);
+
+        lowPointers[ch] = channel.low.data();
+    }
+
+    for (int ch = numChannels; ch < (int) channels.size(); ch++)
+    {
+        juce::FloatVectorOperations::clear(channels[(size_t) ch].low.data(), numGroups);
+        lowPointers[ch] = channels[(size_t) ch].low.data();
+    }
+
+    // Events land on the low-rate sample their group becomes, and come back at its first chain-rate sample
+    if (numGroups > 0)
+    {
+        lowMidi.clear();
+        for (const auto metadata : midi)
+            MidiRoute::addIfRoom(lowMidi, metadata.data, metadata.numBytes,
+                                 juce::jmin(numGroups - 1, (numCarried + metadata.samplePosition) / factor));
+
+        juce::AudioBuffer<float> lowBuffer(lowPointers.get(), (int) channels.size(), numGroups);
+        processor.processBlock(lowBuffer, lowMidi);
+
+        midi.clear();
+        for (const auto metadata : lowMidi)
+            MidiRoute::addIfRoom(midi, metadata.data, metadata.numBytes, juce::jmin(numSamples - 1, metadata.samplePosition * factor));
+    }
+
+    for (int ch = 0; ch < numChannels; ch++)
+    {
+        auto& channel = channels[(size_t) ch];
+        std::memcpy(channel.lowHistory.data() + history, channel.low.data(), sizeof(float) * (size_t) numGroups);
+
+        // out[m * factor + p] = sum over taps of tap * low[m - i], one phase at a time
+        for (int p = 0; p < factor; p++)
+        {
+            float* up = channel.upPhases[(size_t) p].data();
+            juce::FloatVectorOperations::clear(up, numGroups);
+            for (int i = 0; i < tapsPerPhase; i++)
+                juce::FloatVectorOperations::addWithMultiply(up, channel.lowHistory.data() + history - i,
+                                                             interpolationTaps[(size_t) p][(size_t) i], numGroups);
+        }
+
+        std::memmove(channel.lowHistory.data(), channel.lowHistory.data() + numGroups, sizeof(float) * (size_t) history);
+
+        float* pending = channel.pending.data() + numPending;
+        for (int g = 0; g < numGroups; g++)
+            for (int p = 0; p < factor; p++)
+                pending[g * factor + p] = channel.upPhases[(size_t) p][(size_t) g];
+
+        std::memcpy(buffer.getWritePointer(ch), channel.pending.data(), sizeof(float) * (size_t) numSamples);
+        std::memmove(channel.pending.data(), channel.pending.data() + numSamples,
+                     sizeof(float) * (size_t) (numPending + numGroups * factor - numSamples));
+    }
+
+    numCarried = numLeftOver;
+    numPending += numGroups * factor - numSamples;
+}
@@ -0,0 +1,67 @@
+//
+// SampleRateBridge.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <vector>
+
+/**
+ * Runs a processor at an integer fraction of the chain's sample rate
+ *
+ * The input is decimated and the output interpolated with the same windowed-sinc lowpass,
+ * both as polyphase filters: every tap is one FloatVectorOperations pass over a whole block
+ * of low-rate samples. Blocks that are not a multiple of the factor carry their remainder into
+ * the next one, so the processor sees a varying number of samples. Every buffer is allocated
+ * in prepare().
+ */
+class SampleRateBridge
+{
+public:
+    static constexpr int maxFactor = 4;
+
+    /** The processor runs at the chain's rate divided by factor, 2 to maxFactor */
+    explicit SampleRateBridge(int factor);
+
+    int getFactor() const noexcept      { return factor; }
+
+    /** Prepares the processor at the reduced rate and allocates the filters for its channels */
+    void prepare(juce::AudioProcessor& processor, double sampleRate, int maximumBlockSize);
+
+    /** The filters' delay plus the processor's own latency, in samples at the chain's rate */
+    int getLatencySamples(const juce::AudioProcessor& processor) const noexcept;
+
+    /** Processes in place; the processor's callback lock must already be held */
+    void process(juce::AudioProcessor& processor, juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi) noexcept;
+
+private:
+    struct Channel
+    {
+        std::vector<float> staging;                 // chain-rate input not yet part of a whole group
+        std::vector<std::vector<float>> phases;     // the input split by phase, with filter history in front
+        std::vector<float> low;                     // what the processor works on
+        std::vector<float> lowHistory;              // its output, with filter history in front
+        std::vector<std::vector<float>> upPhases;   // one interpolated phase each
+        std::vector<float> pending;                 // chain-rate output waiting to be handed out
+    };
+
+    void designFilter();
+
+    const int factor;
+    const int tapsPerPhase = 56;       // enough for a 0.9 to 1.1 times low-rate Nyquist transition
+    std::vector<std::vector<float>> decimationTaps;      // [phase][tap]
+    std::vector<std::vector<float>> interpolationTaps;   // [phase][tap]
+
+    std::vector<Channel> channels;
+    juce::HeapBlock<float*> lowPointers;
+    juce::MidiBuffer lowMidi;
+    int numCarried = 0;
+    int numPending = 0;
+    int maxLowSamples = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleRateBridge)
+};
@@ -0,0 +1,214 @@
+//
+// ScannerBenchmark.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "ScannerBenchmark.h"
+#include "SafePluginScanner.h"
+#include <iostream>
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <sys/resource.h>
+ #include <sys/stat.h>
+#endif
+
+namespace
+{
+    const int numFakeBundles = 2000;
+    const int nestingDepth = 16;
+    const int numEmptyDirectories = 500;
+    const int numUnreadableFiles = 200;
+    const int numSymlinkLoops = 20;
+    const int copiesPerTestPlugin = 5;
+    const int fakeBinaryBytes = 4096;
+    const int sampleIntervalMs = 50;
+
+    // Reference plugins worth scanning in-process - the crasher would take the benchmark down with it
+    const char* const testPluginNames[] = { "NovaTestUnity", "NovaTestCpuBurner", "NovaTestFixedLatency",
+                                            "NovaTestSlowLoader", "NovaTestHanger" };
+
+    /** Samples thread count and resident memory while the scan runs */
+    class ResourceMonitor : public juce::Thread
+    {
+    public:
+        ResourceMonitor() : juce::Thread("Scanner benchmark monitor") {}
+
+        void run() override
+        {
+            while (! threadShouldExit())
+            {
+                sample();
+                wait(sampleIntervalMs);
+            }
+        }
+
+        void sample()
+        {
+            // /proc is the only place that knows the live thread count; elsewhere the peaks stay unknown
+            const juce::StringArray lines = juce::StringArray::fromLines(juce::File("/proc/self/status").loadFileAsString());
+
+            for (const auto& line : lines)
+            {
+                if (line.startsWith("Threads:"))
+                    peakThreads = juce::jmax(peakThreads.load(), line.fromFirstOccurrenceOf(":", false, false).getIntValue());
+                else if (line.startsWith("VmHWM:"))
+                    peakRssKb = juce::jmax(peakRssKb.load(), line.fromFirstOccurrenceOf(":", false, false).getLargeIntValue());
+            }
+        }
+
+        std::atomic<int> peakThreads { -1 };
+        std::atomic<juce::int64> peakRssKb { -1 };
+    };
+
+    double getCpuSeconds()
+    {
+       #if JUCE_LINUX || JUCE_MAC
+        rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+            return (double) usage.ru_utime.tv_sec + (double) usage.ru_utime.tv_usec / 1.0e6
+                 + (double) usage.ru_stime.tv_sec + (double) usage.ru_stime.tv_usec / 1.0e6;
+       #endif
+        return -1.0;
+    }
+
+    void writeFakeBundle(const juce::File& bundle, juce::Random& random)
+    {
+        // Same layout as a real Linux VST3 bundle, but the binary is garbage
+        const juce::File binary = bundle.getChildFile("Contents/x86_64-linux/" + bundle.getFileNameWithoutExtension() + ".so");
+        binary.getParentDirectory().createDirectory();
+
+        juce::MemoryBlock garbage((size_t) fakeBinaryBytes);
+        random.fillBitsRandomly(garbage.getData(), garbage.getSize());
+        binary.replaceWithData(garbage.getData(), garbage.getSize());
+    }
+
+    int generateTree(const juce::File& root, const juce::File& testPluginDirectory)
+    {
+        juce::Random random(0x5ca7);
+        int numEntries = 0;
+
+        // A spine of deeply nested folders to hang everything off
+        juce::Array<juce::File> levels;
+        juce::File level = root;
+        for (int depth = 0; depth < nestingDepth; ++depth)
+        {
+            levels.add(level);
+            level = level.getChildFile("level" + juce::String(depth));
+            level.createDirectory();
+            ++numEntries;
+        }
+        levels.add(level);
+
+        for (int i = 0; i < numFakeBundles; ++i)
+        {
+            writeFakeBundle(levels[random.nextInt(levels.size())].getChildFile("Fake" + juce::String(i) + ".vst3"), random);
+            ++numEntries;
+        }
+
+        for (int i = 0; i < numEmptyDirectories; ++i)
+        {
+            levels[random.nextInt(levels.size())].getChildFile("empty" + juce::String(i)).createDirectory();
+            ++numEntries;
+        }
+
+        for (int i = 0; i < numUnreadableFiles; ++i)
+        {
+            const juce::File file = levels[random.nextInt(levels.size())].getChildFile("unreadable" + juce::String(i) + ".vst3");
+            file.replaceWithText("not a plugin");
+           #if JUCE_LINUX || JUCE_MAC
+            chmod(file.getFullPathName().toRawUTF8(), 0);
+           #endif
+            ++numEntries;
+        }
+
+        // Each loop points a folder back at one of its ancestors
+        for (int i = 0; i < numSymlinkLoops; ++i)
+        {
+            const int depth = 1 + random.nextInt(levels.size() - 1);
+            const juce::File target = levels[random.nextInt(depth)];
+            levels[depth].getChildFile("loop" + juce::String(i)).createSymbolicLink(target, true);
+            ++numEntries;
+        }
+
+        if (testPluginDirectory.isDirectory())
+        {
+            for (const auto* name : testPluginNames)
+            {
+                const juce::File bundle = testPluginDirectory.getChildFile(juce::String(name) + "/" + name + ".vst3");
+                if (! bundle.isDirectory())
+                {
+                    std::cout << "Test plugin " << bundle.getFullPathName() << " not found, skipped" << std::endl;
+                    continue;
+                }
+
+                for (int copy = 0; copy < copiesPerTestPlugin; ++copy)
+                {
+                    bundle.copyDirectoryTo(levels[random.nextInt(levels.size())].getChildFile(
+                        juce::String(name) + juce::String(copy) + ".vst3"));
+                    ++numEntries;
+                }
+            }
+        }
+
+        return numEntries;
+    }
+
+    void removeTree(const juce::File& root)
+    {
+        // Symlinks are removed, not followed, so the loops cannot drag the deletion outside the tree
+        root.deleteRecursively(false);
+    }
+}
+
+int ScannerBenchmark::run(const juce::File& testPluginDirectory)
+{
+    const juce::File root = juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("NovaHostScannerBenchmark");
+    removeTree(root);
+
+    if (! root.createDirectory())
+    {
+        std::cerr << "Cannot create " << root.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Generating plugin tree in " << root.getFullPathName() << std::endl;
+    const int numEntries = generateTree(root, testPluginDirectory);
+
+    juce::AudioPluginFormatManager formatManager;
+    formatManager.addDefaultFormats();
+    juce::KnownPluginList pluginList;
+
+    // This only bounds how long the progress window waits for the thread to stop; every search and
+    // test load still runs under the scanner's own per-plugin timeouts, so they show up as timeouts
+    SafePluginScanner scanner(formatManager, pluginList, "VST3", 600000);
+    scanner.setHeadless(true);
+    scanner.setSearchPath(juce::FileSearchPath(root.getFullPathName()));
+
+    ResourceMonitor monitor;
+    monitor.sample();
+    monitor.startThread();
+
+    const double cpuStart = getCpuSeconds();
+    const juce::int64 start = juce::Time::getHighResolutionTicks();
+    scanner.run();
+    const double wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+    const double cpuEnd = getCpuSeconds();
+
+    monitor.stopThread(1000);
+    monitor.sample();
+
+    std::cout << "Entries generated:   " << numEntries << std::endl
+              << "Candidates found:    " << scanner.getNumCandidates() << std::endl
+              << "Plugins accepted:    " << scanner.getNumPluginsFound() << std::endl
+              << "Wall time:           " << juce::String(wallSeconds, 3) << " s" << std::endl
+              << "CPU time:            " << (cpuStart >= 0.0 ? juce::String(cpuEnd - cpuStart, 3) : juce::String("-1")) << " s" << std::endl
+              << "Files per second:    " << juce::String(wallSeconds > 0.0 ? scanner.getNumCandidates() / wallSeconds : 0.0, 1) << std::endl
+              << "Peak threads:        " << monitor.peakThreads.load() << std::endl
+              << "Peak RSS:            " << monitor.peakRssKb.load() << " kB" << std::endl
+              << "Timeouts:            " << scanner.getNumTimeouts() << std::endl;
+
+    removeTree(root);
+    return 0;
+}
@@ -0,0 +1,27 @@
+//
+// ScannerBenchmark.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/**
+ * Times the plugin scanner against a generated search-path tree
+ *
+ * The tree mixes thousands of fake VST3 bundles with deep nesting, empty folders, unreadable
+ * files and symlink loops, plus copies of the reference test plugins when their build folder is
+ * given - including the slow loader and the hanger, so timeouts show up in the numbers. The
+ * crasher is left out because the scan runs in this process.
+ *
+ * Run with -benchmark-scanner[=TestPlugins/build]; the report is written to stdout
+ */
+class ScannerBenchmark
+{
+public:
+    /** Builds the tree, scans it headless and returns a process exit code */
+    static int run(const juce::File& testPluginDirectory);
+};
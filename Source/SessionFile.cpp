@@ -0,0 +1,324 @@
+//
+// SessionFile.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "SessionFile.h"
+#include <algorithm>
+
+namespace
+{
+    const int pollIntervalMs = 1000;
+
+    juce::String describeEntry(int index, const juce::var& entry)
+    {
+        const juce::String name = entry.getProperty("plugin", juce::var()).toString();
+        return "chain[" + juce::String(index) + "]" + (name.isNotEmpty() ? " (" + name + ")" : juce::String());
+    }
+
+    /** By identifier first; a plain name is fine while it is unambiguous */
+    bool resolvePlugin(const juce::KnownPluginList& knownPlugins, const juce::String& name,
+                       juce::PluginDescription& result, juce::String& error)
+    {
+        const juce::Array<juce::PluginDescription> types = knownPlugins.getTypes();
+        int numNameMatches = 0;
+
+        for (const auto& type : types)
+        {
+            if (type.createIdentifierString() == name)
+            {
+                result = type;
+                return true;
+            }
+
+            if (type.name.equalsIgnoreCase(name))
+            {
+                result = type;
+                numNameMatches++;
+            }
+        }
+
+        if (numNameMatches == 1)
+            return true;
+
+        error = numNameMatches == 0 ? "unknown plugin \"" + name + "\""
+                                    : "\"" + name + "\" matches " + juce::String(numNameMatches) + " plugins, use its identifier";
+        return false;
+    }
+}
+
+//==============================================================================
+bool SessionPlugin::changesWiringFrom(const SessionPlugin& other) const
+{
+    return ! plugin.isDuplicateOf(other.plugin)
+        || sidechain.toString() != other.sidechain.toString()
+        || rateDivisor != other.rateDivisor;
+}
+
+bool SessionPlugin::needsReloadFrom(const SessionPlugin& other) const
+{
+    // Only an active plugin gets a sidechain bus
+    return sidechain.toString() != other.sidechain.toString()
+        || (sidechain.isEnabled() && bypass != other.bypass);
+}
+
+bool Session::Device::operator==(const Device& other) const
+{
+    return type == other.type && inputDevice == other.inputDevice && outputDevice == other.outputDevice
+        && sampleRate == other.sampleRate && bufferSize == other.bufferSize;
+}
+
+//==============================================================================
+bool Session::load(const juce::File& file, const juce::KnownPluginList& knownPlugins, Session& session, juce::StringArray& errors)
+{
+    const int numErrorsBefore = errors.size();
+    session = Session();
+    session.file = file;
+
+    if (! file.existsAsFile())
+    {
+        errors.add("Cannot find " + file.getFullPathName());
+        return false;
+    }
+
+    juce::var root;
+    const juce::Result parsed = juce::JSON::parse(file.loadFileAsString(), root);
+    if (parsed.failed())
+    {
+        errors.add(file.getFileName() + ": " + parsed.getErrorMessage());
+        return false;
+    }
+
+    if (! root.isObject())
+    {
+        errors.add(file.getFileName() + ": expected an object with \"device\" and \"chain\"");
+        return false;
+    }
+
+    // Device
+    const juce::var device = root.getProperty("device", juce::var());
+    if (device.isObject())
+    {
+        auto readString = [&](const char* name, juce::String& target)
+        {
+            const juce::var value = device.getProperty(name, juce::var());
+            if (value.isString())
+                target = value.toString();
+            else if (! value.isVoid())
+                errors.add(juce::String("device.") + name + " must be a string");
+        };
+
+        readString("type", session.device.type);
+        readString("input", session.device.inputDevice);
+        readString("output", session.device.outputDevice);
+
+        const juce::var sampleRate = device.getProperty("sampleRate", juce::var());
+        if (sampleRate.isDouble() || sampleRate.isInt() || sampleRate.isInt64())
+            session.device.sampleRate = (double) sampleRate;
+        if (! sampleRate.isVoid() && session.device.sampleRate <= 0.0)
+            errors.add("device.sampleRate must be a positive number");
+
+        const juce::var bufferSize = device.getProperty("bufferSize", juce::var());
+        if (bufferSize.isInt() || bufferSize.isInt64())
+            session.device.bufferSize = (int) bufferSize;
+        if (! bufferSize.isVoid() && session.device.bufferSize <= 0)
+            errors.add("device.bufferSize must be a positive whole number");
+    }
+    else if (! device.isVoid())
+    {
+        errors.add("\"device\" must be an object");
+    }
+
+    // Chain
+    const juce::var chain = root.getProperty("chain", juce::var());
+    if (! chain.isArray())
+    {
+        errors.add("\"chain\" must be a list of plugins");
+        return false;
+    }
+
+    juce::StringArray earlierIdentifiers;
+
+    for (int i = 0; i < chain.size(); i++)
+    {
+        const juce::var entry = chain[i];
+        const juce::String where = describeEntry(i, entry);
+
+        if (! entry.isObject() || ! entry.getProperty("plugin", juce::var()).isString())
+        {
+            errors.add(where + ": needs a \"plugin\" identifier");
+            continue;
+        }
+
+        SessionPlugin plugin;
+        juce::String error;
+        const bool resolved = resolvePlugin(knownPlugins, entry.getProperty("plugin", juce::var()).toString(), plugin.plugin, error);
+        if (! resolved)
+            errors.add(where + ": " + error);
+
+        // Settings are keyed by plugin, so each plugin can only be in the chain once
+        const juce::String identifier = plugin.plugin.createIdentifierString();
+        if (resolved && earlierIdentifiers.contains(identifier))
+            errors.add(where + ": the plugin is already in the chain");
+
+        const juce::var bypass = entry.getProperty("bypass", juce::var());
+        if (bypass.isBool())
+            plugin.bypass = (bool) bypass;
+        else if (! bypass.isVoid())
+            errors.add(where + ": \"bypass\" must be true or false");
+
+        const juce::var state = entry.getProperty("state", juce::var());
+        const juce::var stateFile = entry.getProperty("stateFile", juce::var());
+        if (state.isString())
+        {
+            juce::MemoryBlock decoded;
+            if (decoded.fromBase64Encoding(state.toString()))
+                plugin.state = state.toString();
+            else
+                errors.add(where + ": \"state\" is not base64");
+        }
+        else if (stateFile.isString())
+        {
+            const juce::File stateSource = file.getParentDirectory().getChildFile(stateFile.toString());
+            juce::MemoryBlock data;
+            if (stateSource.loadFileAsData(data))
+                plugin.state = data.toBase64Encoding();
+            else
+                errors.add(where + ": cannot read state file " + stateSource.getFullPathName());
+        }
+        else if (! state.isVoid() || ! stateFile.isVoid())
+        {
+            errors.add(where + ": \"state\" and \"stateFile\" must be strings");
+        }
+
+        const juce::var sidechain = entry.getProperty("sidechain", juce::var());
+        if (sidechain.isString())
+        {
+            plugin.sidechain = SidechainSource::fromString(sidechain.toString());
+            if (! plugin.sidechain.isEnabled())
+                errors.add(where + ": \"sidechain\" must be \"input:N\" or \"plugin:<identifier>\"");
+            else if (plugin.sidechain.pluginIdentifier.isNotEmpty() && ! earlierIdentifiers.contains(plugin.sidechain.pluginIdentifier))
+                errors.add(where + ": the sidechain plugin has to come earlier in the chain");
+        }
+        else if (! sidechain.isVoid())
+        {
+            errors.add(where + ": \"sidechain\" must be a string");
+        }
+
+        const juce::var rateDivisor = entry.getProperty("rateDivisor", juce::var());
+        const bool validDivisor = (rateDivisor.isInt() || rateDivisor.isInt64())
+                               && (int) rateDivisor >= 1 && (int) rateDivisor <= SampleRateBridge::maxFactor;
+        if (validDivisor)
+            plugin.rateDivisor = (int) rateDivisor;
+        else if (! rateDivisor.isVoid())
+            errors.add(where + ": \"rateDivisor\" must be a whole number from 1 to " + juce::String(SampleRateBridge::maxFactor));
+
+        const juce::var parameters = entry.getProperty("parameters", juce::var());
+        if (auto* object = parameters.getDynamicObject())
+        {
+            for (const auto& property : object->getProperties())
+            {
+                const juce::var& value = property.value;
+                const double normalised = value.isDouble() || value.isInt() || value.isInt64() ? (double) value : -1.0;
+
+                if (normalised < 0.0 || normalised > 1.0)
+                    errors.add(where + ": parameter \"" + property.name.toString() + "\" needs a value from 0 to 1");
+                else
+                    plugin.parameters.push_back({ property.name.toString(), (float) normalised });
+            }
+        }
+        else if (! parameters.isVoid())
+        {
+            errors.add(where + ": \"parameters\" must map names or indices to values");
+        }
+
+        if (resolved)
+            earlierIdentifiers.add(identifier);
+        session.plugins.push_back(std::move(plugin));
+    }
+
+    return errors.size() == numErrorsBefore;
+}
+
+Session::Difference Session::compare(const Session& running, const Session& next)
+{
+    Difference difference;
+    difference.device = next.device.isSpecified() && ! (running.device == next.device);
+    difference.chain = running.plugins.size() != next.plugins.size();
+
+    for (size_t i = 0; i < next.plugins.size() && ! difference.chain; i++)
+        difference.chain = next.plugins[i].changesWiringFrom(running.plugins[i]);
+
+    // Plugins are matched wherever they moved to, so a reordered chain keeps its instances
+    for (size_t i = 0; i < next.plugins.size(); i++)
+    {
+        const SessionPlugin& plugin = next.plugins[i];
+        auto previous = std::find_if(running.plugins.begin(), running.plugins.end(),
+                                     [&plugin](const SessionPlugin& p) { return p.plugin.isDuplicateOf(plugin.plugin); });
+        if (previous == running.plugins.end())
+            continue;
+
+        if (plugin.needsReloadFrom(*previous))
+        {
+            difference.reloaded.push_back(i);
+            difference.chain = true;
+            continue;
+        }
+
+        // An empty state keeps whatever the plugin has
+        if (plugin.state.isNotEmpty() && plugin.state != previous->state)
+            difference.stateChanged.push_back(i);
+        if (plugin.bypass != previous->bypass)
+            difference.bypassChanged.push_back(i);
+        if (plugin.parameters != previous->parameters)
+            difference.parametersChanged.push_back(i);
+    }
+
+    return difference;
+}
+
+juce::StringArray Session::applyParameters(const SessionPlugin& plugin, juce::AudioPluginInstance& instance)
+{
+    juce::StringArray unmatched;
+    const auto& parameters = instance.getParameters();
+
+    for (const auto& [name, value] : plugin.parameters)
+    {
+        juce::AudioProcessorParameter* parameter = nullptr;
+
+        if (name.containsOnly("0123456789"))
+            parameter = parameters[name.getIntValue()];
+
+        for (int i = 0; i < parameters.size() && parameter == nullptr; i++)
+            if (parameters[i]->getName(256).equalsIgnoreCase(name))
+                parameter = parameters[i];
+
+        if (parameter != nullptr)
+            parameter->setValueNotifyingHost(value);
+        else
+            unmatched.add(name);
+    }
+
+    return unmatched;
+}
+
+//==============================================================================
+void SessionFileWatcher::watch(const juce::File& fileToWatch)
+{
+    file = fileToWatch;
+    lastModified = file.getLastModificationTime();
+    startTimer(pollIntervalMs);
+}
+
+void SessionFileWatcher::timerCallback()
+{
+    const juce::Time modified = file.getLastModificationTime();
+    if (modified == lastModified || ! file.existsAsFile())
+        return;
+
+    lastModified = modified;
+    if (onChanged != nullptr)
+        onChanged();
+}
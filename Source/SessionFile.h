@@ -0,0 +1,118 @@
+//
+// SessionFile.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "ChainBuilder.h"
+#include <functional>
+#include <vector>
+
+/**
+ * One plugin of a session, resolved against the known plugin list
+ */
+struct SessionPlugin
+{
+    juce::PluginDescription plugin;
+    bool bypass = false;
+    juce::String state;             // base64, from "state" or read from "stateFile"; empty keeps the plugin's saved state
+    SidechainSource sidechain;
+    int rateDivisor = 1;            // "rateDivisor": runs the plugin at the device rate divided by 2 to 4
+    std::vector<std::pair<juce::String, float>> parameters;    // parameter name or index, normalised value
+
+    /** Whether the chain has to be wired again to go from one to the other in the same place */
+    bool changesWiringFrom(const SessionPlugin& other) const;
+
+    /** Whether the same plugin has to be created again, because its sidechain bus changes */
+    bool needsReloadFrom(const SessionPlugin& other) const;
+};
+
+/**
+ * A chain and its audio device, as described by a hand-written JSON file
+ *
+ *     {
+ *         "device": { "type": "ALSA", "output": "...", "input": "...", "sampleRate": 48000, "bufferSize": 256 },
+ *         "chain": [
+ *             { "plugin": "VST3-Comp-1a2b3c4d-5e6f7a8b", "bypass": false, "sidechain": "input:2", "rateDivisor": 2,
+ *               "stateFile": "comp.state", "parameters": { "Threshold": 0.4, "3": 0.75 } }
+ *         ]
+ *     }
+ *
+ * A plugin is named by its identifier string, or by its name when only one known plugin has it.
+ * Parameters are normalised values, addressed by name or by index. State files are raw plugin
+ * state, relative to the session file.
+ */
+struct Session
+{
+    struct Device
+    {
+        juce::String type, inputDevice, outputDevice;
+        double sampleRate = 0.0;
+        int bufferSize = 0;
+
+        bool isSpecified() const noexcept   { return type.isNotEmpty() || inputDevice.isNotEmpty() || outputDevice.isNotEmpty()
+                                                     || sampleRate > 0.0 || bufferSize > 0; }
+        bool operator==(const Device& other) const;
+    };
+
+    /**
+     * What it takes to go from one session to the next
+     * The lists hold indices into the next session's plugins, for plugins both sessions have
+     */
+    struct Difference
+    {
+        bool device = false;
+        bool chain = false;                         // plugins, order, sidechains or rates changed
+        std::vector<size_t> reloaded;               // have to be created again; the chain changed too
+        std::vector<size_t> stateChanged;           // take their new state in place
+        std::vector<size_t> bypassChanged;
+        std::vector<size_t> parametersChanged;
+
+        bool isEmpty() const noexcept   { return ! device && ! chain && stateChanged.empty() && bypassChanged.empty()
+                                                 && parametersChanged.empty(); }
+    };
+
+    juce::File file;
+    Device device;
+    std::vector<SessionPlugin> plugins;
+
+    /**
+     * Reads and checks the whole file before anything is applied
+     * Every problem is added to errors, so all missing plugins are reported at once;
+     * the session is only usable when the result is true
+     */
+    static bool load(const juce::File& file, const juce::KnownPluginList& knownPlugins, Session& session, juce::StringArray& errors);
+
+    static Difference compare(const Session& running, const Session& next);
+
+    /** Sets the plugin's listed parameters; returns the names that matched nothing */
+    static juce::StringArray applyParameters(const SessionPlugin& plugin, juce::AudioPluginInstance& instance);
+};
+
+//==============================================================================
+/**
+ * Polls a session file and reports when it was saved again
+ */
+class SessionFileWatcher : private juce::Timer
+{
+public:
+    SessionFileWatcher() = default;
+    ~SessionFileWatcher() override      { stopTimer(); }
+
+    void watch(const juce::File& fileToWatch);
+
+    /** Called on the message thread once the file has been written */
+    std::function<void()> onChanged;
+
+private:
+    void timerCallback() override;
+
+    juce::File file;
+    juce::Time lastModified;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SessionFileWatcher)
+};
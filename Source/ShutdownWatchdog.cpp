@@ -0,0 +1,151 @@
+//
+// ShutdownWatchdog.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "ShutdownWatchdog.h"
+#include "LinearChainProcessor.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+ShutdownWatchdog::ShutdownWatchdog(double deadlineSeconds)
+    : juce::Thread("Shutdown Watchdog"),
+      deadline(juce::Time::getMillisecondCounter() + (juce::uint32) juce::roundToInt(juce::jmax(0.5, deadlineSeconds) * 1000.0))
+{
+    startThread();
+}
+
+ShutdownWatchdog::~ShutdownWatchdog()
+{
+    signalThreadShouldExit();
+    notify();
+    stopThread(1000);
+}
+
+double ShutdownWatchdog::getSecondsLeft() const noexcept
+{
+    const juce::uint32 now = juce::Time::getMillisecondCounter();
+    return now < deadline ? (deadline - now) / 1000.0 : 0.0;
+}
+
+void ShutdownWatchdog::exitNow(const juce::String& reason, int exitCode)
+{
+    juce::Logger::writeToLog(reason);
+    std::cerr << reason << std::endl;
+    std::_Exit(exitCode);
+}
+
+void ShutdownWatchdog::run()
+{
+    while (! threadShouldExit())
+    {
+        const int millisecondsLeft = juce::roundToInt(getSecondsLeft() * 1000.0);
+        if (millisecondsLeft <= 0)
+            exitNow("Shutdown did not finish in time, exiting now");
+
+        wait(millisecondsLeft);
+    }
+}
+
+//==============================================================================
+PluginStateCapture::Result PluginStateCapture::captureAll(juce::AudioProcessorGraph& graph, double timeoutSeconds)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    // Shared with the capture threads, which may outlive this call if a plugin hangs
+    struct Capture
+    {
+        std::vector<juce::AudioPluginInstance*> instances;
+        std::vector<juce::MemoryBlock> states;
+        std::unique_ptr<std::atomic<bool>[]> finished;
+        std::atomic<int> numRemaining { 0 };
+        juce::WaitableEvent allFinished;
+
+        void captureOne(size_t i)
+        {
+            // A plugin that throws keeps the state it was last saved with
+            try
+            {
+                instances[i]->getStateInformation(states[i]);
+            }
+            catch (...)
+            {
+                states[i].reset();
+            }
+
+            finished[i].store(true);
+        }
+    };
+
+    const juce::uint32 deadline = juce::Time::getMillisecondCounter()
+                                + (juce::uint32) juce::roundToInt(juce::jmax(0.0, timeoutSeconds) * 1000.0);
+
+    auto capture = std::make_shared<Capture>();
+    for (auto node : graph.getNodes())
+        if (auto instance = dynamic_cast<juce::AudioPluginInstance*>(node->getProcessor()))
+            capture->instances.push_back(instance);
+
+    const size_t numInstances = capture->instances.size();
+    capture->states.resize(numInstances);
+    capture->finished.reset(new std::atomic<bool>[numInstances]);
+
+    std::vector<size_t> onMessageThread;
+    std::vector<size_t> onOwnThread;
+    for (size_t i = 0; i < numInstances; i++)
+    {
+        capture->finished[i].store(false);
+
+        if (LinearChainProcessor::canPrepareConcurrently(capture->instances[i]))
+            onOwnThread.push_back(i);
+        else
+            onMessageThread.push_back(i);
+    }
+
+    capture->numRemaining.store((int) onOwnThread.size());
+
+    for (const size_t i : onOwnThread)
+    {
+        juce::Thread::launch([capture, i]
+        {
+            capture->captureOne(i);
+
+            if (capture->numRemaining.fetch_sub(1) == 1)
+                capture->allFinished.signal();
+        });
+    }
+
+    // Only started when there is time left, so a plugin skipped here is not running and can be deleted
+    for (const size_t i : onMessageThread)
+        if (juce::Time::getMillisecondCounter() < deadline)
+            capture->captureOne(i);
+
+    if (! onOwnThread.empty())
+    {
+        const juce::uint32 now = juce::Time::getMillisecondCounter();
+        capture->allFinished.wait(now < deadline ? (int) (deadline - now) : 0);
+    }
+
+    Result result;
+    for (size_t i = 0; i < numInstances; i++)
+    {
+        const juce::PluginDescription plugin = capture->instances[i]->getPluginDescription();
+        const bool threaded = std::find(onOwnThread.begin(), onOwnThread.end(), i) != onOwnThread.end();
+
+        if (! capture->finished[i].load())
+        {
+            if (threaded)
+                result.unfinished.add(plugin.name);
+        }
+        else if (capture->states[i].getSize() > 0)
+        {
+            result.states.push_back({ plugin, capture->states[i].toBase64Encoding() });
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,58 @@
+//
+// ShutdownWatchdog.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <vector>
+
+/**
+ * Ends the process if shutting down takes longer than the deadline
+ *
+ * Armed for as long as it exists. Everything worth keeping has to be on disk before the
+ * slow part of the shutdown starts, since a plugin that hangs while it is deleted only
+ * gets as far as the deadline.
+ */
+class ShutdownWatchdog : private juce::Thread
+{
+public:
+    explicit ShutdownWatchdog(double deadlineSeconds);
+    ~ShutdownWatchdog() override;
+
+    double getSecondsLeft() const noexcept;
+
+    /** Logs the reason and leaves at once with the exit code, skipping every destructor */
+    [[noreturn]] static void exitNow(const juce::String& reason, int exitCode = 1);
+
+private:
+    void run() override;
+
+    const juce::uint32 deadline;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ShutdownWatchdog)
+};
+
+//==============================================================================
+/**
+ * Reads the state of every plugin in a graph
+ *
+ * Plugins that may be called off the message thread each get a thread and run at the same
+ * time. The rest, VST3 among them, are read one after another on the message thread while
+ * those threads work, until the timeout; any left after it keep the state they were last
+ * saved with. A plugin that hangs on the message thread is left to the watchdog.
+ */
+struct PluginStateCapture
+{
+    struct Result
+    {
+        std::vector<std::pair<juce::PluginDescription, juce::String>> states;   // plugin and base64 state
+        juce::StringArray unfinished;   // threaded plugins still busy at the timeout; they must not be deleted
+    };
+
+    /** Message thread only */
+    static Result captureAll(juce::AudioProcessorGraph& graph, double timeoutSeconds);
+};
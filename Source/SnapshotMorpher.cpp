@@ -0,0 +1,226 @@
+//
+// SnapshotMorpher.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "SnapshotMorpher.h"
+#include <cmath>
+
+namespace
+{
+    // Well below what a parameter can resolve, so a settled value is never sent again
+    const float sendThreshold = 1.0e-5f;
+}
+
+//==============================================================================
+const ParameterSnapshot::PluginValues* ParameterSnapshot::find(const juce::String& pluginIdentifier) const noexcept
+{
+    for (const auto& plugin : plugins)
+        if (plugin.pluginIdentifier == pluginIdentifier)
+            return &plugin;
+    return nullptr;
+}
+
+ParameterSnapshot ParameterSnapshot::capture(juce::AudioProcessorGraph& graph, const juce::String& pluginIdentifier)
+{
+    ParameterSnapshot snapshot;
+
+    for (auto node : graph.getNodes())
+    {
+        auto instance = dynamic_cast<juce::AudioPluginInstance*>(node->getProcessor());
+        if (instance == nullptr)
+            continue;
+
+        PluginValues plugin;
+        plugin.pluginIdentifier = instance->getPluginDescription().createIdentifierString();
+        if (pluginIdentifier.isNotEmpty() && plugin.pluginIdentifier != pluginIdentifier)
+            continue;
+
+        const auto& parameters = instance->getParameters();
+        plugin.values.reserve((size_t) parameters.size());
+        for (auto* parameter : parameters)
+            plugin.values.push_back(parameter->getValue());
+
+        snapshot.plugins.push_back(std::move(plugin));
+    }
+
+    return snapshot;
+}
+
+//==============================================================================
+SnapshotMorpher::SnapshotMorpher(juce::AudioProcessorGraph& graphToUse)
+    : graph(graphToUse)
+{
+}
+
+SnapshotMorpher::~SnapshotMorpher()
+{
+}
+
+void SnapshotMorpher::storeSlot(int slot)
+{
+    if (juce::isPositiveAndBelow(slot, numSlots))
+        slots[(size_t) slot] = ParameterSnapshot::capture(graph);
+}
+
+int SnapshotMorpher::morphToSlot(int slot, double seconds, const juce::String& pluginIdentifier)
+{
+    if (! juce::isPositiveAndBelow(slot, numSlots))
+        return 0;
+
+    // Stop first, so the starting point is where a running morph actually got to
+    stop();
+    return morph(ParameterSnapshot::capture(graph, pluginIdentifier), slots[(size_t) slot], seconds);
+}
+
+int SnapshotMorpher::morph(const ParameterSnapshot& from, const ParameterSnapshot& to, double seconds)
+{
+    auto newMorph = std::make_unique<Morph>();
+    newMorph->seconds = juce::jmax(0.0, seconds);
+
+    std::vector<float> starts, differences;
+
+    for (auto node : graph.getNodes())
+    {
+        auto instance = dynamic_cast<juce::AudioPluginInstance*>(node->getProcessor());
+        if (instance == nullptr)
+            continue;
+
+        const juce::String identifier = instance->getPluginDescription().createIdentifierString();
+        const auto* fromValues = from.find(identifier);
+        const auto* toValues = to.find(identifier);
+        if (fromValues == nullptr || toValues == nullptr)
+            continue;
+
+        const auto& parameters = instance->getParameters();
+        const int numValues = juce::jmin(parameters.size(), (int) fromValues->values.size(), (int) toValues->values.size());
+
+        // Only what differs is part of the morph
+        for (int i = 0; i < numValues; i++)
+        {
+            const float difference = toValues->values[(size_t) i] - fromValues->values[(size_t) i];
+            if (std::abs(difference) <= sendThreshold)
+                continue;
+
+            newMorph->parameters.push_back(parameters[i]);
+            starts.push_back(fromValues->values[(size_t) i]);
+            differences.push_back(difference);
+        }
+    }
+
+    const int numParameters = (int) newMorph->parameters.size();
+    newMorph->numParameters = numParameters;
+    newMorph->start.malloc((size_t) juce::jmax(1, numParameters));
+    newMorph->difference.malloc((size_t) juce::jmax(1, numParameters));
+    newMorph->values.malloc((size_t) juce::jmax(1, numParameters));
+    newMorph->lastSent.malloc((size_t) juce::jmax(1, numParameters));
+
+    if (numParameters > 0)
+    {
+        juce::FloatVectorOperations::copy(newMorph->start, starts.data(), numParameters);
+        juce::FloatVectorOperations::copy(newMorph->difference, differences.data(), numParameters);
+        juce::FloatVectorOperations::copy(newMorph->lastSent, starts.data(), numParameters);
+    }
+
+    // Only once no block can still be finishing the previous morph
+    currentMorph.swap(std::move(newMorph));
+    morphing.store(numParameters > 0);
+    return numParameters;
+}
+
+void SnapshotMorpher::stop()
+{
+    morphing.store(false);
+    currentMorph.swap(nullptr);
+}
+
+//==============================================================================
+std::unique_ptr<juce::XmlElement> SnapshotMorpher::createXml() const
+{
+    auto xml = std::make_unique<juce::XmlElement>("SNAPSHOTS");
+
+    for (int slot = 0; slot < numSlots; slot++)
+    {
+        if (slots[(size_t) slot].isEmpty())
+            continue;
+
+        auto* slotXml = xml->createNewChildElement("SLOT");
+        slotXml->setAttribute("index", slot);
+
+        // Raw floats keep thousands of parameters down to a few kilobytes
+        for (const auto& plugin : slots[(size_t) slot].plugins)
+        {
+            auto* pluginXml = slotXml->createNewChildElement("PLUGIN");
+            pluginXml->setAttribute("id", plugin.pluginIdentifier);
+            pluginXml->setAttribute("values", juce::MemoryBlock(plugin.values.data(), plugin.values.size() * sizeof(float)).toBase64Encoding());
+        }
+    }
+
+    return xml;
+}
+
+void SnapshotMorpher::restoreFromXml(const juce::XmlElement& xml)
+{
+    for (auto& slot : slots)
+        slot.plugins.clear();
+
+    for (auto* slotXml : xml.getChildWithTagNameIterator("SLOT"))
+    {
+        const int slot = slotXml->getIntAttribute("index", -1);
+        if (! juce::isPositiveAndBelow(slot, numSlots))
+            continue;
+
+        for (auto* pluginXml : slotXml->getChildWithTagNameIterator("PLUGIN"))
+        {
+            juce::MemoryBlock data;
+            if (! data.fromBase64Encoding(pluginXml->getStringAttribute("values")))
+                continue;
+
+            ParameterSnapshot::PluginValues plugin;
+            plugin.pluginIdentifier = pluginXml->getStringAttribute("id");
+            plugin.values.resize(data.getSize() / sizeof(float));
+            data.copyTo(plugin.values.data(), 0, plugin.values.size() * sizeof(float));
+            slots[(size_t) slot].plugins.push_back(std::move(plugin));
+        }
+    }
+}
+
+//==============================================================================
+void SnapshotMorpher::tapAboutToStart(double newSampleRate, int, int)
+{
+    sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+}
+
+void SnapshotMorpher::tapInput(const float* const*, int, int numSamples) noexcept
+{
+    if (! morphing.load(std::memory_order_relaxed))
+        return;
+
+    const RcuPointer<Morph>::ScopedReader reader(currentMorph);
+    Morph* current = reader.get();
+
+    if (current != nullptr && current->numParameters > 0)
+    {
+        current->elapsed += numSamples / sampleRate;
+        const float position = current->seconds > 0.0 ? (float) juce::jmin(1.0, current->elapsed / current->seconds) : 1.0f;
+        const int numParameters = current->numParameters;
+
+        // values = start + difference * position for every parameter in one pass
+        juce::FloatVectorOperations::copy(current->values, current->start, numParameters);
+        juce::FloatVectorOperations::addWithMultiply(current->values.get(), current->difference, position, numParameters);
+
+        for (int i = 0; i < numParameters; i++)
+        {
+            if (std::abs(current->values[i] - current->lastSent[i]) > sendThreshold)
+            {
+                current->parameters[(size_t) i]->setValue(current->values[i]);
+                current->lastSent[i] = current->values[i];
+            }
+        }
+
+        if (position >= 1.0f)
+            morphing.store(false);
+    }
+}
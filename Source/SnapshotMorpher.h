@@ -0,0 +1,100 @@
+//
+// SnapshotMorpher.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "HostAudioCallback.h"
+#include "RcuPointer.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/** Every parameter value of some plugins, as plain normalised floats */
+struct ParameterSnapshot
+{
+    struct PluginValues
+    {
+        juce::String pluginIdentifier;
+        std::vector<float> values;
+    };
+
+    std::vector<PluginValues> plugins;
+
+    bool isEmpty() const noexcept   { return plugins.empty(); }
+    const PluginValues* find(const juce::String& pluginIdentifier) const noexcept;
+
+    /** Reads the parameters of the graph's plugins; an empty identifier takes them all */
+    static ParameterSnapshot capture(juce::AudioProcessorGraph& graph, const juce::String& pluginIdentifier = {});
+};
+
+//==============================================================================
+/**
+ * Stores parameter snapshots in a few slots and glides plugins from their current state to one of them
+ *
+ * Starting a morph compiles the parameters that differ between the two snapshots into flat
+ * start and difference arrays. Every block the audio thread computes all values at once as
+ * start + difference * position with the vector operations and sends only the ones that moved,
+ * so parameters that stay put cost nothing. The morph is swapped in the way the controller
+ * mappings are, and replaces any morph still running.
+ */
+class SnapshotMorpher : public HostAudioTap
+{
+public:
+    static constexpr int numSlots = 8;
+
+    explicit SnapshotMorpher(juce::AudioProcessorGraph& graph);
+    ~SnapshotMorpher() override;
+
+    //==============================================================================
+    /** Message thread only */
+    void storeSlot(int slot);
+    const ParameterSnapshot& getSlot(int slot) const noexcept       { return slots[(size_t) slot]; }
+
+    /**
+     * Morphs from the current parameter values to a slot; an empty identifier morphs the whole chain
+     * @returns the number of parameters that will move
+     */
+    int morphToSlot(int slot, double seconds, const juce::String& pluginIdentifier = {});
+
+    /** Morphs between any two snapshots; plugins or parameters missing from either are left alone */
+    int morph(const ParameterSnapshot& from, const ParameterSnapshot& to, double seconds);
+
+    /** Stops the running morph where it is; call before the graph's plugins are deleted */
+    void stop();
+
+    bool isMorphing() const noexcept                                 { return morphing.load(); }
+
+    std::unique_ptr<juce::XmlElement> createXml() const;
+    void restoreFromXml(const juce::XmlElement& xml);
+
+    //==============================================================================
+    void tapAboutToStart(double sampleRate, int numInputChannels, int numOutputChannels) override;
+    void tapInput(const float* const* data, int numChannels, int numSamples) noexcept override;
+    void tapOutput(const float* const*, int, int) noexcept override {}
+
+private:
+    struct Morph
+    {
+        std::vector<juce::AudioProcessorParameter*> parameters;
+        juce::HeapBlock<float> start, difference, values, lastSent;
+        int numParameters = 0;
+        double seconds = 0.0;
+        double elapsed = 0.0;   // audio thread only
+    };
+
+    juce::AudioProcessorGraph& graph;
+    std::array<ParameterSnapshot, numSlots> slots;
+
+    RcuPointer<Morph> currentMorph;
+    std::atomic<bool> morphing { false };
+
+    double sampleRate = 44100.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SnapshotMorpher)
+};
@@ -0,0 +1,484 @@
+//
+// StressHarness.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "StressHarness.h"
+#include "PluginWindow.h"
+#include "VirtualAudioDevice.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    const double defaultMinutes = 10.0;
+    const double stressSampleRate = 48000.0;
+    const int stressBlockSize = 256;
+    const int editIntervalMs = 5;
+    const int maxChainLength = 8;
+    const int rescanIntervalMs = 2000;
+
+    // Failure bounds
+    const double maxLateBlockFraction = 0.001;
+    const juce::int64 maxRssGrowthKb = 64 * 1024;
+    const double stallSeconds = 30.0;
+
+    // Memory is compared against this point, once plugin code and caches have settled
+    const double rssBaselineSeconds = 30.0;
+
+    // Reference plugins that are safe to load over and over in-process. The slow loader would
+    // turn every rebuild into a five second wait, the bad-numbers plugin is a glitch by design
+    const char* const stressPluginNames[] = { "NovaTestUnity", "NovaTestFixedLatency", "NovaTestLatencyChange" };
+
+    const char* const editKindNames[] = { "add", "remove", "move", "bypass", "open editor", "close editor" };
+
+    juce::int64 readResidentKb()
+    {
+        const juce::StringArray lines = juce::StringArray::fromLines(juce::File("/proc/self/status").loadFileAsString());
+
+        for (const auto& line : lines)
+            if (line.startsWith("VmRSS:"))
+                return line.fromFirstOccurrenceOf(":", false, false).getLargeIntValue();
+
+        return -1;
+    }
+
+    double elapsedMillis(juce::int64 startTicks, juce::int64 endTicks)
+    {
+        return juce::Time::highResolutionTicksToSeconds(endTicks - startTicks) * 1000.0;
+    }
+}
+
+//==============================================================================
+/** Rescans the stress plugins again and again, the way a user might while editing */
+class StressHarness::ScanThread : public juce::Thread
+{
+public:
+    explicit ScanThread(SafePluginScanner& scannerToRun)
+        : juce::Thread("Stress scanner"), scanner(scannerToRun)
+    {
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            scanner.run();
+            numScans++;
+            wait(rescanIntervalMs);
+        }
+    }
+
+    std::atomic<int> numScans { 0 };
+
+private:
+    SafePluginScanner& scanner;
+};
+
+//==============================================================================
+/** Aborts the run if the message thread or the audio thread stops making progress */
+class StressHarness::Watchdog : public juce::Thread
+{
+public:
+    explicit Watchdog(StressHarness& harnessToWatch)
+        : juce::Thread("Stress watchdog"), harness(harnessToWatch)
+    {
+    }
+
+    void run() override
+    {
+        juce::int64 lastBlocks = -1;
+        juce::int64 lastBlockChangeTicks = juce::Time::getHighResolutionTicks();
+
+        while (! wait(1000))
+        {
+            const juce::int64 now = juce::Time::getHighResolutionTicks();
+            const juce::int64 blocks = harness.numBlocks.load();
+
+            if (blocks != lastBlocks)
+            {
+                lastBlocks = blocks;
+                lastBlockChangeTicks = now;
+            }
+
+            const char* stalled = nullptr;
+            if (juce::Time::highResolutionTicksToSeconds(now - harness.messageHeartbeat.load()) > stallSeconds)
+                stalled = "message";
+            else if (juce::Time::highResolutionTicksToSeconds(now - lastBlockChangeTicks) > stallSeconds)
+                stalled = "audio";
+
+            if (stalled != nullptr)
+            {
+                // A deadlock will not resolve itself; dying loudly leaves a core or sanitizer report behind
+                std::cerr << "STRESS FAIL: the " << stalled << " thread made no progress for "
+                          << stallSeconds << " s" << std::endl;
+                std::abort();
+            }
+        }
+    }
+
+private:
+    StressHarness& harness;
+};
+
+//==============================================================================
+StressHarness::StressHarness(const juce::File& directory, double minutesToRun)
+    : testPluginDirectory(directory),
+      secondsToRun((minutesToRun > 0.0 ? minutesToRun : defaultMinutes) * 60.0),
+      hostCallback(player)
+{
+    formatManager.addDefaultFormats();
+    hostCallback.addTap(this);
+}
+
+StressHarness::~StressHarness()
+{
+    stopTimer();
+
+    if (watchdog != nullptr)
+        watchdog->stopThread(2000);
+
+    if (scanThread != nullptr)
+    {
+        scanner->signalThreadShouldExit();
+        scanThread->signalThreadShouldExit();
+        scanThread->stopThread(30000);
+    }
+
+    PluginWindow::closeAllCurrentlyOpenWindows();
+    deviceManager.removeAudioCallback(&hostCallback);
+    deviceManager.closeAudioDevice();
+    player.setProcessor(nullptr);
+    linearChain.clearStages();
+    graph.clear();
+}
+
+bool StressHarness::start()
+{
+    // Resolve the plugins up front so the first edits do not wait for the background scan
+    juce::FileSearchPath bundles;
+
+    for (const auto* name : stressPluginNames)
+    {
+        const juce::File bundle = testPluginDirectory.getChildFile(juce::String(name) + "/" + name + ".vst3");
+        juce::OwnedArray<juce::PluginDescription> types;
+
+        for (auto* format : formatManager.getFormats())
+            if (format->fileMightContainThisPluginType(bundle.getFullPathName()))
+                format->findAllTypesForFile(types, bundle.getFullPathName());
+
+        if (types.isEmpty())
+        {
+            std::cout << "Test plugin " << bundle.getFullPathName() << " not found, skipped" << std::endl;
+            continue;
+        }
+
+        testPlugins.add(*types.getFirst());
+        bundles.add(bundle);
+    }
+
+    if (testPlugins.isEmpty())
+    {
+        std::cerr << "No test plugins found in " << testPluginDirectory.getFullPathName()
+                  << " - build them with Utilities/build_test_plugins.sh" << std::endl;
+        return false;
+    }
+
+    deviceManager.getAvailableDeviceTypes();
+    deviceManager.addAudioDeviceType(std::make_unique<VirtualAudioIODeviceType>());
+    deviceManager.setCurrentAudioDeviceType(VirtualAudioIODeviceType::typeName, false);
+
+    juce::AudioDeviceManager::AudioDeviceSetup setup;
+    setup.outputDeviceName = VirtualAudioIODeviceType::freewheelDeviceName;
+    setup.inputDeviceName = VirtualAudioIODeviceType::freewheelDeviceName;
+    setup.sampleRate = stressSampleRate;
+    setup.bufferSize = stressBlockSize;
+
+    const juce::String error = deviceManager.initialise(2, 2, nullptr, false, {}, &setup);
+    if (error.isNotEmpty())
+    {
+        std::cerr << "Cannot open the virtual device: " << error << std::endl;
+        return false;
+    }
+
+    // Editors need somewhere to go; on a headless machine only the audio edits run
+    editorsEnabled = ! juce::Desktop::getInstance().getDisplays().displays.isEmpty();
+
+    scanner = std::make_unique<SafePluginScanner>(formatManager, scannedPlugins, "VST3");
+    scanner->setHeadless(true);
+    scanner->setSearchPath(bundles);
+
+    rebuildChain();
+    deviceManager.addAudioCallback(&hostCallback);
+
+    startTicks = juce::Time::getHighResolutionTicks();
+    messageHeartbeat.store(startTicks);
+
+    scanThread = std::make_unique<ScanThread>(*scanner);
+    scanThread->startThread();
+    watchdog = std::make_unique<Watchdog>(*this);
+    watchdog->startThread();
+
+    std::cout << "Stress testing " << testPlugins.size() << " test plugins for " << secondsToRun / 60.0
+              << " minutes" << (editorsEnabled ? "" : " (no display, editors skipped)") << std::endl;
+
+    startTimer(editIntervalMs);
+    return true;
+}
+
+//==============================================================================
+void StressHarness::timerCallback()
+{
+    messageHeartbeat.store(juce::Time::getHighResolutionTicks());
+
+    // Closing windows pumps the message loop, which can land us back here mid-edit
+    if (isEditing || finished)
+        return;
+
+    const double elapsedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+    if (baselineRssKb < 0 && elapsedSeconds > rssBaselineSeconds)
+        baselineRssKb = readResidentKb();
+
+    if (elapsedSeconds > secondsToRun)
+    {
+        finish();
+        return;
+    }
+
+    // One audible edit at a time, so each latency is measured from a quiet start
+    if (audibleEdit.load() != publishedEdit.load())
+        return;
+
+    collectAudibleEdit();
+
+    isEditing = true;
+    makeRandomEdit();
+    isEditing = false;
+}
+
+void StressHarness::makeRandomEdit()
+{
+    const juce::int64 editStart = juce::Time::getHighResolutionTicks();
+    const int numKinds = editorsEnabled ? (int) numEditKinds : (int) numAudibleEditKinds;
+    EditKind kind = (EditKind) random.nextInt(numKinds);
+
+    // Keep the chain between empty and maxChainLength without biasing the other edits
+    if (entries.empty() && kind != openEditor && kind != closeEditor)
+        kind = addPlugin;
+    else if (kind == addPlugin && (int) entries.size() >= maxChainLength)
+        kind = removePlugin;
+
+    switch (kind)
+    {
+        case addPlugin:
+        {
+            // Prefer what the background scan found, so its list is read while it is being written
+            const juce::Array<juce::PluginDescription> scanned = scannedPlugins.getTypes();
+            const juce::Array<juce::PluginDescription>& candidates = scanned.isEmpty() ? testPlugins : scanned;
+
+            ChainEntry entry;
+            entry.plugin = candidates[random.nextInt(candidates.size())];
+            entries.insert(entries.begin() + random.nextInt((int) entries.size() + 1), entry);
+            rebuildChain();
+            break;
+        }
+
+        case removePlugin:
+            entries.erase(entries.begin() + random.nextInt((int) entries.size()));
+            rebuildChain();
+            break;
+
+        case movePlugin:
+        {
+            const int from = random.nextInt((int) entries.size());
+            const int to = random.nextInt((int) entries.size());
+            std::swap(entries[(size_t) from], entries[(size_t) to]);
+            rebuildChain();
+            break;
+        }
+
+        case bypassPlugin:
+        {
+            const int index = random.nextInt((int) entries.size());
+            entries[(size_t) index].bypass = ! entries[(size_t) index].bypass;
+
+            // Same shortcut as the tray menu: flip the stage in place when the linear engine is playing
+            // and every entry made it into the chain, otherwise rebuild
+            if (player.getCurrentProcessor() == &linearChain && linearChain.getNumStages() == (int) entries.size())
+                linearChain.setStageBypassed(index, entries[(size_t) index].bypass);
+            else
+                rebuildChain();
+            break;
+        }
+
+        case openEditor:
+            if (auto* node = getRandomPluginNode())
+                if (auto* window = PluginWindow::getWindowFor(node, PluginWindow::Normal))
+                    window->toFront(false);
+            break;
+
+        case closeEditor:
+            if (auto* node = getRandomPluginNode())
+                PluginWindow::closeCurrentlyOpenWindowsFor(node->nodeID.uid);
+            break;
+
+        default:
+            break;
+    }
+
+    if (kind < numAudibleEditKinds)
+        publishEdit(kind, editStart);
+    else
+        editMillis[kind].push_back(elapsedMillis(editStart, juce::Time::getHighResolutionTicks()));
+}
+
+void StressHarness::rebuildChain()
+{
+    // The same teardown order as IconMenu::loadActivePlugins
+    PluginWindow::closeAllCurrentlyOpenWindows();
+    player.setProcessor(nullptr);
+
+    ChainBuilder builder(formatManager);
+    const ChainBuilder::Result chain = builder.build(entries, graph, linearChain, stressSampleRate, stressBlockSize);
+    numLoadErrors += chain.errors.size();
+
+    // Alternate engines at random so both see the same abuse
+    const bool useLinearChain = chain.isPureChain && random.nextBool();
+    player.setProcessor(useLinearChain ? static_cast<juce::AudioProcessor*>(&linearChain) : &graph);
+}
+
+juce::AudioProcessorGraph::Node* StressHarness::getRandomPluginNode()
+{
+    juce::Array<juce::AudioProcessorGraph::Node*> pluginNodes;
+
+    for (auto* node : graph.getNodes())
+        if (dynamic_cast<juce::AudioPluginInstance*>(node->getProcessor()) != nullptr)
+            pluginNodes.add(node);
+
+    return pluginNodes.isEmpty() ? nullptr : pluginNodes[random.nextInt(pluginNodes.size())];
+}
+
+void StressHarness::publishEdit(EditKind kind, juce::int64 editStart)
+{
+    pendingKind = kind;
+    pendingStartTicks = editStart;
+
+    // The player has already switched processors, so the next block to start renders this edit
+    publishedEdit.store(publishedEdit.load() + 1);
+}
+
+void StressHarness::collectAudibleEdit()
+{
+    const int edit = audibleEdit.load();
+    if (edit == 0 || edit == collectedEdit)
+        return;
+
+    collectedEdit = edit;
+    editMillis[pendingKind].push_back(elapsedMillis(pendingStartTicks, audibleTicks.load()));
+}
+
+//==============================================================================
+void StressHarness::tapAboutToStart(double sampleRate, int, int)
+{
+    blockDeadlineTicks = juce::Time::secondsToHighResolutionTicks(stressBlockSize / sampleRate);
+}
+
+void StressHarness::tapInput(const float* const*, int, int) noexcept
+{
+    blockStartTicks = juce::Time::getHighResolutionTicks();
+
+    const int edit = publishedEdit.load();
+    if (edit != renderingEdit)
+    {
+        renderingEdit = edit;
+        renderingNewEdit = true;
+    }
+}
+
+void StressHarness::tapOutput(const float* const* data, int numChannels, int numSamples) noexcept
+{
+    const juce::int64 now = juce::Time::getHighResolutionTicks();
+
+    // On a real device this block would have been a dropout
+    if (now - blockStartTicks > blockDeadlineTicks)
+        numLateBlocks++;
+
+    // Min/max comparisons let NaN slip through, so look at every sample
+    bool isFinite = true;
+    for (int ch = 0; ch < numChannels && isFinite; ++ch)
+        for (int i = 0; i < numSamples && isFinite; ++i)
+            isFinite = std::isfinite(data[ch][i]);
+
+    if (! isFinite)
+        numNonFiniteBlocks++;
+
+    if (renderingNewEdit)
+    {
+        renderingNewEdit = false;
+        audibleTicks.store(now);
+        audibleEdit.store(renderingEdit);
+    }
+
+    numBlocks++;
+}
+
+//==============================================================================
+void StressHarness::finish()
+{
+    finished = true;
+    stopTimer();
+    collectAudibleEdit();
+
+    const juce::int64 endRssKb = readResidentKb();
+    const juce::int64 blocks = numBlocks.load();
+    const double lateFraction = blocks > 0 ? (double) numLateBlocks.load() / (double) blocks : 0.0;
+    juce::StringArray failures;
+
+    std::cout << "Edit latency (ms)      count      p50      p90      p99      max" << std::endl;
+
+    for (int kind = 0; kind < numEditKinds; ++kind)
+    {
+        std::vector<double>& millis = editMillis[kind];
+        std::sort(millis.begin(), millis.end());
+
+        auto percentile = [&millis](int p)
+        {
+            return millis.empty() ? 0.0 : millis[std::min(millis.size() - 1, (millis.size() * (size_t) p) / 100)];
+        };
+
+        std::cout << juce::String(editKindNames[kind]).paddedRight(' ', 18)
+                  << juce::String((int) millis.size()).paddedLeft(' ', 10)
+                  << juce::String(percentile(50), 2).paddedLeft(' ', 9)
+                  << juce::String(percentile(90), 2).paddedLeft(' ', 9)
+                  << juce::String(percentile(99), 2).paddedLeft(' ', 9)
+                  << juce::String(millis.empty() ? 0.0 : millis.back(), 2).paddedLeft(' ', 9) << std::endl;
+    }
+
+    std::cout << "Blocks rendered:       " << blocks << std::endl
+              << "Late blocks:           " << numLateBlocks.load() << " (" << juce::String(lateFraction * 100.0, 3) << " %)" << std::endl
+              << "Non-finite blocks:     " << numNonFiniteBlocks.load() << std::endl
+              << "Plugin load errors:    " << numLoadErrors << std::endl
+              << "Background scans:      " << (scanThread != nullptr ? scanThread->numScans.load() : 0) << std::endl
+              << "Resident memory:       " << baselineRssKb << " kB after warm-up, " << endRssKb << " kB at the end" << std::endl;
+
+    if (lateFraction > maxLateBlockFraction)
+        failures.add("too many late blocks");
+
+    if (numNonFiniteBlocks.load() > 0)
+        failures.add("non-finite output");
+
+    if (baselineRssKb >= 0 && endRssKb >= 0 && endRssKb - baselineRssKb > maxRssGrowthKb)
+        failures.add("resident memory grew by " + juce::String((endRssKb - baselineRssKb) / 1024) + " MB");
+
+    for (const auto& failure : failures)
+        std::cout << "STRESS FAIL: " << failure << std::endl;
+
+    std::cout << (failures.isEmpty() ? "Stress test passed" : "Stress test failed") << std::endl;
+
+    if (onFinished != nullptr)
+        onFinished(failures.isEmpty() ? 0 : 1);
+}
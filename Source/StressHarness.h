@@ -0,0 +1,118 @@
+//
+// StressHarness.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "ChainBuilder.h"
+#include "HostAudioCallback.h"
+#include "LinearChainProcessor.h"
+#include "SafePluginScanner.h"
+#include <atomic>
+#include <functional>
+#include <vector>
+
+/**
+ * Edits a live chain at random while the freewheeling virtual device runs it flat out
+ *
+ * The message thread adds, removes, moves and bypasses reference test plugins and opens and
+ * closes their editors through the same ChainBuilder and PluginWindow code the tray host uses,
+ * while a background thread rescans the plugins with SafePluginScanner. The run fails on too
+ * many late or non-finite blocks or on resident memory growth, and aborts if the message or the
+ * audio thread stops making progress. Build with ./build_linux.sh debug tsan (or asan) to run
+ * it under a sanitizer.
+ *
+ * Run with -stress-test[=MINUTES] [-test-plugins=TestPlugins/build]; the report goes to stdout
+ */
+class StressHarness : private juce::Timer,
+                      private HostAudioTap
+{
+public:
+    StressHarness(const juce::File& testPluginDirectory, double minutesToRun);
+    ~StressHarness() override;
+
+    /** Opens the device and starts editing - returns false if there is nothing to test with */
+    bool start();
+
+    /** Called on the message thread when the run is over, with the process exit code */
+    std::function<void(int)> onFinished;
+
+private:
+    enum EditKind
+    {
+        addPlugin = 0,
+        removePlugin,
+        movePlugin,
+        bypassPlugin,
+        numAudibleEditKinds,
+        openEditor = numAudibleEditKinds,
+        closeEditor,
+        numEditKinds
+    };
+
+    class ScanThread;
+    class Watchdog;
+
+    void timerCallback() override;
+    void tapAboutToStart(double sampleRate, int numInputChannels, int numOutputChannels) override;
+    void tapInput(const float* const* data, int numChannels, int numSamples) noexcept override;
+    void tapOutput(const float* const* data, int numChannels, int numSamples) noexcept override;
+
+    void makeRandomEdit();
+    void rebuildChain();
+    void publishEdit(EditKind kind, juce::int64 startTicks);
+    void collectAudibleEdit();
+    juce::AudioProcessorGraph::Node* getRandomPluginNode();
+    void finish();
+
+    const juce::File testPluginDirectory;
+    const double secondsToRun;
+    juce::Random random;
+
+    juce::AudioDeviceManager deviceManager;
+    juce::AudioPluginFormatManager formatManager;
+    juce::AudioProcessorPlayer player;
+    juce::AudioProcessorGraph graph;
+    LinearChainProcessor linearChain;
+    HostAudioCallback hostCallback;
+
+    juce::Array<juce::PluginDescription> testPlugins;
+    juce::KnownPluginList scannedPlugins;
+    std::unique_ptr<SafePluginScanner> scanner;
+    std::unique_ptr<ScanThread> scanThread;
+    std::unique_ptr<Watchdog> watchdog;
+
+    std::vector<ChainEntry> entries;
+    bool editorsEnabled = false;
+    bool isEditing = false;
+    bool finished = false;
+    juce::int64 startTicks = 0;
+
+    // Edit bookkeeping - the message thread publishes, the audio thread reports when it rendered it
+    std::atomic<int> publishedEdit { 0 };
+    std::atomic<int> audibleEdit { 0 };
+    std::atomic<juce::int64> audibleTicks { 0 };
+    int renderingEdit = 0;
+    bool renderingNewEdit = false;
+    int collectedEdit = 0;
+    EditKind pendingKind = addPlugin;
+    juce::int64 pendingStartTicks = 0;
+
+    // Audio thread health
+    juce::int64 blockStartTicks = 0;
+    juce::int64 blockDeadlineTicks = 0;
+    std::atomic<juce::int64> numBlocks { 0 };
+    std::atomic<juce::int64> numLateBlocks { 0 };
+    std::atomic<juce::int64> numNonFiniteBlocks { 0 };
+
+    std::atomic<juce::int64> messageHeartbeat { 0 };
+    std::vector<double> editMillis[numEditKinds];
+    int numLoadErrors = 0;
+    juce::int64 baselineRssKb = -1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StressHarness)
+};
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "ProfiledMutex.h"
 #include <vector>
 #include <queue>
 #include <thread>
@@ -47,7 +48,7 @@ public:
                     
                     // Wait for and get a task from the queue
                     {
-                        std::unique_lock<std::mutex> lock(queueMutex);
+                        std::unique_lock<ProfiledMutex> lock(queueMutex);
                         
                         // Wait until there's a task or we're shutting down
                         taskAvailable.wait(lock, [this] {
@@ -89,7 +90,7 @@ public:
     {
         // Signal all threads to stop
         {
-            std::unique_lock<std::mutex> lock(queueMutex);
+            std::unique_lock<ProfiledMutex> lock(queueMutex);
             running = false;
         }
         
@@ -126,7 +127,7 @@ public:
         
         // Add the task to the queue
         {
-            std::unique_lock<std::mutex> lock(queueMutex);
+            std::unique_lock<ProfiledMutex> lock(queueMutex);
             
             // Don't allow adding tasks after stopping the pool
             if (!running)
@@ -193,9 +194,9 @@ private:
     // Task queue
     std::queue<std::function<void()>> tasks;
     
-    // Synchronization
-    std::mutex queueMutex;
-    std::condition_variable taskAvailable;
+    // Synchronization - condition_variable_any, because the queue lock is profiled
+    ProfiledMutex queueMutex { "ThreadPool queue" };
+    std::condition_variable_any taskAvailable;
     bool running;
     
     // Prevent copying
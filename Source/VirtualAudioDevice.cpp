@@ -0,0 +1,232 @@
+//
+// VirtualAudioDevice.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "VirtualAudioDevice.h"
+
+namespace
+{
+    const int numVirtualChannels = 8;
+
+    // Skewed variants for exercising drift compensation against a mismatched clock
+    struct VirtualDeviceVariant
+    {
+        const char* name;
+        double skewPpm;
+        bool freewheel;
+    };
+
+    const VirtualDeviceVariant variants[] =
+    {
+        { VirtualAudioIODeviceType::defaultDeviceName,   0.0,    false },
+        { "Virtual Device (+100 ppm)",                   100.0,  false },
+        { "Virtual Device (-100 ppm)",                   -100.0, false },
+        { VirtualAudioIODeviceType::freewheelDeviceName, 0.0,    true }
+    };
+}
+
+//==============================================================================
+VirtualAudioIODevice::VirtualAudioIODevice(const juce::String& deviceName, int numInputChannels, int numOutputChannels,
+                                           double skewPpm, bool freewheel)
+    : juce::AudioIODevice(deviceName, VirtualAudioIODeviceType::typeName),
+      juce::Thread("Nova Host Virtual Device"),
+      numInputs(numInputChannels),
+      numOutputs(numOutputChannels),
+      clockSkewPpm(skewPpm),
+      freewheeling(freewheel)
+{
+}
+
+VirtualAudioIODevice::~VirtualAudioIODevice()
+{
+    close();
+}
+
+juce::StringArray VirtualAudioIODevice::getOutputChannelNames()
+{
+    juce::StringArray names;
+    for (int i = 1; i <= numOutputs; ++i)
+        names.add("Output " + juce::String(i));
+    return names;
+}
+
+juce::StringArray VirtualAudioIODevice::getInputChannelNames()
+{
+    juce::StringArray names;
+    for (int i = 1; i <= numInputs; ++i)
+        names.add("Input " + juce::String(i));
+    return names;
+}
+
+juce::Array<double> VirtualAudioIODevice::getAvailableSampleRates()
+{
+    return { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+}
+
+juce::Array<int> VirtualAudioIODevice::getAvailableBufferSizes()
+{
+    return { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+}
+
+juce::String VirtualAudioIODevice::open(const juce::BigInteger& inputChannels, const juce::BigInteger& outputChannels,
+                                        double newSampleRate, int newBufferSize)
+{
+    close();
+
+    activeInputs = inputChannels;
+    activeInputs.setRange(numInputs, juce::jmax(0, activeInputs.getHighestBit() + 1 - numInputs), false);
+    activeOutputs = outputChannels;
+    activeOutputs.setRange(numOutputs, juce::jmax(0, activeOutputs.getHighestBit() + 1 - numOutputs), false);
+
+    sampleRate = newSampleRate > 0.0 ? newSampleRate : 48000.0;
+    bufferSize = newBufferSize > 0 ? newBufferSize : getDefaultBufferSize();
+
+    inputBuffer.setSize(juce::jmax(1, activeInputs.countNumberOfSetBits()), bufferSize);
+    outputBuffer.setSize(juce::jmax(1, activeOutputs.countNumberOfSetBits()), bufferSize);
+    testTonePhase = 0.0;
+    opened = true;
+    return {};
+}
+
+void VirtualAudioIODevice::close()
+{
+    stop();
+    opened = false;
+}
+
+void VirtualAudioIODevice::start(juce::AudioIODeviceCallback* callback)
+{
+    if (! opened || callback == nullptr)
+        return;
+
+    stop();
+    callback->audioDeviceAboutToStart(this);
+
+    {
+        const juce::ScopedLock sl(callbackLock);
+        currentCallback = callback;
+    }
+
+    numCallbacks.store(0);
+    startThread(juce::Thread::Priority::highest);
+}
+
+void VirtualAudioIODevice::stop()
+{
+    signalThreadShouldExit();
+    waitForThreadToExit(-1);
+
+    juce::AudioIODeviceCallback* oldCallback = nullptr;
+    {
+        const juce::ScopedLock sl(callbackLock);
+        std::swap(oldCallback, currentCallback);
+    }
+
+    if (oldCallback != nullptr)
+        oldCallback->audioDeviceStopped();
+}
+
+void VirtualAudioIODevice::generateInput(int numSamples) noexcept
+{
+    // A quiet 440 Hz tone makes it obvious whether audio is flowing through the chain
+    const double phaseIncrement = juce::MathConstants<double>::twoPi * 440.0 / sampleRate;
+    float* first = inputBuffer.getWritePointer(0);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        first[i] = 0.1f * (float) std::sin(testTonePhase);
+        testTonePhase += phaseIncrement;
+    }
+
+    testTonePhase = std::fmod(testTonePhase, juce::MathConstants<double>::twoPi);
+
+    for (int ch = 1; ch < inputBuffer.getNumChannels(); ++ch)
+        inputBuffer.copyFrom(ch, 0, first, numSamples);
+}
+
+void VirtualAudioIODevice::run()
+{
+    // A positive skew means this device's clock runs fast, so its periods are shorter
+    const double periodMs = 1000.0 * bufferSize / (sampleRate * (1.0 + clockSkewPpm * 1.0e-6));
+    double nextCallbackTime = juce::Time::getMillisecondCounterHiRes();
+
+    const int numActiveInputs = activeInputs.countNumberOfSetBits();
+    const int numActiveOutputs = activeOutputs.countNumberOfSetBits();
+
+    while (! threadShouldExit())
+    {
+        generateInput(bufferSize);
+
+        {
+            const juce::ScopedLock sl(callbackLock);
+
+            if (currentCallback != nullptr)
+                currentCallback->audioDeviceIOCallbackWithContext(inputBuffer.getArrayOfReadPointers(), numActiveInputs,
+                                                                  outputBuffer.getArrayOfWritePointers(), numActiveOutputs,
+                                                                  bufferSize, {});
+        }
+
+        numCallbacks++;
+
+        if (freewheeling.load())
+        {
+            nextCallbackTime = juce::Time::getMillisecondCounterHiRes();
+            continue;
+        }
+
+        nextCallbackTime += periodMs;
+        const double now = juce::Time::getMillisecondCounterHiRes();
+
+        // If we fell far behind (debugger, suspend), resynchronise instead of bursting
+        if (now - nextCallbackTime > 10.0 * periodMs)
+            nextCallbackTime = now;
+
+        // Sleep for the bulk of the wait, then spin briefly for accuracy
+        while (! threadShouldExit())
+        {
+            const double remaining = nextCallbackTime - juce::Time::getMillisecondCounterHiRes();
+            if (remaining <= 0.0)
+                break;
+
+            if (remaining > 2.0)
+                wait((int) (remaining - 1.0));
+            else
+                juce::Thread::yield();
+        }
+    }
+}
+
+//==============================================================================
+VirtualAudioIODeviceType::VirtualAudioIODeviceType()
+    : juce::AudioIODeviceType(typeName)
+{
+}
+
+juce::StringArray VirtualAudioIODeviceType::getDeviceNames(bool) const
+{
+    juce::StringArray names;
+    for (const auto& variant : variants)
+        names.add(variant.name);
+    return names;
+}
+
+int VirtualAudioIODeviceType::getIndexOfDevice(juce::AudioIODevice* device, bool) const
+{
+    return device != nullptr ? getDeviceNames().indexOf(device->getName()) : -1;
+}
+
+juce::AudioIODevice* VirtualAudioIODeviceType::createDevice(const juce::String& outputDeviceName,
+                                                            const juce::String& inputDeviceName)
+{
+    const juce::String name = outputDeviceName.isNotEmpty() ? outputDeviceName : inputDeviceName;
+
+    for (const auto& variant : variants)
+        if (name == variant.name)
+            return new VirtualAudioIODevice(name, numVirtualChannels, numVirtualChannels,
+                                            variant.skewPpm, variant.freewheel);
+
+    return nullptr;
+}
@@ -0,0 +1,104 @@
+//
+// VirtualAudioDevice.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+
+/**
+ * A software audio device driven by its own high-priority thread
+ * Useful when no hardware is available, for testing with deliberately skewed clocks
+ * and, in freewheel mode, for running the chain as fast as the CPU allows
+ */
+class VirtualAudioIODevice : public juce::AudioIODevice,
+                             private juce::Thread
+{
+public:
+    /**
+     * @param clockSkewPpm  How far this device's clock runs from nominal, in parts per million
+     * @param freewheel     If true, callbacks run back to back instead of in real time
+     */
+    VirtualAudioIODevice(const juce::String& deviceName, int numInputChannels, int numOutputChannels,
+                         double clockSkewPpm, bool freewheel);
+    ~VirtualAudioIODevice() override;
+
+    juce::StringArray getOutputChannelNames() override;
+    juce::StringArray getInputChannelNames() override;
+    juce::Array<double> getAvailableSampleRates() override;
+    juce::Array<int> getAvailableBufferSizes() override;
+    int getDefaultBufferSize() override                   { return 256; }
+
+    juce::String open(const juce::BigInteger& inputChannels, const juce::BigInteger& outputChannels,
+                      double sampleRate, int bufferSizeSamples) override;
+    void close() override;
+    bool isOpen() override                                { return opened; }
+
+    void start(juce::AudioIODeviceCallback* callback) override;
+    void stop() override;
+    bool isPlaying() override                             { return currentCallback != nullptr; }
+
+    juce::String getLastError() override                  { return {}; }
+    int getCurrentBufferSizeSamples() override            { return bufferSize; }
+    double getCurrentSampleRate() override                { return sampleRate; }
+    int getCurrentBitDepth() override                     { return 32; }
+    juce::BigInteger getActiveOutputChannels() const override { return activeOutputs; }
+    juce::BigInteger getActiveInputChannels() const override  { return activeInputs; }
+    int getOutputLatencyInSamples() override              { return 0; }
+    int getInputLatencyInSamples() override               { return 0; }
+
+    /** Switches between real-time pacing and back-to-back callbacks while running */
+    void setFreewheel(bool shouldFreewheel) noexcept      { freewheeling.store(shouldFreewheel); }
+
+    /** Number of callbacks made since the device was started */
+    juce::int64 getNumCallbacks() const noexcept          { return numCallbacks.load(); }
+
+private:
+    void run() override;
+    void generateInput(int numSamples) noexcept;
+
+    const int numInputs, numOutputs;
+    const double clockSkewPpm;
+    std::atomic<bool> freewheeling;
+
+    bool opened = false;
+    double sampleRate = 48000.0;
+    int bufferSize = 256;
+    juce::BigInteger activeInputs, activeOutputs;
+    juce::AudioBuffer<float> inputBuffer, outputBuffer;
+    double testTonePhase = 0.0;
+    std::atomic<juce::int64> numCallbacks { 0 };
+
+    juce::CriticalSection callbackLock;
+    juce::AudioIODeviceCallback* currentCallback = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VirtualAudioIODevice)
+};
+
+/**
+ * Lists the virtual devices in the audio settings, including variants with skewed clocks
+ */
+class VirtualAudioIODeviceType : public juce::AudioIODeviceType
+{
+public:
+    static constexpr const char* typeName = "Nova Host Virtual";
+    static constexpr const char* defaultDeviceName = "Virtual Device";
+    static constexpr const char* freewheelDeviceName = "Virtual Device (Freewheel)";
+
+    VirtualAudioIODeviceType();
+
+    void scanForDevices() override {}
+    juce::StringArray getDeviceNames(bool wantInputNames = false) const override;
+    int getDefaultDeviceIndex(bool forInput) const override  { return 0; }
+    int getIndexOfDevice(juce::AudioIODevice* device, bool asInput) const override;
+    bool hasSeparateInputsAndOutputs() const override       { return false; }
+    juce::AudioIODevice* createDevice(const juce::String& outputDeviceName,
+                                      const juce::String& inputDeviceName) override;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VirtualAudioIODeviceType)
+};
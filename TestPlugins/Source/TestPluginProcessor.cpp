@@ -0,0 +1,223 @@
+//
+// TestPluginProcessor.cpp
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#include "TestPluginProcessor.h"
+#include <limits>
+
+namespace
+{
+    // Longest delay the latency plugins can be asked for
+    const int maxLatencySamples = 9600;
+
+    // How long the latency changer holds each latency when cycling
+    const double latencyCycleSeconds = 2.0;
+}
+
+TestPluginProcessor::TestPluginProcessor()
+    : juce::AudioProcessor(BusesProperties()
+                               .withInput("Input", juce::AudioChannelSet::stereo(), true)
+                               .withOutput("Output", juce::AudioChannelSet::stereo(), true))
+{
+   #if NOVA_TEST_PLUGIN_KIND == NOVA_TEST_PLUGIN_CPU_BURNER
+    addParameter(cpuLoad = new juce::AudioParameterFloat("load", "Load (% of block)", 0.0f, 100.0f, 25.0f));
+   #elif NOVA_TEST_PLUGIN_KIND == NOVA_TEST_PLUGIN_FIXED_LATENCY
+    setLatencySamples(NOVA_TEST_PLUGIN_FIXED_LATENCY_SAMPLES);
+   #elif NOVA_TEST_PLUGIN_KIND == NOVA_TEST_PLUGIN_LATENCY_CHANGE
+    addParameter(latency = new juce::AudioParameterInt("latency", "Latency (samples)", 0, maxLatencySamples, 256));
+    addParameter(cycleLatency = new juce::AudioParameterBool("cycle", "Cycle latency", true));
+   #elif NOVA_TEST_PLUGIN_KIND == NOVA_TEST_PLUGIN_BAD_NUMBERS
+    addParameter(badNumberKind = new juce::AudioParameterChoice("kind", "Output",
+                                                                { "Denormals", "NaN", "Infinity" }, 0));
+   #elif NOVA_TEST_PLUGIN_KIND == NOVA_TEST_PLUGIN_SLOW_LOADER
+    juce::Thread::sleep(NOVA_TEST_PLUGIN_SLOW_LOAD_MS);
+   #endif
+
+    misbehave(0);
+}
+
+TestPluginProcessor::~TestPluginProcessor()
+{
+}
+
+bool TestPluginProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+    const auto& output = layouts.getMainOutputChannelSet();
+    return (output == juce::AudioChannelSet::mono() || output == juce::AudioChannelSet::stereo())
+        && layouts.getMainInputChannelSet() == output;
+}
+
+void TestPluginProcessor::prepareToPlay(double sampleRate, int maximumExpectedSamplesPerBlock)
+{
+    currentSampleRate = sampleRate;
+    samplesProcessed = 0;
+    reportedLatency = -1;
+
+   #if NOVA_TEST_PLUGIN_KIND == NOVA_TEST_PLUGIN_FIXED_LATENCY || NOVA_TEST_PLUGIN_KIND == NOVA_TEST_PLUGIN_LATENCY_CHANGE
+    delayLine.setSize(getTotalNumOutputChannels(), maxLatencySamples + maximumExpectedSamplesPerBlock + 1);
+    delayLine.clear();
+    delayWritePosition = 0;
+   #else
+    juce::ignoreUnused(maximumExpectedSamplesPerBlock);
+   #endif
+
+    misbehave(1);
+}
+
+void TestPluginProcessor::releaseResources()
+{
+    delayLine.setSize(0, 0);
+}
+
+void TestPluginProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+{
+    if (! hasProcessed)
+    {
+        hasProcessed = true;
+        misbehave(2);
+    }
+
+    const int numSamples = buffer.getNumSamples();
+
+   #if NOVA_TEST_PLUGIN_KIND == NOVA_TEST_PLUGIN_CPU_BURNER
+    burnCpu(numSamples);
+   #elif NOVA_TEST_PLUGIN_KIND == NOVA_TEST_PLUGIN_FIXED_LATENCY
+    delayBlock(buffer, NOVA_TEST_PLUGIN_FIXED_LATENCY_SAMPLES);
+   #elif NOVA_TEST_PLUGIN_KIND == NOVA_TEST_PLUGIN_LATENCY_CHANGE
+    // Alternate between the configured latency and none so hosts see repeated changes
+    const bool inOffPhase = cycleLatency->get()
+                         && ((juce::int64) (samplesProcessed / (currentSampleRate * latencyCycleSeconds)) % 2) == 1;
+    const int targetLatency = inOffPhase ? 0 : latency->get();
+
+    if (targetLatency != reportedLatency)
+    {
+        setLatencySamples(targetLatency);
+        reportedLatency = targetLatency;
+    }
+
+    delayBlock(buffer, targetLatency);
+   #elif NOVA_TEST_PLUGIN_KIND == NOVA_TEST_PLUGIN_BAD_NUMBERS
+    injectBadNumbers(buffer);
+   #endif
+
+    samplesProcessed += numSamples;
+}
+
+void TestPluginProcessor::delayBlock(juce::AudioBuffer<float>& buffer, int delaySamples) noexcept
+{
+    const int length = delayLine.getNumSamples();
+    const int numChannels = juce::jmin(buffer.getNumChannels(), delayLine.getNumChannels());
+
+    if (length == 0)
+        return;
+
+    int writePosition = delayWritePosition;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        float* line = delayLine.getWritePointer(ch);
+        float* data = buffer.getWritePointer(ch);
+        writePosition = delayWritePosition;
+
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            line[writePosition] = data[i];
+            data[i] = line[(writePosition - delaySamples + length) % length];
+            writePosition = (writePosition + 1) % length;
+        }
+    }
+
+    delayWritePosition = writePosition;
+}
+
+void TestPluginProcessor::burnCpu(int numSamples) noexcept
+{
+    // Spin for a fixed share of the block's real-time budget, so the load is the same on any machine
+    const double seconds = numSamples / currentSampleRate * cpuLoad->get() / 100.0;
+    const juce::int64 end = juce::Time::getHighResolutionTicks() + juce::Time::secondsToHighResolutionTicks(seconds);
+
+    volatile double sink = 0.0;
+    while (juce::Time::getHighResolutionTicks() < end)
+        sink = sink + 1.0;
+}
+
+void TestPluginProcessor::injectBadNumbers(juce::AudioBuffer<float>& buffer) noexcept
+{
+    switch (badNumberKind->getIndex())
+    {
+        case 0:
+            // A whole block of denormals, like a filter or reverb tail decaying towards zero
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    buffer.setSample(ch, i, std::numeric_limits<float>::denorm_min() * (float) (1 + i % 7));
+            break;
+
+        case 1:
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                buffer.setSample(ch, 0, std::numeric_limits<float>::quiet_NaN());
+            break;
+
+        default:
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                buffer.setSample(ch, 0, std::numeric_limits<float>::infinity());
+            break;
+    }
+}
+
+void TestPluginProcessor::misbehave(int stage)
+{
+   #if NOVA_TEST_PLUGIN_KIND == NOVA_TEST_PLUGIN_CRASHER
+    if (stage == NOVA_TEST_PLUGIN_FAULT_STAGE)
+        *static_cast<volatile int*>(nullptr) = 0;
+   #elif NOVA_TEST_PLUGIN_KIND == NOVA_TEST_PLUGIN_HANGER
+    if (stage == NOVA_TEST_PLUGIN_FAULT_STAGE)
+        for (;;)
+            juce::Thread::sleep(1000);
+   #else
+    juce::ignoreUnused(stage);
+   #endif
+}
+
+//==============================================================================
+void TestPluginProcessor::getStateInformation(juce::MemoryBlock& destData)
+{
+   #if NOVA_TEST_PLUGIN_KIND == NOVA_TEST_PLUGIN_HUGE_STATE
+    // Deterministic noise does not compress, so hosts really have to move all of it
+    destData.setSize((size_t) NOVA_TEST_PLUGIN_STATE_MB << 20);
+    juce::Random random(0x5eed);
+    auto* words = static_cast<juce::uint32*>(destData.getData());
+    for (size_t i = 0; i < destData.getSize() / sizeof(juce::uint32); ++i)
+        words[i] = (juce::uint32) random.nextInt();
+   #else
+    juce::XmlElement state("NovaTestPlugin");
+    for (auto* parameter : getParameters())
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            state.setAttribute(ranged->getParameterID(), ranged->getValue());
+
+    copyXmlToBinary(state, destData);
+   #endif
+}
+
+void TestPluginProcessor::setStateInformation(const void* data, int sizeInBytes)
+{
+   #if NOVA_TEST_PLUGIN_KIND == NOVA_TEST_PLUGIN_HUGE_STATE
+    // A truncated or altered state means the host mangled it
+    jassert(sizeInBytes == (NOVA_TEST_PLUGIN_STATE_MB << 20));
+    juce::ignoreUnused(data, sizeInBytes);
+   #else
+    if (auto state = getXmlFromBinary(data, sizeInBytes))
+        for (auto* parameter : getParameters())
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+                if (state->hasAttribute(ranged->getParameterID()))
+                    ranged->setValueNotifyingHost((float) state->getDoubleAttribute(ranged->getParameterID()));
+   #endif
+}
+
+//==============================================================================
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new TestPluginProcessor();
+}
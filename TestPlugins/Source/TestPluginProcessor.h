@@ -0,0 +1,101 @@
+//
+// TestPluginProcessor.h
+// Nova Host
+//
+// Created for NovaHost October 18, 2026
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+
+// Every reference plugin is built from this one source; the kind is chosen at compile time
+// (see Utilities/build_test_plugins.sh, which also gives each kind its own name and plugin code)
+#define NOVA_TEST_PLUGIN_UNITY          1
+#define NOVA_TEST_PLUGIN_CPU_BURNER     2
+#define NOVA_TEST_PLUGIN_FIXED_LATENCY  3
+#define NOVA_TEST_PLUGIN_LATENCY_CHANGE 4
+#define NOVA_TEST_PLUGIN_BAD_NUMBERS    5
+#define NOVA_TEST_PLUGIN_SLOW_LOADER    6
+#define NOVA_TEST_PLUGIN_CRASHER        7
+#define NOVA_TEST_PLUGIN_HANGER         8
+#define NOVA_TEST_PLUGIN_HUGE_STATE     9
+
+#ifndef NOVA_TEST_PLUGIN_KIND
+ #define NOVA_TEST_PLUGIN_KIND NOVA_TEST_PLUGIN_UNITY
+#endif
+
+// Where the crasher and the hanger misbehave: 0 = on construction (i.e. during a scan),
+// 1 = in prepareToPlay, 2 = on the first processBlock
+#ifndef NOVA_TEST_PLUGIN_FAULT_STAGE
+ #define NOVA_TEST_PLUGIN_FAULT_STAGE 0
+#endif
+
+#ifndef NOVA_TEST_PLUGIN_SLOW_LOAD_MS
+ #define NOVA_TEST_PLUGIN_SLOW_LOAD_MS 5000
+#endif
+
+#ifndef NOVA_TEST_PLUGIN_FIXED_LATENCY_SAMPLES
+ #define NOVA_TEST_PLUGIN_FIXED_LATENCY_SAMPLES 480
+#endif
+
+#ifndef NOVA_TEST_PLUGIN_STATE_MB
+ #define NOVA_TEST_PLUGIN_STATE_MB 64
+#endif
+
+/**
+ * Small, predictable plugins for exercising the host without proprietary software:
+ * unity gain, a configurable CPU burner, a fixed-latency delay, a plugin that changes its
+ * latency while running, a NaN/denormal/infinity generator, a slow loader, a crasher,
+ * a hanger and a plugin with a very large state
+ */
+class TestPluginProcessor : public juce::AudioProcessor
+{
+public:
+    TestPluginProcessor();
+    ~TestPluginProcessor() override;
+
+    const juce::String getName() const override             { return JucePlugin_Name; }
+    void prepareToPlay(double sampleRate, int maximumExpectedSamplesPerBlock) override;
+    void releaseResources() override;
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override;
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
+
+    double getTailLengthSeconds() const override             { return 0.0; }
+    bool acceptsMidi() const override                        { return false; }
+    bool producesMidi() const override                       { return false; }
+
+    juce::AudioProcessorEditor* createEditor() override      { return new juce::GenericAudioProcessorEditor(*this); }
+    bool hasEditor() const override                          { return true; }
+
+    int getNumPrograms() override                            { return 1; }
+    int getCurrentProgram() override                         { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override          { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+
+    void getStateInformation(juce::MemoryBlock& destData) override;
+    void setStateInformation(const void* data, int sizeInBytes) override;
+
+private:
+    void delayBlock(juce::AudioBuffer<float>& buffer, int delaySamples) noexcept;
+    void burnCpu(int numSamples) noexcept;
+    void injectBadNumbers(juce::AudioBuffer<float>& buffer) noexcept;
+
+    static void misbehave(int stage);
+
+    juce::AudioParameterFloat* cpuLoad = nullptr;
+    juce::AudioParameterInt* latency = nullptr;
+    juce::AudioParameterBool* cycleLatency = nullptr;
+    juce::AudioParameterChoice* badNumberKind = nullptr;
+
+    double currentSampleRate = 44100.0;
+    juce::AudioBuffer<float> delayLine;
+    int delayWritePosition = 0;
+    int reportedLatency = -1;
+    juce::int64 samplesProcessed = 0;
+    bool hasProcessed = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TestPluginProcessor)
+};
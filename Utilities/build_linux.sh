@@ -24,10 +24,11 @@ check_dependency libxinerama-dev
 check_dependency libxrandr-dev
 check_dependency libfreetype6-dev
 check_dependency libcurl4-gnutls-dev
+check_dependency libjack-jackd2-dev
 
 if [ $MISSING_DEPS -ne 0 ]; then
     echo "Please install missing dependencies with:"
-    echo "sudo apt-get install libasound2-dev libx11-dev libxcomposite-dev libxcursor-dev libxinerama-dev libxrandr-dev libfreetype6-dev libcurl4-gnutls-dev"
+    echo "sudo apt-get install libasound2-dev libx11-dev libxcomposite-dev libxcursor-dev libxinerama-dev libxrandr-dev libfreetype6-dev libcurl4-gnutls-dev libjack-jackd2-dev"
     exit 1
 fi
 
@@ -50,15 +51,35 @@ fi
 
 echo "✅ JUCE library is available"
 
-# Check for build type
+# Check for build type and sanitizer
 BUILD_TYPE="Release"
-if [ "$1" == "debug" ]; then
-    BUILD_TYPE="Debug"
+SANITIZER=""
+for arg in "$@"; do
+    case "$arg" in
+        debug) BUILD_TYPE="Debug" ;;
+        tsan) SANITIZER="thread" ;;
+        asan) SANITIZER="address" ;;
+    esac
+done
+
+if [ "$BUILD_TYPE" == "Debug" ]; then
     echo "Building in Debug mode"
 else
     echo "Building in Release mode (use './build_linux.sh debug' for debug build)"
 fi
 
+# Sanitized builds go to their own folders so they never mix objects with normal builds
+MAKE_ARGS="CONFIG=$BUILD_TYPE"
+OUTPUT_DIR="build"
+if [ -n "$SANITIZER" ]; then
+    echo "Building with -fsanitize=$SANITIZER (run the stress test with -stress-test)"
+    OUTPUT_DIR="build/$SANITIZER-sanitizer"
+    export CFLAGS="$CFLAGS -fsanitize=$SANITIZER -fno-omit-frame-pointer -g"
+    export CXXFLAGS="$CXXFLAGS -fsanitize=$SANITIZER -fno-omit-frame-pointer -g"
+    export LDFLAGS="$LDFLAGS -fsanitize=$SANITIZER"
+    MAKE_ARGS="$MAKE_ARGS JUCE_OBJDIR=build/intermediate/$BUILD_TYPE-$SANITIZER JUCE_OUTDIR=$OUTPUT_DIR"
+fi
+
 # Create build directory
 echo "Creating build directory..."
 mkdir -p ../Builds/LinuxMakefile
@@ -72,11 +93,11 @@ fi
 # Build the project
 echo "Building NovaHost..."
 cd ../Builds/LinuxMakefile
-make CONFIG=$BUILD_TYPE
+make $MAKE_ARGS
 
 if [ $? -eq 0 ]; then
     echo "✅ Build successful!"
-    echo "You can find the executable in: Builds/LinuxMakefile/build/"
+    echo "You can find the executable in: Builds/LinuxMakefile/$OUTPUT_DIR/"
 else
     echo "❌ Build failed!"
     exit 1
@@ -86,6 +107,6 @@ fi
 read -p "Would you like to run NovaHost now? (y/n) " -n 1 -r
 echo
 if [[ $REPLY =~ ^[Yy]$ ]]; then
-    cd build
+    cd $OUTPUT_DIR
     ./NovaHost
 fi
\ No newline at end of file
@@ -0,0 +1,90 @@
+#!/bin/bash
+# NovaHost reference test plugin build script
+# Builds every test plugin kind as LV2 and VST3 into TestPlugins/build/<Name>
+# Usage: ./build_test_plugins.sh [debug]
+
+echo "NovaHost Test Plugin Build Script"
+echo "---------------------------------"
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+ROOT_DIR="$SCRIPT_DIR/.."
+PROJECT_DIR="$ROOT_DIR/TestPlugins"
+OUTPUT_DIR="$PROJECT_DIR/build"
+
+BUILD_TYPE="Release"
+if [ "$1" == "debug" ]; then
+    BUILD_TYPE="Debug"
+fi
+
+# Locate Projucer the same way the app build and CI do
+PROJUCER=""
+for candidate in "$ROOT_DIR/lib/juce/Projucer" "$ROOT_DIR/lib/juce/extras/Projucer/Builds/LinuxMakefile/build/Projucer"; do
+    if [ -x "$candidate" ]; then
+        PROJUCER="$candidate"
+        break
+    fi
+done
+
+if [ -z "$PROJUCER" ]; then
+    echo "❌ Projucer not found - build it from lib/juce/extras/Projucer first"
+    exit 1
+fi
+
+echo "Generating test plugin makefile..."
+"$PROJUCER" --resave "$PROJECT_DIR/NovaTestPlugins.jucer" || exit 1
+
+# kind  plugin code  name                       LV2 URI suffix
+KINDS=(
+    "1 Nt01 NovaTestUnity          unity"
+    "2 Nt02 NovaTestCpuBurner      cpu-burner"
+    "3 Nt03 NovaTestFixedLatency   fixed-latency"
+    "4 Nt04 NovaTestLatencyChange  latency-change"
+    "5 Nt05 NovaTestBadNumbers     bad-numbers"
+    "6 Nt06 NovaTestSlowLoader     slow-loader"
+    "7 Nt07 NovaTestCrasher        crasher"
+    "8 Nt08 NovaTestHanger         hanger"
+    "9 Nt09 NovaTestHugeState      huge-state"
+)
+
+FAILED=0
+mkdir -p "$OUTPUT_DIR"
+
+for entry in "${KINDS[@]}"; do
+    read -r KIND CODE NAME SLUG <<< "$entry"
+    echo "Building $NAME..."
+
+    # Four-character plugin codes are passed as their integer value, as Projucer writes them
+    CODE_INT=$(printf "0x%02x%02x%02x%02x" "'${CODE:0:1}" "'${CODE:1:1}" "'${CODE:2:1}" "'${CODE:3:1}")
+
+    DEFINES="-DNOVA_TEST_PLUGIN_KIND=$KIND"
+    DEFINES="$DEFINES -DJucePlugin_Name=\\\"$NAME\\\" -DJucePlugin_Desc=\\\"$NAME\\\""
+    DEFINES="$DEFINES -DJucePlugin_PluginCode=$CODE_INT"
+    DEFINES="$DEFINES -DJucePlugin_LV2URI=\\\"https://github.com/NovaHost/test-plugins/$SLUG\\\""
+
+    # Separate object and output folders per kind, since each is the same source built differently
+    (cd "$PROJECT_DIR/Builds/LinuxMakefile" && \
+        make CONFIG=$BUILD_TYPE -j"$(nproc)" \
+             CPPFLAGS="$DEFINES" \
+             JUCE_OBJDIR="build/obj-$NAME" \
+             JUCE_OUTDIR="build/$NAME" \
+             JUCE_TARGET_VST3="$NAME.vst3" \
+             JUCE_TARGET_LV2_PLUGIN="$NAME.lv2" \
+             JUCE_TARGET_SHARED_CODE="$NAME.a")
+
+    if [ $? -ne 0 ]; then
+        echo "❌ $NAME failed to build"
+        FAILED=1
+        continue
+    fi
+
+    rm -rf "$OUTPUT_DIR/$NAME"
+    cp -R "$PROJECT_DIR/Builds/LinuxMakefile/build/$NAME" "$OUTPUT_DIR/$NAME"
+done
+
+if [ $FAILED -ne 0 ]; then
+    echo "❌ Some test plugins failed to build"
+    exit 1
+fi
+
+echo "✅ Test plugins built in: TestPlugins/build/"
+echo "Point the plugin scanner or -benchmark modes at that folder to use them"